@@ -7,6 +7,15 @@ HEADERS += \
     graphnode.h \
     graphedge.h \
     graphproxy.h \
+    graphmodel.h \
+    graphspatialindex.h \
+    graphview.h \
+    graphloader.h \
+    graphpainter.h \
+    graphexporter.h \
+    graphcommands.h \
+    graphjournal.h \
+    commandline.h \
     algorithmnode.h \
     algorithmpath.h \
     abstractalgorithm.h \
@@ -14,7 +23,37 @@ HEADERS += \
     edgesalgorithm.h \
     edgepairalgorithm.h \
     simplepathsalgorithm.h \
-    primepathsalgorithm.h
+    primepathsalgorithm.h \
+    tracecoverage.h \
+    graphsnapshot.h \
+    pathnumbering.h \
+    requirementautomaton.h \
+    setcover.h \
+    dataflowalgorithm.h \
+    alldefsalgorithm.h \
+    allusesalgorithm.h \
+    alldupathsalgorithm.h \
+    strongcomponents.h \
+    requirementcounter.h \
+    resourcebudget.h \
+    pathstore.h \
+    pathcodec.h \
+    chainreduction.h \
+    componentpaths.h \
+    dominatortree.h \
+    functionsummaries.h \
+    pathconstraints.h \
+    constraintproduct.h \
+    subsequenceautomaton.h \
+    costdistances.h \
+    requirementtouring.h \
+    suiteoptimizer.h \
+    portfolio.h \
+    shortesttestpaths.h \
+    basispathsalgorithm.h \
+    simplecycles.h \
+    simpleroundtripalgorithm.h \
+    completeroundtripalgorithm.h
 
 SOURCES += \
     mainwindow.cpp \
@@ -25,6 +64,15 @@ SOURCES += \
     graphnode.cpp \
     graphedge.cpp \
     graphproxy.cpp \
+    graphmodel.cpp \
+    graphspatialindex.cpp \
+    graphview.cpp \
+    graphloader.cpp \
+    graphpainter.cpp \
+    graphexporter.cpp \
+    graphcommands.cpp \
+    graphjournal.cpp \
+    commandline.cpp \
     algorithmnode.cpp \
     algorithmpath.cpp \
     abstractalgorithm.cpp \
@@ -32,10 +80,41 @@ SOURCES += \
     edgesalgorithm.cpp \
     edgepairalgorithm.cpp \
     simplepathsalgorithm.cpp \
-    primepathsalgorithm.cpp
+    primepathsalgorithm.cpp \
+    tracecoverage.cpp \
+    graphsnapshot.cpp \
+    pathnumbering.cpp \
+    requirementautomaton.cpp \
+    setcover.cpp \
+    dataflowalgorithm.cpp \
+    alldefsalgorithm.cpp \
+    allusesalgorithm.cpp \
+    alldupathsalgorithm.cpp \
+    strongcomponents.cpp \
+    requirementcounter.cpp \
+    pathstore.cpp \
+    pathcodec.cpp \
+    chainreduction.cpp \
+    componentpaths.cpp \
+    dominatortree.cpp \
+    functionsummaries.cpp \
+    pathconstraints.cpp \
+    constraintproduct.cpp \
+    subsequenceautomaton.cpp \
+    costdistances.cpp \
+    requirementtouring.cpp \
+    suiteoptimizer.cpp \
+    portfolio.cpp \
+    shortesttestpaths.cpp \
+    basispathsalgorithm.cpp \
+    simplecycles.cpp \
+    simpleroundtripalgorithm.cpp \
+    completeroundtripalgorithm.cpp
 
 FORMS += \
     mainwindow.ui
 
+LIBS += -lz
+
 RESOURCES += \
     QCoverage.qrc
@@ -1,9 +1,50 @@
 #include "abstractalgorithm.h"
 
 #include <QDebug>
+#include <QHash>
+#include <QPair>
+#include <QMutableListIterator>
+#include <QtAlgorithms>
+
+#include "requirementtouring.h"
+#include "setcover.h"
+#include "graphsnapshot.h"
+#include "constraintproduct.h"
+#include "costdistances.h"
+#include "suiteoptimizer.h"
+#include "shortesttestpaths.h"
+
+// rough heap size of a Path besides its node list
+#define PATH_OVERHEAD_BYTES 256
 
 using namespace Algorithm;
 
+QString Algorithm::objectiveText(Objective objective)
+{
+	if(objective == LowestCost)
+		return "cost";
+
+	return "fewest";
+}
+
+Objective Algorithm::objectiveFromText(const QString &text, bool *ok)
+{
+	if(ok != 0)
+		*ok = text == "cost" || text == "fewest";
+
+	return text == "cost" ? LowestCost : FewestPaths;
+}
+
+double AbstractAlgorithm::suiteCost() const
+{
+	double cost = 0;
+
+	foreach(Path *path, m_covResults)
+		cost += path->cost();
+
+	return cost;
+}
+
 const QList<Path*> &AbstractAlgorithm::coverageResults() const
 {
 	return m_covResults;
@@ -29,11 +70,40 @@ void AbstractAlgorithm::clearResults()
 	}
 
 	m_reqResults.clear();
+	m_infeasibleResults.clear();
+	m_constraintsIgnored = false;
+
+	m_coverageLowerBound = 0;
+	m_truncation = ResourceBudget::NoLimit;
+	m_estimatedBytes = 0;
+	m_budgetChecks = 0;
 }
 
 AbstractAlgorithm::~AbstractAlgorithm()
 {
 	clearResults();
+	delete m_ownDominance;
+}
+
+void AbstractAlgorithm::setDominance(const Dominance *dominance, int graphVersion)
+{
+	delete m_ownDominance;
+	m_ownDominance = 0;
+
+	m_dominance = dominance;
+	m_dominanceVersion = graphVersion;
+}
+
+const Dominance *AbstractAlgorithm::dominance()
+{
+	if(m_dominance == 0)
+	{
+		m_ownDominance = new Dominance(m_nodes);
+		m_dominance = m_ownDominance;
+		m_dominanceVersion = m_graphVersion;
+	}
+
+	return m_dominance;
 }
 
 void AbstractAlgorithm::addCovResult(Path *path)
@@ -44,22 +114,245 @@ void AbstractAlgorithm::addCovResult(Path *path)
 void AbstractAlgorithm::addReqResult(Path *path)
 {
 	m_reqResults.append(path);
+	m_estimatedBytes += sizeof(Path) + PATH_OVERHEAD_BYTES + path->nodeCount() * sizeof(Node*);
+}
+
+void AbstractAlgorithm::truncate(ResourceBudget::Limit limit)
+{
+	if(m_truncation != ResourceBudget::NoLimit)
+		return;
+
+	m_truncation = limit;
+
+#ifdef DEBUG
+	qWarning() << "truncate: stopped by" << ResourceBudget::limitText(limit);
+#endif
+}
+
+bool AbstractAlgorithm::isOutOfTime()
+{
+	if(m_cancel != 0 && *m_cancel != 0)
+		truncate(ResourceBudget::TimeLimit);
+
+	// the clock is only read once in a while
+	if(m_budget.timeLimit > 0 && (++m_budgetChecks & 0x3FF) == 0 && m_timer.elapsed() > m_budget.timeLimit)
+		truncate(ResourceBudget::TimeLimit);
+
+	return m_truncation == ResourceBudget::TimeLimit;
+}
+
+bool AbstractAlgorithm::isPastDeadline()
+{
+	if(m_budget.timeLimit > 0 && m_timer.elapsed() > m_budget.timeLimit)
+		truncate(ResourceBudget::TimeLimit);
+
+	return isOutOfTime();
+}
+
+bool AbstractAlgorithm::isOverSizeBudget()
+{
+	if(m_budget.maxRequirements > 0 && m_reqResults.size() >= m_budget.maxRequirements)
+	{
+		truncate(ResourceBudget::RequirementLimit);
+		return true;
+	}
+
+	if(m_budget.maxBytes > 0 && m_estimatedBytes >= m_budget.maxBytes)
+	{
+		truncate(ResourceBudget::MemoryLimit);
+		return true;
+	}
+
+	return false;
+}
+
+bool AbstractAlgorithm::isOverBudget()
+{
+	if(m_truncation != ResourceBudget::NoLimit)
+		return true;
+
+	if(!isOverSizeBudget())
+		isOutOfTime();
+
+	return m_truncation != ResourceBudget::NoLimit;
 }
 
 void AbstractAlgorithm::compute(const QList<Node*> &nodes, bool doComputeCoverage)
+{
+	beginRun(nodes);
+	onCompute();
+
+	/* the data flow criteria have no requirements without annotated nodes;
+	   after the time ran out the requirements found are kept, test paths
+	   for them would only run further past the deadline */
+	if(doComputeCoverage && !m_reqResults.isEmpty() && m_truncation != ResourceBudget::TimeLimit)
+	{
+		// the shortest paths know nothing of the constraints, nor does the optimizer
+		if(!m_constraints.isEmpty())
+			computeConstrainedCoverage();
+		else if(m_onePathPerRequirement)
+			computeShortestPaths();
+		else
+			computeCoverage();
+
+		if(m_optimizationTime > 0 && m_constraints.isEmpty() && !m_onePathPerRequirement
+		   && m_truncation != ResourceBudget::TimeLimit)
+			optimizeCoverage();
+	}
+}
+
+void AbstractAlgorithm::beginRun(const QList<Node*> &nodes)
 {
 	clearResults();
-	m_nodes.clear();
-	m_nodes.append(nodes);
 
-	onCompute();
+	// nodes of another or an unknown version may sit at the same addresses
+	if(m_graphVersion == NoGraphVersion || m_dominanceVersion != m_graphVersion)
+	{
+		delete m_ownDominance;
+		m_ownDominance = 0;
+		m_dominance = 0;
+	}
 
-	if(doComputeCoverage)
-		computeCoverage();
+	m_nodes = nodes;
+	m_timer.start();
+}
+
+namespace
+{
+	QVector<int> nodeIds(const Path *path)
+	{
+		QVector<int> ids;
+
+		foreach(Node *node, path->nodes())
+			ids.append(node->id());
+
+		return ids;
+	}
+
+	// the path merging with the one built which saves the most cost, -1 when none overlaps
+	int cheapestOverlap(const QList<Path*> &paths, const Path *currentPath)
+	{
+		int best = -1;
+		int bestOverlap = 0;
+		double bestSaved = 0;
+		double currentCost = currentPath->cost();
+
+		for(int i = 0; i < paths.size(); ++i)
+		{
+			Path *path = paths.at(i);
+			int overlap = path->intersects(currentPath);
+
+			if(overlap == 0)
+				continue;
+
+			Path *merged = currentPath->mergedWith(path);
+
+			if(merged == 0)
+				continue;
+
+			double saved = currentCost + path->cost() - merged->cost();
+			delete merged;
+
+			// as without costs, an open path is chosen over one which ends
+			bool better = best == -1 || saved > bestSaved
+				      || (saved == bestSaved && overlap > bestOverlap)
+				      || (saved == bestSaved && overlap == bestOverlap && paths.at(best)->isBorderPath());
+
+			if(better)
+			{
+				best = i;
+				bestOverlap = overlap;
+				bestSaved = saved;
+			}
+		}
+
+		return best;
+	}
+
+	// the path joined to the one built by the cheapest edge, -1 when none links to it
+	int cheapestLink(const QList<Path*> &paths, Path *currentPath, bool &append)
+	{
+		int best = -1;
+		double bestCost = 0;
+
+		for(int pass = 0; pass < 2; ++pass)
+		{
+			for(int i = 0; i < paths.size(); ++i)
+			{
+				Path *path = paths.at(i);
+
+				double cost = pass == 0 ? currentPath->lastNode()->costToNode(path->firstNode())
+							: path->lastNode()->costToNode(currentPath->firstNode());
+
+				if(cost < 0)
+					continue;
+
+				// the longer one of equally cheap links
+				if(best == -1 || cost < bestCost
+				   || (cost == bestCost && path->nodeCount() > paths.at(best)->nodeCount()))
+				{
+					best = i;
+					bestCost = cost;
+					append = pass == 0;
+				}
+			}
+		}
+
+		return best;
+	}
+
+	/* The neighbour on the cheapest way on to an end node or back to a
+	   start node, -1 when neither can be reached. Following the trees of
+	   the distances, a path can't go round a cycle of edges costing 0. */
+	int cheapestStep(const GraphSnapshot &snapshot, const CostDistances &distances,
+			 Path *currentPath, bool &append)
+	{
+		int best = -1;
+		double bestCost = CostDistances::Unreachable;
+
+		int last = snapshot.indexOf(currentPath->lastNode());
+		int first = snapshot.indexOf(currentPath->firstNode());
+
+		if(last != -1 && !snapshot.isEnd(last) && distances.nextToEnd(last) != -1)
+		{
+			best = distances.nextToEnd(last);
+			bestCost = distances.toEnd(last);
+			append = true;
+		}
+
+		if(first != -1 && !snapshot.isStart(first) && distances.previousFromStart(first) != -1
+		   && distances.fromStart(first) < bestCost)
+		{
+			best = distances.previousFromStart(first);
+			append = false;
+		}
+
+		return best;
+	}
 }
 
 void AbstractAlgorithm::filterSubpaths(QList<Path*> &paths, Path *currentPath)
 {
+	if(m_touring != DirectTouring)
+	{
+		SubsequenceAutomaton walk(nodeIds(currentPath), m_touring);
+
+		QMutableListIterator<Path*> it(paths);
+
+		while(it.hasNext())
+		{
+			Path *path = it.next();
+
+			if(walk.tours(nodeIds(path)))
+			{
+				it.remove();
+				delete path;
+			}
+		}
+
+		return;
+	}
+
 	foreach(Path *path, paths)
 	{
 		if(currentPath->containsPath(path))
@@ -72,6 +365,12 @@ void AbstractAlgorithm::filterSubpaths(QList<Path*> &paths, Path *currentPath)
 
 void AbstractAlgorithm::computeCoverage()
 {
+	bool byCost = m_objective == LowestCost;
+
+	// only walked for the cheapest connections
+	GraphSnapshot snapshot(byCost ? m_nodes : QList<Node*>());
+	CostDistances distances(snapshot);
+
 	QList<Path*> tmpPaths;
 
 	foreach(Path* path, m_reqResults)
@@ -84,6 +383,13 @@ void AbstractAlgorithm::computeCoverage()
 	{
 		Path *currentPath;
 
+		// the requirements left are not toured
+		if(isPastDeadline())
+		{
+			qDeleteAll(tmpPaths);
+			break;
+		}
+
 		//find longest path
 
 		int maxlen = tmpPaths.first()->nodeCount();
@@ -113,6 +419,10 @@ void AbstractAlgorithm::computeCoverage()
 
 		do
 		{
+			// checked here too, the steps for a path have no bound of their own
+			if(isPastDeadline())
+				break;
+
 			filterSubpaths(tmpPaths, currentPath);
 			qDebug() << "currentPath: " << currentPath->toText();
 
@@ -123,7 +433,13 @@ void AbstractAlgorithm::computeCoverage()
 				int maxoverlap = tmpPaths.first()->intersects(currentPath);
 				int maxi = 0;
 
-				for(int i = 1; i < tmpPaths.size(); ++i)
+				if(byCost)
+				{
+					maxi = cheapestOverlap(tmpPaths, currentPath);
+					maxoverlap = maxi == -1 ? 0 : tmpPaths.at(maxi)->intersects(currentPath);
+				}
+
+				for(int i = 1; i < tmpPaths.size() && !byCost; ++i)
 				{
 					Path *pathi = tmpPaths.at(i);
 
@@ -178,7 +494,7 @@ void AbstractAlgorithm::computeCoverage()
 
 				//find longest path that can be appended
 
-				for(int i = 0; i < tmpPaths.size(); ++i)
+				for(int i = 0; i < tmpPaths.size() && !byCost; ++i)
 				{
 					Path *pathi = tmpPaths.at(i);
 
@@ -194,7 +510,7 @@ void AbstractAlgorithm::computeCoverage()
 
 				//find longest path that can be prepended
 
-				for(int i = 0; i < tmpPaths.size(); ++i)
+				for(int i = 0; i < tmpPaths.size() && !byCost; ++i)
 				{
 					Path *pathi = tmpPaths.at(i);
 
@@ -209,6 +525,9 @@ void AbstractAlgorithm::computeCoverage()
 					}
 				}
 
+				if(byCost)
+					maxi = cheapestLink(tmpPaths, currentPath, append);
+
 				if(maxi != -1)
 				{
 					Path *pathi = tmpPaths.at(maxi);
@@ -236,9 +555,15 @@ void AbstractAlgorithm::computeCoverage()
 			int mindist = 0xFFFFFFF;
 			int mini = -1;
 
+			if(byCost)
+				mini = cheapestStep(snapshot, distances, currentPath, append);
+
+			// only when no step leads anywhere at any cost
+			bool searchNearest = mini == -1;
+
 			// finally search for nodes that are closest to end...
 
-			for(int i = 0; i < m_nodes.size(); ++i)
+			for(int i = 0; i < m_nodes.size() && searchNearest; ++i)
 			{
 				Node *node = m_nodes.at(i);
 
@@ -256,7 +581,7 @@ void AbstractAlgorithm::computeCoverage()
 
 			// ...or start
 
-			for(int i = 0; i < m_nodes.size(); ++i)
+			for(int i = 0; i < m_nodes.size() && searchNearest; ++i)
 			{
 				Node *node = m_nodes.at(i);
 
@@ -291,6 +616,13 @@ void AbstractAlgorithm::computeCoverage()
 		}
 		while(!currentPath->isTestPath());
 
+		if(!currentPath->isTestPath())
+		{
+			delete currentPath;
+			qDeleteAll(tmpPaths);
+			break;
+		}
+
 		filterSubpaths(tmpPaths, currentPath);
 
 		qDebug() << "currentPathend " << currentPath->toText();
@@ -299,6 +631,252 @@ void AbstractAlgorithm::computeCoverage()
 
 	} while(tmpPaths.size() > 0);
 
+	removeRedundantPaths();
+}
+
+void AbstractAlgorithm::computeConstrainedCoverage()
+{
+	GraphSnapshot snapshot(m_nodes);
+	ConstraintProduct product(snapshot, m_constraints);
+
+	int maxStates = (int)qMin(m_budget.maxBytes / ConstraintProduct::StateBytes, (qint64)0x7FFFFFFF);
+
+	/* too large to search, the test paths may break the constraints then
+	   while the requirements are still complete */
+	if(!product.build(maxStates))
+	{
+		m_constraintsIgnored = true;
+		computeCoverage();
+		return;
+	}
+
+	QList<QVector<int> > sequences;
+
+	foreach(Path *path, m_reqResults)
+	{
+		QVector<int> sequence;
+
+		foreach(Node *node, path->nodes())
+			sequence.append(snapshot.indexOf(node));
+
+		sequences.append(sequence);
+	}
+
+	RequirementTouring touring(sequences, snapshot.nodeCount(), m_touring);
+
+	// the longest ones first, a test path for them tours the most others
+	QList<QPair<int, int> > order;
+
+	for(int i = 0; i < sequences.size(); ++i)
+		order.append(qMakePair(-sequences.at(i).size(), i));
+
+	qSort(order);
+
+	QVector<bool> toured(sequences.size(), false);
+	QVector<bool> infeasible(sequences.size(), false);
+
+	for(int k = 0; k < order.size(); ++k)
+	{
+		int i = order.at(k).second;
+
+		if(toured.at(i))
+			continue;
+
+		// the requirements left are not toured
+		if(isPastDeadline())
+			break;
+
+		QVector<int> walk = product.testPath(sequences.at(i));
+
+		if(walk.isEmpty())
+		{
+			infeasible[i] = true;
+			continue;
+		}
+
+		QList<Node*> pathNodes;
+
+		foreach(int v, walk)
+			pathNodes.append(snapshot.node(v));
+
+		m_covResults.append(new Path(pathNodes));
+
+		foreach(int matched, touring.matches(walk))
+			toured[matched] = true;
+	}
+
+	// reported in the order of the requirements
+	for(int i = 0; i < sequences.size(); ++i)
+		if(infeasible.at(i))
+			m_infeasibleResults.append(m_reqResults.at(i));
+
+#ifdef DEBUG
+	qWarning() << "computeConstrainedCoverage:" << product.stateCount() << "product states,"
+		   << m_infeasibleResults.size() << "infeasible requirements";
+#endif
+
+	removeRedundantPaths();
+}
+
+void AbstractAlgorithm::removeRedundantPaths()
+{
+	m_coverageLowerBound = m_covResults.size();
+
+	if(m_covResults.size() < 2)
+		return;
+
+	QHash<Node*, int> symbols;
+
+	for(int i = 0; i < m_nodes.size(); ++i)
+		symbols.insert(m_nodes.at(i), i);
+
+	QList<QVector<int> > sequences;
+
+	foreach(Path *path, m_reqResults)
+	{
+		QVector<int> sequence;
+
+		foreach(Node *node, path->nodes())
+			sequence.append(symbols.value(node));
+
+		sequences.append(sequence);
+	}
 
+	RequirementTouring touring(sequences, m_nodes.size(), m_touring);
+
+	// every test path is the set of requirements it tours, priced by its edges
+	SetCover cover(m_reqResults.size());
+
+	foreach(Path *path, m_covResults)
+	{
+		QVector<int> walk;
+
+		foreach(Node *node, path->nodes())
+			walk.append(symbols.value(node));
+
+		if(m_objective == LowestCost)
+			cover.addSet(touring.matches(walk), path->cost());
+		else
+			cover.addSet(touring.matches(walk));
+	}
+
+	cover.solve();
+
+	QList<int> selected = cover.selected();
+	qSort(selected);
+
+	QList<Path*> kept;
+
+	for(int i = 0, j = 0; i < m_covResults.size(); ++i)
+	{
+		if(j < selected.size() && selected.at(j) == i)
+		{
+			kept.append(m_covResults.at(i));
+			j++;
+		}
+		else
+		{
+#ifdef DEBUG
+			qWarning() << "removeRedundantPaths: redundant path" << m_covResults.at(i)->toText();
+#endif
+			delete m_covResults.at(i);
+		}
+	}
+
+	m_covResults = kept;
+	m_coverageLowerBound = cover.lowerBound();
+}
+
+void AbstractAlgorithm::computeShortestPaths()
+{
+	GraphSnapshot snapshot(m_nodes);
+	QList<QVector<int> > sequences;
+
+	foreach(Path *path, m_reqResults)
+	{
+		QVector<int> sequence;
+
+		foreach(Node *node, path->nodes())
+			sequence.append(snapshot.indexOf(node));
+
+		sequences.append(sequence);
+	}
+
+	ShortestTestPaths shortest(snapshot);
+	shortest.build(sequences);
+
+	foreach(const QVector<int> &testPath, shortest.testPaths())
+	{
+		QList<Node*> pathNodes;
+
+		foreach(int v, testPath)
+			pathNodes.append(snapshot.node(v));
+
+		addCovResult(new Path(pathNodes));
+	}
+
+	// only tells how far one path per requirement is from the fewest
+	SuiteOptimizer optimizer(snapshot, sequences, m_touring);
+	int time = m_budget.timeLimit > 0 ? m_budget.timeLimit - elapsed() : 0x7FFFFFFF;
+
+	if(time > 0)
+		m_coverageLowerBound = optimizer.estimateLowerBound(time);
+}
+
+void AbstractAlgorithm::optimizeCoverage()
+{
+	if(m_covResults.isEmpty())
+		return;
+
+	GraphSnapshot snapshot(m_nodes);
+	QList<QVector<int> > sequences;
+	QList<QVector<int> > walks;
+
+	foreach(Path *path, m_reqResults)
+	{
+		QVector<int> sequence;
+
+		foreach(Node *node, path->nodes())
+			sequence.append(snapshot.indexOf(node));
+
+		sequences.append(sequence);
+	}
+
+	foreach(Path *path, m_covResults)
+	{
+		QVector<int> walk;
+
+		foreach(Node *node, path->nodes())
+			walk.append(snapshot.indexOf(node));
+
+		walks.append(walk);
+	}
+
+	SuiteOptimizer optimizer(snapshot, sequences, m_touring, m_objective);
+	optimizer.setSuite(walks);
+	optimizer.setCancelFlag(m_cancel);
+
+	// the time limit of the run holds for the optimization too
+	int time = m_optimizationTime;
+
+	if(m_budget.timeLimit > 0)
+		time = qMin(time, m_budget.timeLimit - elapsed());
+
+	optimizer.optimize(qMax(time, 0));
+
+	qDeleteAll(m_covResults);
+	m_covResults.clear();
+
+	foreach(const QVector<int> &walk, optimizer.suite())
+	{
+		QList<Node*> pathNodes;
+
+		foreach(int v, walk)
+			pathNodes.append(snapshot.node(v));
+
+		m_covResults.append(new Path(pathNodes));
+	}
 
+	// the bound of the set cover only holds for the paths it was given
+	m_coverageLowerBound = optimizer.lowerBound();
 }
@@ -2,21 +2,63 @@
 #define ABSTRACTALGORITHM_H
 
 #include <QList>
+#include <QTime>
+#include <QAtomicInt>
 
 #include "algorithmnode.h"
 #include "algorithmpath.h"
+#include "resourcebudget.h"
+#include "dominatortree.h"
+#include "pathconstraints.h"
+#include "subsequenceautomaton.h"
 
 namespace Algorithm
 {
+	// what the test suite is made small in
+	enum Objective { FewestPaths, LowestCost };
+
+	QString objectiveText(Objective objective);
+	Objective objectiveFromText(const QString &text, bool *ok = 0);
+
 	class AbstractAlgorithm
 	{
 		private:
 			QList<Node*> m_nodes;
 			QList<Path*> m_covResults;
 			QList<Path*> m_reqResults;
+			QList<Path*> m_infeasibleResults;
+			int m_coverageLowerBound;
+
+			PathConstraints m_constraints;
+			bool m_constraintsIgnored;
+
+			ResourceBudget m_budget;
+			ResourceBudget::Limit m_truncation;
+			qint64 m_estimatedBytes;
+			int m_budgetChecks;
+			QTime m_timer;
+
+			// trees are only reused for the graph version they were built for
+			int m_graphVersion;
+			int m_dominanceVersion;
+			const Dominance *m_dominance;
+			Dominance *m_ownDominance;
+
+			TouringMode m_touring;
+			Objective m_objective;
+			int m_optimizationTime;
+			const QAtomicInt *m_cancel;
+			bool m_onePathPerRequirement;
 
 			void addCovResult(Path *path);
 			void computeCoverage();
+			void computeShortestPaths();
+			void computeConstrainedCoverage();
+			void removeRedundantPaths();
+			void optimizeCoverage();
+
+			// reads the clock on every call, for the steps that take long anyway
+			bool isPastDeadline();
 
 
 		protected:
@@ -25,12 +67,99 @@ namespace Algorithm
 
 			QList<Node*> &nodes() { return m_nodes; }
 
+			// clears the results and starts the clock of the budget
+			void beginRun(const QList<Node*> &nodes);
+
+			/* Cheap enough for the innermost loops, once it returns true the
+			   run should stop and keep what it has. */
+			bool isOverBudget();
+			bool isOutOfTime();
+			void truncate(ResourceBudget::Limit limit);
+
+			/* Only the number and size of the requirements, to keep adding
+			   what was found after the time ran out. */
+			bool isOverSizeBudget();
+
+			// milliseconds since beginRun()
+			int elapsed() const { return m_timer.elapsed(); }
+
+			/* The one given for the graph version of the run, or built for
+			   its nodes and kept while the version stays the same. */
+			const Dominance *dominance();
+
 			virtual void onCompute() = 0;
 
 		public:
+			AbstractAlgorithm()
+				: m_coverageLowerBound(0), m_constraintsIgnored(false), m_truncation(ResourceBudget::NoLimit),
+				  m_estimatedBytes(0), m_budgetChecks(0),
+				  m_graphVersion(NoGraphVersion), m_dominanceVersion(NoGraphVersion), m_dominance(0), m_ownDominance(0),
+				  m_touring(DirectTouring), m_objective(FewestPaths), m_optimizationTime(0),
+				  m_cancel(0), m_onePathPerRequirement(false) {}
+
 			const QList<Path*> &coverageResults() const;
 			const QList<Path*> &requirementsResults() const;
 
+			// requirements no test path can tour without breaking the constraints
+			const QList<Path*> &infeasibleResults() const { return m_infeasibleResults; }
+
+			/* Set when the constraints were too many to search, the test paths
+			   were then built without them and may break them. */
+			bool constraintsIgnored() const { return m_constraintsIgnored; }
+
+			/* no test suite touring all the requirements is smaller than this,
+			   after an optimization the bound holds for any test paths */
+			int coverageLowerBound() const { return m_coverageLowerBound; }
+
+			void setBudget(const ResourceBudget &budget) { m_budget = budget; }
+
+			/* Counts the edits of the graph the nodes of the next run come
+			   from. Without one, analyses are not kept from run to run. */
+			void setGraphVersion(int version) { m_graphVersion = version; }
+
+			// dominator trees of that version, so they are not built again; not owned
+			void setDominance(const Dominance *dominance, int graphVersion);
+
+			static const int NoGraphVersion = -1;
+
+			/* Test paths are generated around these, for the nodes the next run
+			   gets. */
+			void setConstraints(const PathConstraints &constraints) { m_constraints = constraints; }
+
+			/* How test paths tour the requirements, with sidetrips or detours
+			   they tour more of them and fewer are needed. */
+			void setTouring(TouringMode touring) { m_touring = touring; }
+			TouringMode touring() const { return m_touring; }
+
+			/* With LowestCost the test paths are built and picked for the sum
+			   of their edge costs rather than for their number. */
+			void setObjective(Objective objective) { m_objective = objective; }
+			Objective objective() const { return m_objective; }
+
+			// total edge cost of the test paths
+			double suiteCost() const;
+
+			/* Milliseconds SuiteOptimizer gets to improve the test paths after
+			   they are generated, 0 for none. Not done under constraints. */
+			void setOptimizationTime(int milliseconds) { m_optimizationTime = milliseconds; }
+			int optimizationTime() const { return m_optimizationTime; }
+
+			/* Once the flag is set the run stops as if its time ran out, for
+			   runs on other threads. Not owned. */
+			void setCancelFlag(const QAtomicInt *cancel) { m_cancel = cancel; }
+
+			/* A shortest test path for every requirement on its own, built by
+			   ShortestTestPaths, rather than merged ones. Not done under
+			   constraints. */
+			void setOnePathPerRequirement(bool enabled) { m_onePathPerRequirement = enabled; }
+			bool onePathPerRequirement() const { return m_onePathPerRequirement; }
+
+			const ResourceBudget &budget() const { return m_budget; }
+
+			// the results are partial when a limit stopped the run
+			bool isTruncated() const { return m_truncation != ResourceBudget::NoLimit; }
+			ResourceBudget::Limit truncation() const { return m_truncation; }
+
 			void clearResults();
 			void compute(const QList<Node*> &nodes, bool doComputeCoverage = true);
 
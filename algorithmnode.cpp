@@ -1,19 +1,29 @@
 #include "algorithmnode.h"
 
 #include "algorithmpath.h"
+#include "graphmodel.h"
+
+#include <QHash>
 
 using namespace Algorithm;
 
-Node::Node(GraphNode *graphNode)
-	: m_graphNode(graphNode)
+Node::Node(int id, const QString &label, GraphNode::NodeType type)
+	: m_id(id), m_label(label), m_type(type)
 {
 
 }
 
-void Node::addLink(Node *node, GraphEdge *edge)
+void Node::setDataFlow(const QStringList &defs, const QStringList &uses)
+{
+	m_defs = defs;
+	m_uses = uses;
+}
+
+void Node::addLink(Node *node, int edgeId, double cost)
 {
 	m_links.append(node);
-	m_graphEdges.append(edge);
+	m_edgeIds.append(edgeId);
+	m_edgeCosts.append(cost);
 }
 
 const QList<Node*> &Node::links() const
@@ -23,12 +33,12 @@ const QList<Node*> &Node::links() const
 
 QString Node::label() const
 {
-	return m_graphNode->label();
+	return m_label;
 }
 
 GraphNode::NodeType Node::type() const
 {
-	return m_graphNode->nodeType();
+	return m_type;
 }
 
 int Node::linkCount() const
@@ -36,11 +46,6 @@ int Node::linkCount() const
 	return m_links.size();
 }
 
-GraphNode *Node::graphNode() const
-{
-	return m_graphNode;
-}
-
 Node *Node::getEdgeToNode(Node *node)
 {
 	int i = m_links.indexOf(node);
@@ -51,14 +56,26 @@ Node *Node::getEdgeToNode(Node *node)
 	return m_links.at(i);
 }
 
-GraphEdge *Node::getGraphEdgeToNode(Node *node)
+int Node::edgeIdToNode(Node *node)
 {
 	int i = m_links.indexOf(node);
 
 	if(i == -1)
-		return 0;
+		return -1;
+
+	return m_edgeIds.at(i);
+}
+
+double Node::costToNode(Node *node) const
+{
+	double cost = -1;
+
+	// parallel edges may cost differently
+	for(int i = 0; i < m_links.size(); ++i)
+		if(m_links.at(i) == node && (cost < 0 || m_edgeCosts.at(i) < cost))
+			cost = m_edgeCosts.at(i);
 
-	return m_graphEdges.at(i);
+	return cost;
 }
 
 void Node::addBackLink(Node *node)
@@ -146,3 +163,33 @@ bool Node::hasLink(Node *node)
 	return false;
 }
 
+
+QList<Node*> Algorithm::nodesFromModel(const GraphModel &model)
+{
+	QList<Node*> nodes;
+	QHash<int, Node*> nodesById;
+
+	foreach(int id, model.nodeIds())
+	{
+		const GraphModelTypes::ModelNode &modelNode = model.node(id);
+		Node *node = new Node(id, modelNode.label, modelNode.type);
+		node->setDataFlow(modelNode.defs, modelNode.uses);
+		node->setCallee(modelNode.callee);
+
+		nodes.append(node);
+		nodesById.insert(id, node);
+	}
+
+	foreach(int id, model.edgeIds())
+	{
+		const GraphModelTypes::ModelEdge &modelEdge = model.edge(id);
+
+		Node *fromNode = nodesById.value(modelEdge.fromNodeId);
+		Node *toNode = nodesById.value(modelEdge.toNodeId);
+
+		fromNode->addLink(toNode, id, modelEdge.cost);
+		toNode->addBackLink(fromNode);
+	}
+
+	return nodes;
+}
@@ -3,9 +3,11 @@
 
 #include <QList>
 #include <QString>
+#include <QStringList>
 
 #include "graphnode.h"
-#include "graphedge.h"
+
+class GraphModel;
 
 namespace Algorithm
 {
@@ -16,30 +18,56 @@ namespace Algorithm
 		private:
 			QList<Node*> m_links;
 			QList<Node*> m_backLinks;
-			QList<GraphEdge*> m_graphEdges;
-			GraphNode *m_graphNode;
+			QList<int> m_edgeIds;
+			QList<double> m_edgeCosts;
+
+			int m_id;
+			QString m_label;
+			GraphNode::NodeType m_type;
+
+			QStringList m_defs;
+			QStringList m_uses;
+			QString m_callee;
 
 		public:
-			Node(GraphNode *graphNode);
+			Node(int id, const QString &label, GraphNode::NodeType type);
 
 			void addBackLink(Node *node);
-			void addLink(Node *node, GraphEdge *edge);
+			void addLink(Node *node, int edgeId, double cost = 1.0);
 			bool hasLink(Node *node);
 
 			const QList<Node*> &links() const;
+			const QList<Node*> &backLinks() const { return m_backLinks; }
+			const QList<int> &edgeIds() const { return m_edgeIds; }
+			const QList<double> &edgeCosts() const { return m_edgeCosts; }
 			QString label() const;
 
 			GraphNode::NodeType type() const;
 			int linkCount() const;
 
-			GraphEdge *getGraphEdgeToNode(Node *node);
+			int edgeIdToNode(Node *node);
+
+			// of the cheapest edge to the node, -1 when there is none
+			double costToNode(Node *node) const;
 			Node *getEdgeToNode(Node *node);
 
-			GraphNode *graphNode() const;
+			int id() const { return m_id; }
+
+			// variables defined and used in the node
+			const QStringList &defs() const { return m_defs; }
+			const QStringList &uses() const { return m_uses; }
+			void setDataFlow(const QStringList &defs, const QStringList &uses);
+
+			// graph file of the called function, relative to the caller's file
+			const QString &callee() const { return m_callee; }
+			void setCallee(const QString &callee) { m_callee = callee; }
 
 			int distanceToNearestStartNode(Path *path = 0);
 			int distanceToNearestEndNode(Path *path = 0);
 	};
+
+	// the caller owns the nodes, they are in the order of model ids
+	QList<Node*> nodesFromModel(const GraphModel &model);
 }
 
 #endif // ALGORITHMNODE_H
@@ -81,6 +81,16 @@ int Path::edgeCount() const
 	return m_nodes.size() - 1;
 }
 
+double Path::cost() const
+{
+	double cost = 0;
+
+	for(int i = 0; i + 1 < m_nodes.size(); ++i)
+		cost += qMax(0.0, m_nodes.at(i)->costToNode(m_nodes.at(i + 1)));
+
+	return cost;
+}
+
 void Path::intersectionLeftPos(const Path *path, int &start, int &end, int &len) const
 {
 	int maxLen = 0;
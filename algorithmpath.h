@@ -37,6 +37,9 @@ namespace Algorithm
 			int nodeCount() const;
 			int edgeCount() const;
 
+			// sum of the cheapest edges between the nodes
+			double cost() const;
+
 			bool containsPath(const Path *path) const;
 			bool containsEdge(Node *fromNode, Node *toNode);
 			bool containsNode(Node *node);
@@ -0,0 +1,31 @@
+#include "alldefsalgorithm.h"
+
+#include <QDebug>
+
+using namespace Algorithm;
+
+// one du-path from every definition to the nearest of its uses
+void AllDefsAlgorithm::onCompute()
+{
+	analyze();
+
+	for(int def = 0; def < definitionCount(); ++def)
+	{
+		if(isOverBudget())
+			break;
+
+		QVector<int> path = shortestDuPath(def);
+
+		if(path.isEmpty())
+		{
+#ifdef DEBUG
+			qWarning() << "onCompute: definition without use in node" << definition(def).node;
+#endif
+			continue;
+		}
+
+		addDuPath(path);
+	}
+
+	releaseAnalysis();
+}
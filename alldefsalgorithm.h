@@ -0,0 +1,15 @@
+#ifndef ALLDEFSALGORITHM_H
+#define ALLDEFSALGORITHM_H
+
+#include "dataflowalgorithm.h"
+
+namespace Algorithm
+{
+	class AllDefsAlgorithm : public DataFlowAlgorithm
+	{
+		protected:
+			void onCompute();
+	};
+}
+
+#endif // ALLDEFSALGORITHM_H
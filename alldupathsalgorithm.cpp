@@ -0,0 +1,23 @@
+#include "alldupathsalgorithm.h"
+
+using namespace Algorithm;
+
+// every du-path of every definition and the uses it reaches
+void AllDuPathsAlgorithm::onCompute()
+{
+	analyze();
+
+	for(int def = 0; def < definitionCount(); ++def)
+	{
+		foreach(int useNode, reachedUses(def))
+		{
+			if(isOverBudget())
+				break;
+
+			foreach(const QVector<int> &path, allDuPaths(def, useNode))
+				addDuPath(path);
+		}
+	}
+
+	releaseAnalysis();
+}
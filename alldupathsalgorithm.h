@@ -0,0 +1,15 @@
+#ifndef ALLDUPATHSALGORITHM_H
+#define ALLDUPATHSALGORITHM_H
+
+#include "dataflowalgorithm.h"
+
+namespace Algorithm
+{
+	class AllDuPathsAlgorithm : public DataFlowAlgorithm
+	{
+		protected:
+			void onCompute();
+	};
+}
+
+#endif // ALLDUPATHSALGORITHM_H
@@ -0,0 +1,25 @@
+#include "allusesalgorithm.h"
+
+using namespace Algorithm;
+
+// one du-path for every use a definition reaches
+void AllUsesAlgorithm::onCompute()
+{
+	analyze();
+
+	for(int def = 0; def < definitionCount(); ++def)
+	{
+		foreach(int useNode, reachedUses(def))
+		{
+			if(isOverBudget())
+				break;
+
+			QVector<int> path = shortestDuPath(def, useNode);
+
+			if(!path.isEmpty())
+				addDuPath(path);
+		}
+	}
+
+	releaseAnalysis();
+}
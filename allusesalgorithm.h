@@ -0,0 +1,15 @@
+#ifndef ALLUSESALGORITHM_H
+#define ALLUSESALGORITHM_H
+
+#include "dataflowalgorithm.h"
+
+namespace Algorithm
+{
+	class AllUsesAlgorithm : public DataFlowAlgorithm
+	{
+		protected:
+			void onCompute();
+	};
+}
+
+#endif // ALLUSESALGORITHM_H
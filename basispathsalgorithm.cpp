@@ -0,0 +1,179 @@
+#include "basispathsalgorithm.h"
+
+#include <QDebug>
+
+#include "graphsnapshot.h"
+#include "shortesttestpaths.h"
+
+using namespace Algorithm;
+
+namespace
+{
+	int lowestBit(quint64 bits)
+	{
+		int i = 0;
+
+		while((bits & 1) == 0)
+		{
+			bits >>= 1;
+			i++;
+		}
+
+		return i;
+	}
+}
+
+void BasisPathsAlgorithm::onCompute()
+{
+	GraphSnapshot snapshot(nodes());
+
+	m_columns.fill(-1, snapshot.edgeCount());
+	int columnCount = 0;
+
+	for(int v = 0; v < snapshot.nodeCount(); ++v)
+	{
+		for(int e = snapshot.edgeBegin(v); e < snapshot.edgeEnd(v); ++e)
+		{
+			int first = snapshot.findEdge(v, snapshot.edgeTarget(e));
+
+			if(m_columns.at(first) == -1)
+				m_columns[first] = columnCount++;
+
+			m_columns[e] = m_columns.at(first);
+		}
+	}
+
+	m_complexity = qMax(columnCount - snapshot.nodeCount() + 2, 1);
+	m_words = (columnCount + 63) / 64;
+	m_rows.clear();
+	m_pivotRow.fill(-1, columnCount);
+
+	// the shortest test path through every edge
+	QList<QVector<int> > edges;
+
+	for(int v = 0; v < snapshot.nodeCount(); ++v)
+		for(int e = snapshot.edgeBegin(v); e < snapshot.edgeEnd(v); ++e)
+			if(snapshot.findEdge(v, snapshot.edgeTarget(e)) == e)
+				edges.append(QVector<int>() << v << snapshot.edgeTarget(e));
+
+	ShortestTestPaths shortest(snapshot);
+	shortest.build(edges);
+	addCandidates(snapshot, shortest.testPaths());
+
+	// through an edge and then, the shortest way on, through another one
+	for(int i = 0; i < edges.size() && requirementsResults().size() < m_complexity; ++i)
+	{
+		if(isOverBudget())
+			return;
+
+		int from = edges.at(i).last();
+
+		QVector<int> parent(snapshot.nodeCount(), -1);
+		QVector<bool> visited(snapshot.nodeCount(), false);
+		QVector<int> queue;
+
+		visited[from] = true;
+		queue.append(from);
+
+		for(int k = 0; k < queue.size(); ++k)
+		{
+			int v = queue.at(k);
+
+			for(int e = snapshot.edgeBegin(v); e < snapshot.edgeEnd(v); ++e)
+			{
+				int target = snapshot.edgeTarget(e);
+
+				if(visited.at(target))
+					continue;
+
+				visited[target] = true;
+				parent[target] = v;
+				queue.append(target);
+			}
+		}
+
+		QList<QVector<int> > pairs;
+
+		for(int j = 0; j < edges.size(); ++j)
+		{
+			int to = edges.at(j).first();
+
+			if(j == i || !visited.at(to))
+				continue;
+
+			QVector<int> between;
+
+			for(int v = to; v != from; v = parent.at(v))
+				between.append(v);
+
+			QVector<int> sequence(edges.at(i));
+
+			for(int k = between.size() - 1; k >= 0; --k)
+				sequence.append(between.at(k));
+
+			sequence.append(edges.at(j).last());
+			pairs.append(sequence);
+		}
+
+		shortest.build(pairs);
+		addCandidates(snapshot, shortest.testPaths());
+	}
+}
+
+void BasisPathsAlgorithm::addCandidates(const GraphSnapshot &snapshot, const QList<QVector<int> > &paths)
+{
+	foreach(const QVector<int> &path, paths)
+	{
+		if(requirementsResults().size() >= m_complexity || isOverBudget())
+			return;
+
+		if(!isIndependent(snapshot, path))
+			continue;
+
+		QList<Node*> pathNodes;
+
+		foreach(int v, path)
+			pathNodes.append(snapshot.node(v));
+
+		addReqResult(new Path(pathNodes));
+	}
+}
+
+bool BasisPathsAlgorithm::isIndependent(const GraphSnapshot &snapshot, const QVector<int> &path)
+{
+	// an edge taken twice cancels out over GF(2)
+	QVector<quint64> vector(m_words, 0);
+
+	for(int i = 1; i < path.size(); ++i)
+	{
+		int column = m_columns.at(snapshot.findEdge(path.at(i - 1), path.at(i)));
+		vector[column / 64] ^= (quint64)1 << (column % 64);
+	}
+
+	// every row cleared the lowest bit left, so this ends
+	for(int w = 0; w < m_words; )
+	{
+		if(vector.at(w) == 0)
+		{
+			w++;
+			continue;
+		}
+
+		int pivot = w * 64 + lowestBit(vector.at(w));
+		int row = m_pivotRow.at(pivot);
+
+		if(row == -1)
+		{
+			m_pivotRow[pivot] = m_rows.size() / m_words;
+			m_rows += vector;
+			return true;
+		}
+
+		const quint64 *bits = m_rows.constData() + row * m_words;
+
+		for(int k = w; k < m_words; ++k)
+			vector[k] ^= bits[k];
+	}
+
+	return false;
+}
@@ -0,0 +1,48 @@
+#ifndef BASISPATHSALGORITHM_H
+#define BASISPATHSALGORITHM_H
+
+#include <QList>
+#include <QVector>
+
+#include "abstractalgorithm.h"
+
+namespace Algorithm
+{
+	class GraphSnapshot;
+
+	/* McCabe's basis paths: test paths whose edge incidence vectors are
+	   linearly independent over GF(2), as many as the cyclomatic
+	   complexity E - N + 2 (parallel edges count once). Candidates are the
+	   shortest test path through every edge, then those through every
+	   pair of edges when these don't reach the complexity. Independence is
+	   checked by Gaussian elimination on bit packed rows. The basis paths
+	   are the requirements and already test paths.
+	*/
+	class BasisPathsAlgorithm : public AbstractAlgorithm
+	{
+		private:
+			// bit packed rows of the basis, the lowest bit of every row is its pivot
+			QVector<quint64> m_rows;
+			QVector<int> m_pivotRow;
+			int m_words;
+
+			// column of every edge, parallel ones share it
+			QVector<int> m_columns;
+
+			int m_complexity;
+
+			void addCandidates(const GraphSnapshot &snapshot, const QList<QVector<int> > &paths);
+			bool isIndependent(const GraphSnapshot &snapshot, const QVector<int> &path);
+
+		public:
+			BasisPathsAlgorithm() : m_words(0), m_complexity(0) {}
+
+			// E - N + 2 of the last run
+			int complexity() const { return m_complexity; }
+
+		protected:
+			void onCompute();
+	};
+}
+
+#endif // BASISPATHSALGORITHM_H
@@ -0,0 +1,120 @@
+#include "chainreduction.h"
+
+#include <QStringList>
+
+using namespace Algorithm;
+
+ChainReduction::ChainReduction(const QList<Node*> &nodes)
+	: m_snapshot(nodes)
+{
+	int n = m_snapshot.nodeCount();
+
+	m_chainOf.fill(-1, n);
+	m_position.fill(0, n);
+
+	// a node starts a chain unless the single edge into it continues one
+	for(int v = 0; v < n; ++v)
+	{
+		if(m_snapshot.inDegree(v) == 1)
+		{
+			int from = m_snapshot.edgeSource(m_snapshot.inEdge(m_snapshot.inEdgeBegin(v)));
+
+			if(isChainEdge(from, v))
+				continue;
+		}
+
+		QVector<int> chain;
+		chain.append(v);
+
+		for(int u = v; m_snapshot.outDegree(u) == 1; )
+		{
+			u = m_snapshot.edgeTarget(m_snapshot.edgeBegin(u));
+
+			if(!isChainEdge(chain.last(), u))
+				break;
+
+			chain.append(u);
+		}
+
+		for(int i = 0; i < chain.size(); ++i)
+		{
+			m_chainOf[chain.at(i)] = m_chains.size();
+			m_position[chain.at(i)] = i;
+		}
+
+		m_chains.append(chain);
+	}
+
+	// the cycles made of chain edges only, nothing started them
+	for(int v = 0; v < n; ++v)
+	{
+		if(m_chainOf.at(v) != -1)
+			continue;
+
+		m_chainOf[v] = m_chains.size();
+		m_chains.append(QVector<int>(1, v));
+	}
+
+	if(!isReduced())
+		return;
+
+	for(int c = 0; c < m_chains.size(); ++c)
+	{
+		const QVector<int> &chain = m_chains.at(c);
+		Node *first = m_snapshot.node(chain.first());
+
+		QStringList labels;
+
+		foreach(int v, chain)
+			labels << m_snapshot.node(v)->label();
+
+		Node *node = new Node(first->id(), labels.join(" "), first->type());
+		m_reduced.append(node);
+		m_reducedIndexes.insert(node, c);
+	}
+
+	for(int c = 0; c < m_chains.size(); ++c)
+	{
+		int last = m_chains.at(c).last();
+
+		for(int e = m_snapshot.edgeBegin(last); e < m_snapshot.edgeEnd(last); ++e)
+		{
+			Node *target = m_reduced.at(m_chainOf.at(m_snapshot.edgeTarget(e)));
+
+			m_reduced.at(c)->addLink(target, m_snapshot.edgeModelId(e));
+			target->addBackLink(m_reduced.at(c));
+		}
+	}
+}
+
+ChainReduction::~ChainReduction()
+{
+	qDeleteAll(m_reduced);
+}
+
+bool ChainReduction::isChainEdge(int from, int to) const
+{
+	return from != to && m_snapshot.outDegree(from) == 1 && m_snapshot.inDegree(to) == 1;
+}
+
+QList<Node*> ChainReduction::expand(const QList<Node*> &reducedPath) const
+{
+	QList<Node*> path;
+
+	for(int i = 0; i < reducedPath.size(); ++i)
+	{
+		const QVector<int> &chain = m_chains.at(reducedIndex(reducedPath.at(i)));
+
+		// a cycle closes at the first node it started with
+		if(i > 0 && i == reducedPath.size() - 1 && reducedPath.at(i) == reducedPath.first())
+		{
+			path.append(m_snapshot.node(chain.first()));
+			break;
+		}
+
+		foreach(int v, chain)
+			path.append(m_snapshot.node(v));
+	}
+
+	return path;
+}
@@ -0,0 +1,58 @@
+#ifndef CHAINREDUCTION_H
+#define CHAINREDUCTION_H
+
+#include <QList>
+#include <QVector>
+#include <QHash>
+
+#include "algorithmnode.h"
+#include "graphsnapshot.h"
+
+namespace Algorithm
+{
+	/* The graph with straight line runs collapsed. An edge u -> v is
+	   inside a chain when it is the only edge leaving u and the only one
+	   entering v, every maximal run of such edges becomes one node of the
+	   reduced graph which takes the edges into its first node and out of
+	   its last one. A cycle made only of such edges is left as it is.
+	   Reduced nodes are in the order of the first nodes of their chains,
+	   such cycles after them, and are only created when there is something
+	   to collapse.
+	*/
+	class ChainReduction
+	{
+		public:
+			ChainReduction(const QList<Node*> &nodes);
+			~ChainReduction();
+
+			// false when there is no chain, the reduced graph is the same
+			bool isReduced() const { return m_chains.size() < m_snapshot.nodeCount(); }
+
+			const QList<Node*> &reducedNodes() const { return m_reduced; }
+			int reducedIndex(Node *node) const { return m_reducedIndexes.value(node, -1); }
+
+			// original node indexes of a reduced node, in the order of the chain
+			const QVector<int> &chain(int c) const { return m_chains.at(c); }
+
+			// chain of an original node and its position in it
+			int chainOf(int v) const { return m_chainOf.at(v); }
+			int positionInChain(int v) const { return m_position.at(v); }
+
+			Node *originalNode(int v) const { return m_snapshot.node(v); }
+
+			QList<Node*> expand(const QList<Node*> &reducedPath) const;
+
+		private:
+			GraphSnapshot m_snapshot;
+
+			QList<Node*> m_reduced;
+			QHash<Node*, int> m_reducedIndexes;
+			QVector<QVector<int> > m_chains;
+			QVector<int> m_chainOf;
+			QVector<int> m_position;
+
+			bool isChainEdge(int from, int to) const;
+	};
+}
+
+#endif // CHAINREDUCTION_H
@@ -0,0 +1,816 @@
+#include "commandline.h"
+
+#include <QFile>
+#include <QDataStream>
+#include <QThreadPool>
+#include <QTime>
+#include <QHash>
+#include <QRegExp>
+
+#include <stdio.h>
+
+#include "graphscenememento.h"
+#include "tracecoverage.h"
+#include "graphsnapshot.h"
+#include "pathnumbering.h"
+#include "requirementcounter.h"
+#include "pathstore.h"
+#include "functionsummaries.h"
+
+#include "nodesalgorithm.h"
+#include "edgesalgorithm.h"
+#include "edgepairalgorithm.h"
+#include "simplepathsalgorithm.h"
+#include "primepathsalgorithm.h"
+#include "alldefsalgorithm.h"
+#include "allusesalgorithm.h"
+#include "alldupathsalgorithm.h"
+#include "basispathsalgorithm.h"
+#include "simpleroundtripalgorithm.h"
+#include "completeroundtripalgorithm.h"
+
+using namespace Algorithm;
+
+// requirements exported with --binary: magic, node count, CompressedPaths
+#define QCR_MAGIC 0x3fac9e3e
+
+CommandLine::CommandLine(const QStringList &arguments)
+	: m_arguments(arguments), m_out(stdout), m_err(stderr),
+	  m_criterion("prime"), m_threads(0), m_timeBudget(RequirementCounter::DefaultTimeBudget), m_binary(false),
+	  m_touring(DirectTouring), m_objective(FewestPaths), m_optimizationTime(0),
+	  m_perRequirement(false), m_strategies(Portfolio::allStrategies())
+{
+}
+
+bool CommandLine::isRequested(int argc, char **argv)
+{
+	return argc > 1 && (qstrcmp(argv[1], "--trace") == 0 ||
+			    qstrcmp(argv[1], "--count-paths") == 0 ||
+			    qstrcmp(argv[1], "--export-requirements") == 0 ||
+			    qstrcmp(argv[1], "--program") == 0 ||
+			    qstrcmp(argv[1], "--portfolio") == 0);
+}
+
+void CommandLine::printUsage()
+{
+	m_err << "usage: qcoverage --trace GRAPH.qcv [--criterion nodes|edges|edgepair|simple|prime"
+	      << "|alldefs|alluses|alldupaths|basis|simpleroundtrip|completeroundtrip] [--threads N]" << endl;
+	m_err << "       [--max-requirements N] [--max-memory MB] [--time-limit MS] [--requirements FILE]"
+	      << " [--touring direct|sidetrips|detours] [TRACE...]" << endl;
+	m_err << "       qcoverage --count-paths GRAPH.qcv [--time-budget MS]" << endl;
+	m_err << "       qcoverage --export-requirements GRAPH.qcv [--criterion simple|prime]"
+	      << " [--max-memory MB] [--time-limit MS] [--tests FILE] [--binary] [OUTPUT]" << endl;
+	m_err << "       qcoverage --program GRAPH.qcv [--criterion ...] [--time-limit MS] [--touring ...]"
+	      << " [--objective fewest|cost] [--optimize MS] [--per-requirement] [--summary-cache FILE]" << endl;
+	m_err << "       qcoverage --portfolio GRAPH.qcv [--criterion ...] [--time-limit MS] [--touring ...]"
+	      << " [--objective ...] [--strategies merge,cost,search,shortest] [--optimize MS]"
+	      << " [--log FILE]" << endl;
+}
+
+bool CommandLine::parseArguments()
+{
+	// the first one is the program, the second the mode
+	m_mode = m_arguments.value(1);
+
+	for(int i = 2; i < m_arguments.size(); ++i)
+	{
+		const QString &argument = m_arguments.at(i);
+
+		if(argument == "--criterion" && i + 1 < m_arguments.size())
+		{
+			m_criterion = m_arguments.at(++i);
+		}
+		else if(argument == "--threads" && i + 1 < m_arguments.size())
+		{
+			m_threads = m_arguments.at(++i).toInt();
+		}
+		else if(argument == "--max-requirements" && i + 1 < m_arguments.size())
+		{
+			m_budget.maxRequirements = m_arguments.at(++i).toInt();
+		}
+		else if(argument == "--max-memory" && i + 1 < m_arguments.size())
+		{
+			m_budget.maxBytes = m_arguments.at(++i).toLongLong() * 1024 * 1024;
+		}
+		else if(argument == "--time-limit" && i + 1 < m_arguments.size())
+		{
+			m_budget.timeLimit = m_arguments.at(++i).toInt();
+		}
+		else if(argument == "--tests" && i + 1 < m_arguments.size())
+		{
+			m_testsFilename = m_arguments.at(++i);
+		}
+		else if(argument == "--requirements" && i + 1 < m_arguments.size())
+		{
+			m_requirementsFilename = m_arguments.at(++i);
+		}
+		else if(argument == "--summary-cache" && i + 1 < m_arguments.size())
+		{
+			m_summaryCacheFilename = m_arguments.at(++i);
+		}
+		else if(argument == "--touring" && i + 1 < m_arguments.size())
+		{
+			bool ok;
+			m_touring = touringModeFromText(m_arguments.at(++i), &ok);
+
+			if(!ok)
+			{
+				m_err << "unknown touring " << m_arguments.at(i) << endl;
+				return false;
+			}
+		}
+		else if(argument == "--objective" && i + 1 < m_arguments.size())
+		{
+			bool ok;
+			m_objective = objectiveFromText(m_arguments.at(++i), &ok);
+
+			if(!ok)
+			{
+				m_err << "unknown objective " << m_arguments.at(i) << endl;
+				return false;
+			}
+		}
+		else if(argument == "--optimize" && i + 1 < m_arguments.size())
+		{
+			m_optimizationTime = m_arguments.at(++i).toInt();
+		}
+		else if(argument == "--strategies" && i + 1 < m_arguments.size())
+		{
+			m_strategies.clear();
+
+			foreach(const QString &name, m_arguments.at(++i).split(',', QString::SkipEmptyParts))
+			{
+				bool ok;
+				m_strategies.append(Portfolio::strategyFromText(name.trimmed(), &ok));
+
+				if(!ok)
+				{
+					m_err << "unknown strategy " << name << endl;
+					return false;
+				}
+			}
+		}
+		else if(argument == "--log" && i + 1 < m_arguments.size())
+		{
+			m_logFilename = m_arguments.at(++i);
+		}
+		else if(argument == "--per-requirement")
+		{
+			m_perRequirement = true;
+		}
+		else if(argument == "--binary")
+		{
+			m_binary = true;
+		}
+		else if(argument == "--time-budget" && i + 1 < m_arguments.size())
+		{
+			m_timeBudget = m_arguments.at(++i).toInt();
+		}
+		else if(argument.startsWith("--"))
+		{
+			m_err << "unknown option " << argument << endl;
+			return false;
+		}
+		else if(m_graphFilename.isEmpty())
+		{
+			m_graphFilename = argument;
+		}
+		else
+		{
+			m_inputs << argument;
+		}
+	}
+
+	return !m_graphFilename.isEmpty();
+}
+
+bool CommandLine::loadModel(GraphModel &model)
+{
+	QString errorString;
+
+	if(!GraphSceneMemento::readFile(m_graphFilename, model, &errorString))
+	{
+		m_err << m_graphFilename << ": " << errorString << endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool CommandLine::loadRequirements(const QList<Node*> &nodes, QList<Path*> &requirements)
+{
+	QFile file(m_requirementsFilename);
+
+	if(!file.open(QIODevice::ReadOnly))
+	{
+		m_err << m_requirementsFilename << ": " << file.errorString() << endl;
+		return false;
+	}
+
+	QDataStream in(&file);
+	in.setVersion(QDataStream::Qt_4_0);
+
+	quint32 magic;
+	qint32 nodeCount;
+	in >> magic >> nodeCount;
+
+	if(magic != (quint32)QCR_MAGIC)
+	{
+		m_err << m_requirementsFilename << ": not exported requirements" << endl;
+		return false;
+	}
+
+	if(nodeCount != nodes.size())
+	{
+		m_err << m_requirementsFilename << ": exported for another graph" << endl;
+		return false;
+	}
+
+	CompressedPaths paths;
+
+	if(!paths.read(in))
+	{
+		m_err << m_requirementsFilename << ": file is corrupted" << endl;
+		return false;
+	}
+
+	const char *data = paths.bytes().constData();
+	const char *end = data + paths.bytes().size();
+	QVector<int> path;
+
+	// decoded in order, which is cheaper than at() for every path
+	for(int i = 0; i < paths.size(); ++i)
+	{
+		if(i % CompressedPaths::BlockSize == 0)
+			path.clear();
+
+		if(!PathCodec::decode(data, end, path))
+			break;
+
+		QList<Node*> pathNodes;
+
+		foreach(int v, path)
+		{
+			if(v < 0 || v >= nodes.size())
+				break;
+
+			pathNodes.append(nodes.at(v));
+		}
+
+		if(pathNodes.size() != path.size())
+			break;
+
+		requirements.append(new Path(pathNodes));
+	}
+
+	if(requirements.size() != paths.size())
+	{
+		m_err << m_requirementsFilename << ": file is corrupted" << endl;
+		qDeleteAll(requirements);
+		requirements.clear();
+		return false;
+	}
+
+	return true;
+}
+
+AbstractAlgorithm *CommandLine::createAlgorithm()
+{
+	if(m_criterion == "nodes")
+		return new NodesAlgorithm();
+	else if(m_criterion == "edges")
+		return new EdgesAlgorithm();
+	else if(m_criterion == "edgepair")
+		return new EdgePairAlgorithm();
+	else if(m_criterion == "simple")
+		return new SimplePathsAlgorithm();
+	else if(m_criterion == "prime")
+		return new PrimePathsAlgorithm();
+	else if(m_criterion == "alldefs")
+		return new AllDefsAlgorithm();
+	else if(m_criterion == "alluses")
+		return new AllUsesAlgorithm();
+	else if(m_criterion == "alldupaths")
+		return new AllDuPathsAlgorithm();
+	else if(m_criterion == "basis")
+		return new BasisPathsAlgorithm();
+	else if(m_criterion == "simpleroundtrip")
+		return new SimpleRoundTripAlgorithm();
+	else if(m_criterion == "completeroundtrip")
+		return new CompleteRoundTripAlgorithm();
+
+	return 0;
+}
+
+int CommandLine::exec()
+{
+	if(!parseArguments())
+	{
+		printUsage();
+		return 2;
+	}
+
+	if(m_mode == "--count-paths")
+		return runPathCount();
+
+	if(m_mode == "--export-requirements")
+		return runExport();
+
+	if(m_mode == "--program")
+		return runProgram();
+
+	if(m_mode == "--portfolio")
+		return runPortfolio();
+
+	return runTraceCoverage();
+}
+
+int CommandLine::runPathCount()
+{
+	GraphModel model;
+
+	if(!loadModel(model))
+		return 1;
+
+	QList<Node*> nodes = nodesFromModel(model);
+
+	GraphSnapshot snapshot(nodes);
+	PathNumbering numbering(snapshot);
+
+	m_out << "back edges: " << numbering.backEdges().size() << endl;
+
+	foreach(int entry, numbering.entries())
+		m_out << snapshot.node(entry)->label() << ": " << numbering.pathCount(entry) << endl;
+
+	m_out << "acyclic paths: " << numbering.pathCount();
+
+	if(numbering.hasOverflowed())
+		m_out << " (more than 2^64, saturated)";
+
+	m_out << endl;
+
+	RequirementCounter counter(nodes);
+	counter.count(m_timeBudget);
+
+	m_out << "edge pair requirements: " << counter.edgePairCount() << endl;
+
+	if(counter.isExact())
+	{
+		m_out << "simple path requirements: " << counter.simplePathCount() << endl;
+		m_out << "prime path requirements: " << counter.primePathCount() << endl;
+	}
+	else
+	{
+		m_out << "simple path requirements: " << counter.simplePathCount()
+		      << " to " << counter.upperBound() << " (time budget exceeded)" << endl;
+		m_out << "prime path requirements: " << counter.primePathCount()
+		      << " to " << counter.upperBound() << " (time budget exceeded)" << endl;
+	}
+
+	if(counter.hasOverflowed())
+		m_out << "some requirement counts are more than 2^64, saturated" << endl;
+
+	qDeleteAll(nodes);
+
+	return 0;
+}
+
+int CommandLine::runExport()
+{
+	if(m_criterion != "simple" && m_criterion != "prime")
+	{
+		m_err << "only simple and prime paths can be exported" << endl;
+		return 2;
+	}
+
+	GraphModel model;
+
+	if(!loadModel(model))
+		return 1;
+
+	QList<Node*> nodes = nodesFromModel(model);
+
+	qint64 bufferBytes = m_budget.maxBytes > 0 ? m_budget.maxBytes : PathStore::DefaultBufferBytes;
+	PathStore store(bufferBytes);
+
+	ResourceBudget budget(m_budget);
+	budget.maxBytes = 0;
+
+	SimplePathsAlgorithm simplePaths;
+	PrimePathsAlgorithm primePaths;
+	AbstractAlgorithm *algorithm = &simplePaths;
+	bool ok;
+
+	if(m_criterion == "prime")
+	{
+		algorithm = &primePaths;
+		primePaths.setBudget(budget);
+		ok = primePaths.enumerate(nodes, store);
+	}
+	else
+	{
+		simplePaths.setBudget(budget);
+		ok = simplePaths.enumerate(nodes, store);
+	}
+
+	if(algorithm->isTruncated())
+	{
+		m_err << "requirements truncated by the " << ResourceBudget::limitText(algorithm->truncation()) << endl;
+		ok = store.finish();
+	}
+
+	if(!ok)
+	{
+		m_err << "error: " << store.errorString() << endl;
+		qDeleteAll(nodes);
+		return 1;
+	}
+
+	PathStore uncovered(bufferBytes);
+	PathStore *exported = &store;
+
+	if(!m_testsFilename.isEmpty())
+	{
+		QFile testsFile(m_testsFilename);
+
+		if(!testsFile.open(QIODevice::ReadOnly | QIODevice::Text))
+		{
+			m_err << "error: " << testsFile.errorString() << endl;
+			qDeleteAll(nodes);
+			return 1;
+		}
+
+		// nodes sharing a label can't be told apart, the first one is taken
+		QHash<QString, int> nodeIndexes;
+
+		for(int i = nodes.size() - 1; i >= 0; --i)
+			nodeIndexes.insert(nodes.at(i)->label(), i);
+
+		QList<QVector<int> > walks;
+		QRegExp separators("[\\s,;]+");
+
+		while(!testsFile.atEnd())
+		{
+			QStringList labels = QString::fromUtf8(testsFile.readLine()).split(separators, QString::SkipEmptyParts);
+			QVector<int> walk;
+
+			foreach(const QString &label, labels)
+				walk.append(nodeIndexes.value(label, -1));
+
+			if(!walk.isEmpty())
+				walks.append(walk);
+		}
+
+		quint64 covered = store.countCovered(walks, &uncovered);
+
+		if(!uncovered.finish())
+		{
+			m_err << "error: " << uncovered.errorString() << endl;
+			qDeleteAll(nodes);
+			return 1;
+		}
+
+		m_err << "covered: " << covered << "/" << store.count() << endl;
+		exported = &uncovered;
+	}
+
+	QFile output;
+
+	if(m_inputs.isEmpty() || m_inputs.first() == "-")
+		ok = output.open(stdout, QIODevice::WriteOnly);
+	else
+	{
+		output.setFileName(m_inputs.first());
+		ok = output.open(QIODevice::WriteOnly | QIODevice::Truncate);
+	}
+
+	if(!ok)
+	{
+		m_err << "error: " << output.errorString() << endl;
+		qDeleteAll(nodes);
+		return 1;
+	}
+
+	if(m_binary)
+	{
+		QDataStream out(&output);
+		out.setVersion(QDataStream::Qt_4_0);
+		out << (quint32)QCR_MAGIC << (qint32)nodes.size();
+
+		// never decoded into memory as a whole, the store may have spilled
+		if(!exported->writeCompressed(out))
+		{
+			m_err << "error: " << exported->errorString() << endl;
+			qDeleteAll(nodes);
+			return 1;
+		}
+	}
+	else
+	{
+		PathStore::Reader reader(*exported);
+		QVector<int> path;
+		QTextStream out(&output);
+
+		while(reader.next(path))
+		{
+			QStringList labels;
+
+			foreach(int v, path)
+				labels << nodes.at(v)->label();
+
+			out << labels.join(" ") << "\n";
+		}
+
+		out.flush();
+	}
+
+	m_err << "exported: " << exported->count() << (store.hasSpilled() ? " (spilled to disk)" : "") << endl;
+
+	qDeleteAll(nodes);
+
+	return 0;
+}
+
+int CommandLine::runTraceCoverage()
+{
+	GraphModel model;
+
+	if(!loadModel(model))
+		return 1;
+
+	AbstractAlgorithm *algorithm = createAlgorithm();
+
+	if(algorithm == 0)
+	{
+		m_err << "unknown criterion " << m_criterion << endl;
+		printUsage();
+		return 2;
+	}
+
+	QList<Node*> nodes = nodesFromModel(model);
+	QList<Path*> loaded;
+
+	if(!m_requirementsFilename.isEmpty())
+	{
+		if(!loadRequirements(nodes, loaded))
+		{
+			delete algorithm;
+			qDeleteAll(nodes);
+			return 1;
+		}
+	}
+	else
+	{
+		algorithm->setBudget(m_budget);
+		algorithm->compute(nodes, false);
+	}
+
+	const QList<Path*> &requirements = m_requirementsFilename.isEmpty() ? algorithm->requirementsResults() : loaded;
+
+	TraceCoverage coverage(nodes, requirements, m_touring);
+
+	if(m_threads > 0)
+		QThreadPool::globalInstance()->setMaxThreadCount(m_threads);
+
+	QTime time;
+	time.start();
+
+	bool ok = true;
+
+	if(m_inputs.isEmpty() || m_inputs == QStringList("-"))
+	{
+		QFile input;
+		input.open(stdin, QIODevice::ReadOnly);
+
+		TraceCoverage::TraceResult result = coverage.analyzeDevice(&input);
+		ok = result.errorString.isEmpty();
+		coverage.addResult(result);
+	}
+	else
+	{
+		ok = coverage.analyzeFiles(m_inputs);
+	}
+
+	double seconds = qMax(time.elapsed(), 1) / 1000.0;
+
+	if(!ok)
+		m_err << "error: " << coverage.errorString() << endl;
+
+	if(m_requirementsFilename.isEmpty())
+		m_out << "criterion: " << m_criterion << endl;
+	else
+		m_out << "requirements: " << m_requirementsFilename << endl;
+
+	if(m_touring != DirectTouring)
+		m_out << "touring: " << touringModeText(m_touring) << endl;
+
+	if(algorithm->isTruncated())
+		m_out << "requirements truncated by the " << ResourceBudget::limitText(algorithm->truncation()) << endl;
+	m_out << "covered: " << coverage.coveredCount() << "/" << coverage.requirementCount() << endl;
+	m_out << "traces: " << coverage.traceCount() << ", events: " << coverage.eventCount()
+	      << " (" << coverage.unknownCount() << " unknown labels)" << endl;
+	m_out << "time: " << seconds << " s, " << qint64(coverage.eventCount() / seconds) << " events/s" << endl;
+
+	for(int i = 0; i < requirements.size(); ++i)
+		m_out << (coverage.isCovered(i) ? "+ " : "- ") << requirements.at(i)->toText() << endl;
+
+	delete algorithm;
+	qDeleteAll(loaded);
+	qDeleteAll(nodes);
+
+	return ok ? 0 : 1;
+}
+
+int CommandLine::runProgram()
+{
+	AbstractAlgorithm *algorithm = createAlgorithm();
+
+	if(algorithm == 0)
+	{
+		m_err << "unknown criterion " << m_criterion << endl;
+		printUsage();
+		return 2;
+	}
+
+	algorithm->setBudget(m_budget);
+	algorithm->setTouring(m_touring);
+	algorithm->setObjective(m_objective);
+	algorithm->setOptimizationTime(m_optimizationTime);
+	algorithm->setOnePathPerRequirement(m_perRequirement);
+
+	// summaries of another touring or objective have other test paths, optimized ones better
+	FunctionSummaries summaries(algorithm, m_criterion + "/" + touringModeText(m_touring)
+				    + "/" + objectiveText(m_objective)
+				    + (m_perRequirement ? "/perrequirement" : m_optimizationTime > 0 ? "/optimized" : ""));
+
+	if(!m_summaryCacheFilename.isEmpty())
+	{
+		QFile file(m_summaryCacheFilename);
+
+		if(file.open(QIODevice::ReadOnly))
+		{
+			QDataStream in(&file);
+			in.setVersion(QDataStream::Qt_4_0);
+
+			// a stale or foreign cache only means computing everything
+			if(!summaries.load(in))
+				m_err << m_summaryCacheFilename << ": summaries not used" << endl;
+		}
+	}
+
+	QStringList functions = summaries.functions(m_graphFilename);
+	int computed = 0;
+	bool ok = true;
+
+	m_out << "criterion: " << m_criterion << endl;
+
+	foreach(const QString &function, functions)
+	{
+		FunctionSummaries::Summary summary = summaries.summary(function);
+
+		m_out << "function: " << function;
+
+		if(!summary.errorString.isEmpty())
+		{
+			m_out << " (" << summary.errorString << ")" << endl;
+			ok = false;
+			continue;
+		}
+
+		if(summaries.wasComputed(function))
+			computed++;
+
+		m_out << (summaries.wasComputed(function) ? " (computed)" : " (cached)") << endl;
+		m_out << "  requirements: " << summary.requirements.size() << ", test paths: " << summary.testPaths.size()
+		      << (summary.truncated ? " (truncated)" : "") << endl;
+	}
+
+	m_out << "computed: " << computed << "/" << functions.size() << endl;
+	m_out << "program test paths:" << endl;
+
+	foreach(const QStringList &path, summaries.programTestPaths(m_graphFilename))
+		m_out << path.join(" ") << endl;
+
+	if(!m_summaryCacheFilename.isEmpty())
+	{
+		QFile file(m_summaryCacheFilename);
+
+		if(file.open(QIODevice::WriteOnly))
+		{
+			QDataStream out(&file);
+			out.setVersion(QDataStream::Qt_4_0);
+			summaries.save(out);
+		}
+		else
+		{
+			m_err << m_summaryCacheFilename << ": " << file.errorString() << endl;
+		}
+	}
+
+	delete algorithm;
+
+	return ok ? 0 : 1;
+}
+
+int CommandLine::runPortfolio()
+{
+	GraphModel model;
+
+	if(!loadModel(model))
+		return 1;
+
+	AbstractAlgorithm *algorithm = createAlgorithm();
+
+	if(algorithm == 0)
+	{
+		m_err << "unknown criterion " << m_criterion << endl;
+		printUsage();
+		return 2;
+	}
+
+	if(m_threads > 0)
+		QThreadPool::globalInstance()->setMaxThreadCount(m_threads);
+
+	QList<Node*> nodes = nodesFromModel(model);
+	PathConstraints constraints = constraintsFromModel(model, nodes);
+
+	QTime time;
+	time.start();
+
+	algorithm->setBudget(m_budget);
+	algorithm->setConstraints(constraints);
+	algorithm->compute(nodes, false);
+
+	// what finding the requirements took is gone from the deadline
+	ResourceBudget budget(m_budget);
+
+	if(budget.timeLimit > 0)
+		budget.timeLimit = qMax(budget.timeLimit - time.elapsed(), 1);
+
+	Portfolio portfolio(nodes, algorithm->requirementsResults());
+
+	portfolio.setStrategies(m_strategies);
+	portfolio.setBudget(budget);
+	portfolio.setTouring(m_touring);
+	portfolio.setObjective(m_objective);
+	portfolio.setConstraints(constraints);
+
+	if(m_optimizationTime > 0)
+		portfolio.setSearchTime(m_optimizationTime);
+
+	portfolio.run();
+
+	m_out << "criterion: " << m_criterion << endl;
+
+	if(algorithm->isTruncated())
+		m_out << "requirements truncated by the " << ResourceBudget::limitText(algorithm->truncation()) << endl;
+
+	m_out << "requirements: " << algorithm->requirementsResults().size()
+	      << ", lower bound: " << portfolio.lowerBound() << endl;
+
+	foreach(const Portfolio::Entry &entry, portfolio.entries())
+	{
+		m_out << Portfolio::strategyText(entry.strategy) << ": ";
+
+		if(entry.skipped && !entry.cancelled)
+		{
+			m_out << "skipped" << endl;
+			continue;
+		}
+
+		m_out << entry.pathCount << " test paths, length " << entry.length << ", cost " << entry.cost
+		      << ", " << entry.elapsed << " ms";
+
+		if(entry.cancelled)
+			m_out << " (cancelled)";
+		else if(entry.truncation != ResourceBudget::NoLimit)
+			m_out << " (stopped by the " << ResourceBudget::limitText(entry.truncation) << ")";
+
+		if(entry.constraintsIgnored)
+			m_out << " (constraints not enforced)";
+
+		m_out << endl;
+	}
+
+	bool ok = portfolio.winner() != -1;
+
+	if(ok)
+	{
+		m_out << "winner: " << Portfolio::strategyText(portfolio.entries().at(portfolio.winner()).strategy) << endl;
+
+		foreach(Path *path, portfolio.coverageResults())
+			m_out << path->toText() << endl;
+	}
+	else
+	{
+		m_out << "winner: none" << endl;
+	}
+
+	if(!m_logFilename.isEmpty() && !portfolio.appendRecord(m_logFilename, m_graphFilename, m_criterion))
+		m_err << m_logFilename << ": not written" << endl;
+
+	delete algorithm;
+	qDeleteAll(nodes);
+
+	return ok ? 0 : 1;
+}
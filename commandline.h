@@ -0,0 +1,87 @@
+#ifndef COMMANDLINE_H
+#define COMMANDLINE_H
+
+#include <QStringList>
+#include <QString>
+#include <QTextStream>
+
+#include "graphmodel.h"
+#include "abstractalgorithm.h"
+#include "portfolio.h"
+
+/* Batch modes which run without the main window, e.g.
+
+     qcoverage --trace graph.qcv [--criterion prime] [--threads N]
+               [--max-requirements N] [--max-memory MB] [--time-limit MS]
+               [--requirements FILE] [--touring direct|sidetrips|detours] [trace...]
+     qcoverage --count-paths graph.qcv [--time-budget MS]
+     qcoverage --export-requirements graph.qcv [--criterion simple|prime]
+               [--max-memory MB] [--time-limit MS] [--tests FILE] [--binary] [output]
+     qcoverage --program main.qcv [--criterion prime] [--objective fewest|cost]
+               [--optimize MS] [--per-requirement] [--summary-cache FILE]
+     qcoverage --portfolio graph.qcv [--criterion prime] [--time-limit MS]
+               [--strategies merge,cost,search,shortest] [--optimize MS] [--log FILE]
+
+   Traces are read from stdin when no files are given. Exported simple and
+   prime paths go through a PathStore, --max-memory is its buffer, and are
+   written one per line as labels; with --tests only those not toured by
+   the given test paths are. --binary writes them front coded by PathCodec
+   instead, such a file is given to --trace with --requirements. A trace
+   covers a requirement as --touring says, directly by default. --program
+   follows the called functions of the graph through FunctionSummaries,
+   summaries kept in --summary-cache are reused while their file is
+   unchanged. --objective cost makes the test paths cheapest in their total
+   edge cost instead of fewest, --optimize gives every function that long
+   to improve its test paths by local search, --per-requirement gives
+   every requirement a shortest test path of its own. --portfolio races the
+   strategies of Portfolio for the test paths within --time-limit, the
+   search strategy gets --optimize if given, and appends how they did to
+   the --log file.
+*/
+class CommandLine
+{
+	public:
+		CommandLine(const QStringList &arguments);
+
+		static bool isRequested(int argc, char **argv);
+
+		int exec();
+
+	private:
+		QStringList m_arguments;
+		QString m_mode;
+		QTextStream m_out;
+		QTextStream m_err;
+
+		QString m_graphFilename;
+		QString m_criterion;
+		QStringList m_inputs;
+		int m_threads;
+		int m_timeBudget;
+		Algorithm::ResourceBudget m_budget;
+		QString m_testsFilename;
+		QString m_requirementsFilename;
+		QString m_summaryCacheFilename;
+		bool m_binary;
+		Algorithm::TouringMode m_touring;
+		Algorithm::Objective m_objective;
+		int m_optimizationTime;
+		bool m_perRequirement;
+		QList<Algorithm::Portfolio::Strategy> m_strategies;
+		QString m_logFilename;
+
+		bool parseArguments();
+		void printUsage();
+
+		bool loadModel(GraphModel &model);
+		bool loadRequirements(const QList<Algorithm::Node*> &nodes, QList<Algorithm::Path*> &requirements);
+		Algorithm::AbstractAlgorithm *createAlgorithm();
+
+		int runTraceCoverage();
+		int runPathCount();
+		int runExport();
+		int runProgram();
+		int runPortfolio();
+};
+
+#endif // COMMANDLINE_H
@@ -0,0 +1,50 @@
+#include "completeroundtripalgorithm.h"
+
+#include <QVector>
+#include <QPair>
+
+#include "graphsnapshot.h"
+#include "strongcomponents.h"
+#include "simplecycles.h"
+
+using namespace Algorithm;
+
+void CompleteRoundTripAlgorithm::onCompute()
+{
+	GraphSnapshot snapshot(nodes());
+	StrongComponents components(snapshot);
+
+	SimpleCycles cycles(snapshot, components);
+	cycles.compute(budget(), elapsed());
+
+	// the cycles found are still round trips
+	if(cycles.truncation() != ResourceBudget::NoLimit)
+		truncate(cycles.truncation());
+
+	// positions on the cycles of every node
+	QVector<QList<QPair<int, int> > > occurrences(snapshot.nodeCount());
+
+	for(int c = 0; c < cycles.cycles().size(); ++c)
+	{
+		const QVector<int> &cycle = cycles.cycles().at(c);
+
+		for(int i = 0; i < cycle.size() - 1; ++i)
+			occurrences[cycle.at(i)].append(qMakePair(c, i));
+	}
+
+	for(int v = 0; v < snapshot.nodeCount(); ++v)
+	{
+		foreach(const QPair<int, int> &occurrence, occurrences.at(v))
+		{
+			if(isOverSizeBudget())
+				return;
+
+			QList<Node*> pathNodes;
+
+			foreach(int u, SimpleCycles::rotated(cycles.cycles().at(occurrence.first), occurrence.second))
+				pathNodes.append(snapshot.node(u));
+
+			addReqResult(new Path(pathNodes));
+		}
+	}
+}
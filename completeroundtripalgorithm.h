@@ -0,0 +1,19 @@
+#ifndef COMPLETEROUNDTRIPALGORITHM_H
+#define COMPLETEROUNDTRIPALGORITHM_H
+
+#include "abstractalgorithm.h"
+
+namespace Algorithm
+{
+	/* Every round trip path of every node: each simple cycle found by
+	   SimpleCycles once for every node on it, starting and ending there.
+	   They are grouped by node in the order of the nodes.
+	*/
+	class CompleteRoundTripAlgorithm : public AbstractAlgorithm
+	{
+		protected:
+			void onCompute();
+	};
+}
+
+#endif // COMPLETEROUNDTRIPALGORITHM_H
@@ -0,0 +1,144 @@
+#include "componentpaths.h"
+
+#include <QFuture>
+#include <QtConcurrentRun>
+
+using namespace Algorithm;
+
+ComponentPaths::ComponentPaths(const GraphSnapshot &snapshot, const StrongComponents &components)
+	: m_snapshot(snapshot), m_components(components), m_timeLimit(0), m_maxNodes(0),
+	  m_storedNodes(0), m_stop(ResourceBudget::NoLimit), m_truncation(ResourceBudget::NoLimit)
+{
+}
+
+void ComponentPaths::compute(const ResourceBudget &budget, int elapsed)
+{
+	int nodeCount = m_snapshot.nodeCount();
+
+	m_paths.fill(QList<QVector<int> >(), nodeCount);
+	m_cycles.fill(QList<QVector<int> >(), nodeCount);
+
+	// a time limit already used up still has to stop the walks
+	m_timeLimit = budget.timeLimit > 0 ? qMax(budget.timeLimit - elapsed, 1) : 0;
+	m_maxNodes = budget.maxBytes > 0 ? (int)qMin(budget.maxBytes / (qint64)sizeof(int), (qint64)0x7FFFFFFF) : 0;
+	m_storedNodes = 0;
+	m_stop = ResourceBudget::NoLimit;
+	m_timer.start();
+
+	QList<int> walked;
+	QList<QFuture<ComponentResult> > futures;
+
+	for(int c = 0; c < m_components.componentCount(); ++c)
+	{
+		// a lone node without a loop has nothing to walk
+		if(!m_components.isCyclic(c))
+		{
+			int v = m_components.member(m_components.memberBegin(c));
+			m_paths[v].append(QVector<int>(1, v));
+			continue;
+		}
+
+		walked.append(c);
+		futures.append(QtConcurrent::run(this, &ComponentPaths::walkComponent, c));
+	}
+
+	for(int i = 0; i < futures.size(); ++i)
+	{
+		ComponentResult result = futures[i].result();
+		int c = walked.at(i);
+
+		for(int k = 0; k < m_components.size(c); ++k)
+		{
+			int v = m_components.member(m_components.memberBegin(c) + k);
+
+			m_paths[v] = result.paths.at(k);
+			m_cycles[v] = result.cycles.at(k);
+		}
+	}
+
+	m_truncation = (ResourceBudget::Limit)(int)m_stop;
+}
+
+bool ComponentPaths::shouldStop(int &pendingNodes)
+{
+	if(m_stop != ResourceBudget::NoLimit)
+		return true;
+
+	// the shared counter is only touched once in a while
+	if(pendingNodes < 4096)
+		return false;
+
+	int stored = m_storedNodes.fetchAndAddRelaxed(pendingNodes) + pendingNodes;
+	pendingNodes = 0;
+
+	if(m_maxNodes > 0 && stored >= m_maxNodes)
+		m_stop.testAndSetRelaxed(ResourceBudget::NoLimit, ResourceBudget::MemoryLimit);
+	else if(m_timeLimit > 0 && m_timer.elapsed() > m_timeLimit)
+		m_stop.testAndSetRelaxed(ResourceBudget::NoLimit, ResourceBudget::TimeLimit);
+
+	return m_stop != ResourceBudget::NoLimit;
+}
+
+ComponentPaths::ComponentResult ComponentPaths::walkComponent(int c)
+{
+	ComponentResult result;
+
+	int pendingNodes = 0;
+
+	QVector<bool> onPath(m_snapshot.nodeCount(), false);
+	QVector<int> path;
+	QVector<int> nextEdge;
+
+	for(int k = 0; k < m_components.size(c); ++k)
+	{
+		int start = m_components.member(m_components.memberBegin(c) + k);
+
+		result.paths.append(QList<QVector<int> >());
+		result.cycles.append(QList<QVector<int> >());
+
+		QList<QVector<int> > &paths = result.paths.last();
+		QList<QVector<int> > &cycles = result.cycles.last();
+
+		path.append(start);
+		nextEdge.append(m_snapshot.edgeBegin(start));
+		onPath[start] = true;
+		paths.append(path);
+
+		while(!path.isEmpty())
+		{
+			int v = path.last();
+
+			if(nextEdge.last() == m_snapshot.edgeEnd(v) || shouldStop(pendingNodes))
+			{
+				onPath[v] = false;
+				path.pop_back();
+				nextEdge.pop_back();
+				continue;
+			}
+
+			int target = m_snapshot.edgeTarget(nextEdge.last()++);
+
+			if(target == start)
+			{
+				path.append(target);
+				cycles.append(path);
+				path.pop_back();
+
+				pendingNodes += path.size() + 1;
+				continue;
+			}
+
+			if(onPath.at(target) || m_components.component(target) != c)
+				continue;
+
+			onPath[target] = true;
+			path.append(target);
+			nextEdge.append(m_snapshot.edgeBegin(target));
+			paths.append(path);
+
+			pendingNodes += path.size();
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,63 @@
+#ifndef COMPONENTPATHS_H
+#define COMPONENTPATHS_H
+
+#include <QList>
+#include <QVector>
+#include <QTime>
+#include <QAtomicInt>
+
+#include "graphsnapshot.h"
+#include "strongcomponents.h"
+#include "resourcebudget.h"
+
+namespace Algorithm
+{
+	/* Summary of every strong component: the simple paths which stay
+	   inside it from each of its nodes and the cycles back to the node.
+	   A simple path of the whole graph is a chain of such paths joined by
+	   edges between components, and a cycle never leaves its component.
+	   Components don't depend on each other and are walked in parallel.
+	*/
+	class ComponentPaths
+	{
+		public:
+			ComponentPaths(const GraphSnapshot &snapshot, const StrongComponents &components);
+
+			/* elapsed is the time the budget has already spent, the walk
+			   stops and keeps what it has when a limit is hit. */
+			void compute(const ResourceBudget &budget, int elapsed);
+
+			ResourceBudget::Limit truncation() const { return m_truncation; }
+
+			// paths start with v, the first one is v alone
+			const QList<QVector<int> > &pathsFrom(int v) const { return m_paths.at(v); }
+			const QList<QVector<int> > &cyclesFrom(int v) const { return m_cycles.at(v); }
+
+		private:
+			typedef struct
+			{
+				QList<QList<QVector<int> > > paths;
+				QList<QList<QVector<int> > > cycles;
+			} ComponentResult;
+
+			const GraphSnapshot &m_snapshot;
+			const StrongComponents &m_components;
+
+			QVector<QList<QVector<int> > > m_paths;
+			QVector<QList<QVector<int> > > m_cycles;
+
+			QTime m_timer;
+			int m_timeLimit;
+			int m_maxNodes;
+
+			// nodes stored by all the walks, the limit that stopped them
+			QAtomicInt m_storedNodes;
+			QAtomicInt m_stop;
+			ResourceBudget::Limit m_truncation;
+
+			ComponentResult walkComponent(int c);
+			bool shouldStop(int &pendingNodes);
+	};
+}
+
+#endif // COMPONENTPATHS_H
@@ -0,0 +1,346 @@
+#include "constraintproduct.h"
+
+#include <QHash>
+#include <QPair>
+#include <QDebug>
+
+using namespace Algorithm;
+
+namespace
+{
+	// node, automaton state, mask id
+	typedef QPair<int, QPair<int, int> > StateKey;
+}
+
+ConstraintProduct::ConstraintProduct(const GraphSnapshot &snapshot, const PathConstraints &constraints)
+	: m_snapshot(snapshot), m_hasForbiddenPaths(!constraints.forbiddenPaths().isEmpty()),
+	  m_edgeSides(snapshot.edgeCount()), m_maskBytes(0)
+{
+	QList<QVector<int> > forbidden;
+
+	foreach(const QList<Node*> &path, constraints.forbiddenPaths())
+	{
+		QVector<int> sequence;
+
+		foreach(Node *node, path)
+			sequence.append(snapshot.indexOf(node));
+
+		if(!sequence.contains(-1))
+			forbidden.append(sequence);
+	}
+
+	if(m_hasForbiddenPaths)
+		m_automaton.build(forbidden, snapshot.nodeCount());
+
+	int pair = 0;
+
+	foreach(const QList<Node*> &edges, constraints.exclusiveEdges())
+	{
+		int first = snapshot.findEdge(snapshot.indexOf(edges.at(0)), snapshot.indexOf(edges.at(1)));
+		int second = snapshot.findEdge(snapshot.indexOf(edges.at(2)), snapshot.indexOf(edges.at(3)));
+
+		if(first == -1 || second == -1)
+			continue;
+
+		m_edgeSides[first].append(pair * 2);
+		m_edgeSides[second].append(pair * 2 + 1);
+		pair++;
+	}
+
+	m_maskBytes = (pair * 2 + 7) / 8;
+
+	findLiveSides(pair);
+}
+
+void ConstraintProduct::findLiveSides(int pairCount)
+{
+	int n = m_snapshot.nodeCount();
+
+	m_liveSides.fill(QByteArray(m_maskBytes, 0), n);
+
+	QVector<int> sources(pairCount * 2, -1);
+
+	for(int e = 0; e < m_snapshot.edgeCount(); ++e)
+		foreach(int side, m_edgeSides.at(e))
+			sources[side] = m_snapshot.edgeSource(e);
+
+	// backwards from the sources of both edges of every pair
+	QVector<int> visited(n, -1);
+	QVector<int> queue;
+
+	for(int pair = 0; pair < pairCount; ++pair)
+	{
+		queue.clear();
+
+		for(int side = pair * 2; side < pair * 2 + 2; ++side)
+		{
+			if(visited.at(sources.at(side)) != pair)
+			{
+				visited[sources.at(side)] = pair;
+				queue.append(sources.at(side));
+			}
+		}
+
+		for(int i = 0; i < queue.size(); ++i)
+		{
+			int v = queue.at(i);
+
+			for(int side = pair * 2; side < pair * 2 + 2; ++side)
+				m_liveSides[v][side / 8] = m_liveSides[v].at(side / 8) | (1 << (side % 8));
+
+			for(int k = m_snapshot.inEdgeBegin(v); k < m_snapshot.inEdgeEnd(v); ++k)
+			{
+				int previous = m_snapshot.edgeSource(m_snapshot.inEdge(k));
+
+				if(visited.at(previous) != pair)
+				{
+					visited[previous] = pair;
+					queue.append(previous);
+				}
+			}
+		}
+	}
+}
+
+bool ConstraintProduct::build(int maxStates)
+{
+	int n = m_snapshot.nodeCount();
+
+	if(maxStates <= 0 || maxStates > MaxStates)
+		maxStates = MaxStates;
+
+	QHash<StateKey, int> stateIds;
+	QHash<QByteArray, int> maskIds;
+
+	m_masks.clear();
+	m_masks.append(QByteArray(m_maskBytes, 0));
+	maskIds.insert(m_masks.first(), 0);
+
+	m_stateNodes.clear();
+	m_parents.clear();
+	m_depths.clear();
+	m_nextOffsets.clear();
+	m_next.clear();
+	m_nodeStates.fill(QVector<int>(), n);
+
+	QVector<int> automatonStates;
+	QVector<int> maskStates;
+
+	for(int v = 0; v < n; ++v)
+	{
+		if(!m_snapshot.isStart(v))
+			continue;
+
+		int automatonState = m_hasForbiddenPaths ? m_automaton.step(0, v) : 0;
+
+		if(m_hasForbiddenPaths && m_automaton.hasMatch(automatonState))
+			continue;
+
+		stateIds.insert(qMakePair(v, qMakePair(automatonState, 0)), m_stateNodes.size());
+		m_stateNodes.append(v);
+		m_parents.append(-1);
+		m_depths.append(0);
+		automatonStates.append(automatonState);
+		maskStates.append(0);
+	}
+
+	// breadth first, so the parents give the shortest way from a start
+	for(int s = 0; s < m_stateNodes.size(); ++s)
+	{
+		if(m_stateNodes.size() > maxStates)
+		{
+#ifdef DEBUG
+			qWarning() << "ConstraintProduct: more than" << maxStates << "states";
+#endif
+			return false;
+		}
+
+		int v = m_stateNodes.at(s);
+		m_nodeStates[v].append(s);
+		m_nextOffsets.append(m_next.size());
+
+		for(int e = m_snapshot.edgeBegin(v); e < m_snapshot.edgeEnd(v); ++e)
+		{
+			int target = m_snapshot.edgeTarget(e);
+			int automatonState = m_hasForbiddenPaths ? m_automaton.step(automatonStates.at(s), target) : 0;
+			int maskState = maskStates.at(s);
+
+			if(m_hasForbiddenPaths && m_automaton.hasMatch(automatonState))
+			{
+				m_next.append(-1);
+				continue;
+			}
+
+			// the empty set stays empty over an edge of no pair
+			if(maskState != 0 || !m_edgeSides.at(e).isEmpty())
+			{
+				QByteArray mask = m_masks.at(maskState);
+				bool excluded = false;
+
+				foreach(int side, m_edgeSides.at(e))
+				{
+					int other = side ^ 1;
+					excluded = excluded || ((mask.at(other / 8) >> (other % 8)) & 1);
+					mask[side / 8] = mask.at(side / 8) | (1 << (side % 8));
+				}
+
+				if(excluded)
+				{
+					m_next.append(-1);
+					continue;
+				}
+
+				// the sides of pairs which can't be taken any more make no difference
+				for(int i = 0; i < m_maskBytes; ++i)
+					mask[i] = mask.at(i) & m_liveSides.at(target).at(i);
+
+				maskState = maskIds.value(mask, -1);
+
+				if(maskState == -1)
+				{
+					maskState = m_masks.size();
+					maskIds.insert(mask, maskState);
+					m_masks.append(mask);
+				}
+			}
+
+			StateKey key = qMakePair(target, qMakePair(automatonState, maskState));
+			QHash<StateKey, int>::const_iterator it = stateIds.constFind(key);
+
+			if(it != stateIds.constEnd())
+			{
+				m_next.append(it.value());
+				continue;
+			}
+
+			int next = m_stateNodes.size();
+
+			stateIds.insert(key, next);
+			m_stateNodes.append(target);
+			m_parents.append(s);
+			m_depths.append(m_depths.at(s) + 1);
+			automatonStates.append(automatonState);
+			maskStates.append(maskState);
+
+			m_next.append(next);
+		}
+	}
+
+	m_nextOffsets.append(m_next.size());
+
+	findEndDistances();
+
+	return true;
+}
+
+void ConstraintProduct::findEndDistances()
+{
+	int stateCount = m_stateNodes.size();
+
+	// predecessors, by counting sort on the successor
+	QVector<int> offsets(stateCount + 1, 0);
+
+	foreach(int next, m_next)
+		if(next != -1)
+			offsets[next + 1]++;
+
+	for(int s = 0; s < stateCount; ++s)
+		offsets[s + 1] += offsets[s];
+
+	QVector<int> predecessors(offsets.last());
+	QVector<int> fill(offsets);
+
+	for(int s = 0; s < stateCount; ++s)
+		for(int i = m_nextOffsets.at(s); i < m_nextOffsets.at(s + 1); ++i)
+			if(m_next.at(i) != -1)
+				predecessors[fill[m_next.at(i)]++] = s;
+
+	m_endDistances.fill(-1, stateCount);
+	m_towardsEnd.fill(-1, stateCount);
+
+	QVector<int> queue;
+
+	for(int s = 0; s < stateCount; ++s)
+	{
+		if(m_snapshot.isEnd(m_stateNodes.at(s)))
+		{
+			m_endDistances[s] = 0;
+			queue.append(s);
+		}
+	}
+
+	for(int i = 0; i < queue.size(); ++i)
+	{
+		int s = queue.at(i);
+
+		for(int k = offsets.at(s); k < offsets.at(s + 1); ++k)
+		{
+			int previous = predecessors.at(k);
+
+			if(m_endDistances.at(previous) != -1)
+				continue;
+
+			m_endDistances[previous] = m_endDistances.at(s) + 1;
+			m_towardsEnd[previous] = s;
+			queue.append(previous);
+		}
+	}
+}
+
+QVector<int> ConstraintProduct::testPath(const QVector<int> &requirement) const
+{
+	if(requirement.isEmpty())
+		return QVector<int>();
+
+	// offsets of the requirement's edges among those leaving their source
+	QVector<int> edgeOffsets;
+
+	for(int i = 1; i < requirement.size(); ++i)
+	{
+		int e = m_snapshot.findEdge(requirement.at(i - 1), requirement.at(i));
+
+		if(e == -1)
+			return QVector<int>();
+
+		edgeOffsets.append(e - m_snapshot.edgeBegin(requirement.at(i - 1)));
+	}
+
+	int bestStart = -1;
+	int bestEnd = -1;
+	int bestLength = 0;
+
+	foreach(int s, m_nodeStates.at(requirement.first()))
+	{
+		int state = s;
+
+		for(int i = 0; i < edgeOffsets.size() && state != -1; ++i)
+			state = m_next.at(m_nextOffsets.at(state) + edgeOffsets.at(i));
+
+		if(state == -1 || m_endDistances.at(state) == -1)
+			continue;
+
+		int length = m_depths.at(s) + m_endDistances.at(state);
+
+		if(bestStart == -1 || length < bestLength)
+		{
+			bestStart = s;
+			bestEnd = state;
+			bestLength = length;
+		}
+	}
+
+	QVector<int> path;
+
+	if(bestStart == -1)
+		return path;
+
+	for(int s = m_parents.at(bestStart); s != -1; s = m_parents.at(s))
+		path.prepend(m_stateNodes.at(s));
+
+	path += requirement;
+
+	for(int s = m_towardsEnd.at(bestEnd); s != -1; s = m_towardsEnd.at(s))
+		path.append(m_stateNodes.at(s));
+
+	return path;
+}
@@ -0,0 +1,80 @@
+#ifndef CONSTRAINTPRODUCT_H
+#define CONSTRAINTPRODUCT_H
+
+#include <QList>
+#include <QVector>
+#include <QByteArray>
+
+#include "graphsnapshot.h"
+#include "pathconstraints.h"
+#include "requirementautomaton.h"
+
+namespace Algorithm
+{
+	/* Product of the graph with an automaton of its constraints. A state
+	   is a node, the Aho-Corasick state over the forbidden paths and the
+	   set of exclusive edges taken so far; states which completed a
+	   forbidden path or took both edges of a pair are left out. Every walk
+	   through the product from a start state is a feasible path prefix, so
+	   the shortest feasible test path touring a requirement is the shortest
+	   way to a state at its first node, the requirement itself and the
+	   shortest way on to an end state. Everything is searched once for all
+	   the requirements, an infeasible one costs a walk per state at its
+	   first node.
+
+	   A pair is dropped from the set once neither of its edges can be
+	   reached any more, still the sets can grow with the pairs, so the
+	   product is never built beyond MaxStates.
+	*/
+	class ConstraintProduct
+	{
+		public:
+			ConstraintProduct(const GraphSnapshot &snapshot, const PathConstraints &constraints);
+
+			// false when there are more than maxStates states, zero is MaxStates
+			bool build(int maxStates = 0);
+
+			int stateCount() const { return m_stateNodes.size(); }
+
+			// node indexes, empty when the constraints allow no test path touring it
+			QVector<int> testPath(const QVector<int> &requirement) const;
+
+			// rough heap size of a state, to turn a memory budget into maxStates
+			static const int StateBytes = 64;
+
+			// even without a memory budget
+			static const int MaxStates = 1 << 20;
+
+		private:
+			const GraphSnapshot &m_snapshot;
+
+			bool m_hasForbiddenPaths;
+			RequirementAutomaton m_automaton;
+
+			// per edge the exclusive pair sides it is, pair * 2 + side
+			QVector<QList<int> > m_edgeSides;
+			int m_maskBytes;
+			QList<QByteArray> m_masks;
+
+			// per node the sides of the pairs with an edge still reachable from it
+			QVector<QByteArray> m_liveSides;
+
+			QVector<int> m_stateNodes;
+			QVector<int> m_parents;
+			QVector<int> m_depths;
+
+			// successor over every outgoing edge of the node, -1 when infeasible
+			QVector<int> m_nextOffsets;
+			QVector<int> m_next;
+
+			// states at every node, and how far each one is from an end state
+			QVector<QVector<int> > m_nodeStates;
+			QVector<int> m_endDistances;
+			QVector<int> m_towardsEnd;
+
+			void findLiveSides(int pairCount);
+			void findEndDistances();
+	};
+}
+
+#endif // CONSTRAINTPRODUCT_H
@@ -0,0 +1,68 @@
+#include "costdistances.h"
+
+#include <queue>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <limits>
+
+using namespace Algorithm;
+
+const double CostDistances::Unreachable = std::numeric_limits<double>::infinity();
+
+CostDistances::CostDistances(const GraphSnapshot &snapshot)
+	: m_snapshot(snapshot)
+{
+	run(m_fromStart, m_previous, false);
+	run(m_toEnd, m_next, true);
+}
+
+void CostDistances::run(QVector<double> &distances, QVector<int> &parents, bool reverse)
+{
+	int nodeCount = m_snapshot.nodeCount();
+
+	distances.fill(Unreachable, nodeCount);
+	parents.fill(-1, nodeCount);
+
+	// (distance, node), the smallest on top; stale entries are skipped
+	typedef std::pair<double, int> Entry;
+	std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > heap;
+
+	for(int v = 0; v < nodeCount; ++v)
+	{
+		if(reverse ? m_snapshot.isEnd(v) : m_snapshot.isStart(v))
+		{
+			distances[v] = 0;
+			heap.push(std::make_pair(0.0, v));
+		}
+	}
+
+	while(!heap.empty())
+	{
+		Entry top = heap.top();
+		heap.pop();
+
+		int v = top.second;
+
+		if(top.first > distances.at(v))
+			continue;
+
+		int begin = reverse ? m_snapshot.inEdgeBegin(v) : m_snapshot.edgeBegin(v);
+		int end = reverse ? m_snapshot.inEdgeEnd(v) : m_snapshot.edgeEnd(v);
+
+		for(int i = begin; i < end; ++i)
+		{
+			int e = reverse ? m_snapshot.inEdge(i) : i;
+			int next = reverse ? m_snapshot.edgeSource(e) : m_snapshot.edgeTarget(e);
+			double distance = top.first + qMax(m_snapshot.edgeCost(e), 0.0);
+
+			// a settled node never improves, so parents are settled before
+			if(distance < distances.at(next))
+			{
+				distances[next] = distance;
+				parents[next] = v;
+				heap.push(std::make_pair(distance, next));
+			}
+		}
+	}
+}
@@ -0,0 +1,46 @@
+#ifndef COSTDISTANCES_H
+#define COSTDISTANCES_H
+
+#include <QVector>
+
+#include "graphsnapshot.h"
+
+namespace Algorithm
+{
+	/* Cheapest costs from the start nodes to every node of the snapshot and
+	   from every node to an end node, by Dijkstra with a binary heap over
+	   the edge costs. Negative costs count as nothing. The cheapest ways
+	   are kept as trees, which have no cycles even over edges costing 0.
+	*/
+	class CostDistances
+	{
+		public:
+			CostDistances(const GraphSnapshot &snapshot);
+
+			// Unreachable when no start node leads to the node
+			double fromStart(int v) const { return m_fromStart.at(v); }
+
+			// Unreachable when the node leads to no end node
+			double toEnd(int v) const { return m_toEnd.at(v); }
+
+			// the node before on a cheapest way from a start node, -1 for none
+			int previousFromStart(int v) const { return m_previous.at(v); }
+
+			// the node after on a cheapest way to an end node, -1 for none
+			int nextToEnd(int v) const { return m_next.at(v); }
+
+			static const double Unreachable;
+
+		private:
+			const GraphSnapshot &m_snapshot;
+
+			QVector<double> m_fromStart;
+			QVector<double> m_toEnd;
+			QVector<int> m_previous;
+			QVector<int> m_next;
+
+			void run(QVector<double> &distances, QVector<int> &parents, bool reverse);
+	};
+}
+
+#endif // COSTDISTANCES_H
@@ -0,0 +1,327 @@
+#include "dataflowalgorithm.h"
+
+#include <QDebug>
+
+using namespace Algorithm;
+
+DataFlowAlgorithm::DataFlowAlgorithm()
+	: m_snapshot(0), m_words(0)
+{
+}
+
+DataFlowAlgorithm::~DataFlowAlgorithm()
+{
+	releaseAnalysis();
+}
+
+int DataFlowAlgorithm::variableIndex(const QString &name)
+{
+	QHash<QString, int>::const_iterator it = m_variables.constFind(name);
+
+	if(it != m_variables.constEnd())
+		return it.value();
+
+	int index = m_variables.size();
+	m_variables.insert(name, index);
+
+	return index;
+}
+
+void DataFlowAlgorithm::releaseAnalysis()
+{
+	delete m_snapshot;
+	m_snapshot = 0;
+
+	m_variables.clear();
+	m_definitions.clear();
+	m_nodeDefs.clear();
+	m_nodeUses.clear();
+	m_in.clear();
+	m_words = 0;
+	m_addedPaths.clear();
+}
+
+void DataFlowAlgorithm::analyze()
+{
+	releaseAnalysis();
+
+	m_snapshot = new GraphSnapshot(nodes());
+
+	int nodeCount = m_snapshot->nodeCount();
+
+	m_nodeDefs.resize(nodeCount);
+	m_nodeUses.resize(nodeCount);
+
+	// definitions of a node get consecutive indexes
+	QVector<int> firstDef(nodeCount + 1);
+
+	for(int v = 0; v < nodeCount; ++v)
+	{
+		Node *node = m_snapshot->node(v);
+		firstDef[v] = m_definitions.size();
+
+		foreach(const QString &name, node->defs())
+		{
+			int variable = variableIndex(name.trimmed());
+
+			if(m_nodeDefs.at(v).contains(variable))
+				continue;
+
+			m_nodeDefs[v].append(variable);
+
+			Definition def;
+			def.node = v;
+			def.variable = variable;
+			m_definitions.append(def);
+		}
+
+		foreach(const QString &name, node->uses())
+		{
+			int variable = variableIndex(name.trimmed());
+
+			if(!m_nodeUses.at(v).contains(variable))
+				m_nodeUses[v].append(variable);
+		}
+	}
+
+	firstDef[nodeCount] = m_definitions.size();
+
+	int words = (m_definitions.size() + 63) / 64;
+	m_words = words;
+
+	if(words == 0)
+		return;
+
+	// all definitions of every variable, to kill them
+	QVector<quint64> variableMask(m_variables.size() * words, 0);
+
+	for(int d = 0; d < m_definitions.size(); ++d)
+		variableMask[m_definitions.at(d).variable * words + d / 64] |= (quint64)1 << (d % 64);
+
+	m_in.fill(0, nodeCount * words);
+	QVector<quint64> out(nodeCount * words, 0);
+	QVector<quint64> newOut(words);
+
+	// every node is queued at most once, so a ring of nodeCount is enough
+	QVector<int> queue(nodeCount);
+	QVector<bool> queued(nodeCount, true);
+	int head = 0;
+	int queueSize = nodeCount;
+
+	for(int v = 0; v < nodeCount; ++v)
+		queue[v] = v;
+
+	while(queueSize > 0)
+	{
+		int v = queue.at(head);
+		head = (head + 1) % nodeCount;
+		queueSize--;
+		queued[v] = false;
+
+		quint64 *in = m_in.data() + v * words;
+
+		for(int w = 0; w < words; ++w)
+			in[w] = 0;
+
+		for(int i = m_snapshot->inEdgeBegin(v); i < m_snapshot->inEdgeEnd(v); ++i)
+		{
+			const quint64 *predOut = out.constData() + m_snapshot->edgeSource(m_snapshot->inEdge(i)) * words;
+
+			for(int w = 0; w < words; ++w)
+				in[w] |= predOut[w];
+		}
+
+		// OUT = GEN | (IN & ~KILL)
+		for(int w = 0; w < words; ++w)
+			newOut[w] = in[w];
+
+		foreach(int variable, m_nodeDefs.at(v))
+			for(int w = 0; w < words; ++w)
+				newOut[w] &= ~variableMask.at(variable * words + w);
+
+		for(int d = firstDef.at(v); d < firstDef.at(v + 1); ++d)
+			newOut[d / 64] |= (quint64)1 << (d % 64);
+
+		quint64 *nodeOut = out.data() + v * words;
+		bool changed = false;
+
+		for(int w = 0; w < words; ++w)
+		{
+			if(nodeOut[w] != newOut.at(w))
+			{
+				nodeOut[w] = newOut.at(w);
+				changed = true;
+			}
+		}
+
+		if(!changed)
+			continue;
+
+		for(int e = m_snapshot->edgeBegin(v); e < m_snapshot->edgeEnd(v); ++e)
+		{
+			int target = m_snapshot->edgeTarget(e);
+
+			if(queued.at(target))
+				continue;
+
+			queued[target] = true;
+			queue[(head + queueSize) % nodeCount] = target;
+			queueSize++;
+		}
+	}
+}
+
+bool DataFlowAlgorithm::defines(int node, int variable) const
+{
+	return m_nodeDefs.at(node).contains(variable);
+}
+
+bool DataFlowAlgorithm::uses(int node, int variable) const
+{
+	return m_nodeUses.at(node).contains(variable);
+}
+
+bool DataFlowAlgorithm::reaches(int def, int node) const
+{
+	return (m_in.at(node * m_words + def / 64) >> (def % 64)) & 1;
+}
+
+bool DataFlowAlgorithm::canPass(int node, int variable) const
+{
+	return !defines(node, variable);
+}
+
+QList<int> DataFlowAlgorithm::reachedUses(int def) const
+{
+	QList<int> result;
+	int variable = m_definitions.at(def).variable;
+
+	for(int v = 0; v < m_snapshot->nodeCount(); ++v)
+		if(uses(v, variable) && reaches(def, v))
+			result.append(v);
+
+	return result;
+}
+
+QVector<int> DataFlowAlgorithm::shortestDuPath(int def, int useNode) const
+{
+	int start = m_definitions.at(def).node;
+	int variable = m_definitions.at(def).variable;
+
+	QVector<int> parent(m_snapshot->nodeCount(), -1);
+	QVector<bool> visited(m_snapshot->nodeCount(), false);
+	QVector<int> queue;
+
+	visited[start] = true;
+	queue.append(start);
+
+	for(int i = 0; i < queue.size(); ++i)
+	{
+		int v = queue.at(i);
+
+		for(int e = m_snapshot->edgeBegin(v); e < m_snapshot->edgeEnd(v); ++e)
+		{
+			int target = m_snapshot->edgeTarget(e);
+
+			if(useNode == -1 ? uses(target, variable) : target == useNode)
+			{
+				QVector<int> path;
+				path.append(target);
+
+				for(int w = v; w != -1; w = parent.at(w))
+					path.prepend(w);
+
+				return path;
+			}
+
+			// the path may only come back to the definition to use it there
+			if(visited.at(target) || !canPass(target, variable))
+				continue;
+
+			visited[target] = true;
+			parent[target] = v;
+			queue.append(target);
+		}
+	}
+
+	return QVector<int>();
+}
+
+QList<QVector<int> > DataFlowAlgorithm::allDuPaths(int def, int useNode)
+{
+	QList<QVector<int> > paths;
+
+	int start = m_definitions.at(def).node;
+
+	QVector<int> path;
+	QVector<bool> onPath(m_snapshot->nodeCount(), false);
+
+	path.append(start);
+	onPath[start] = true;
+
+	collectDuPaths(def, useNode, path, onPath, paths);
+
+	return paths;
+}
+
+void DataFlowAlgorithm::collectDuPaths(int def, int useNode, QVector<int> &path, QVector<bool> &onPath,
+				       QList<QVector<int> > &paths)
+{
+	int variable = m_definitions.at(def).variable;
+
+	// next edge to try for every node of the path, the recursion would be as deep as the graph
+	QVector<int> nextEdge;
+	nextEdge.append(m_snapshot->edgeBegin(path.last()));
+
+	while(!nextEdge.isEmpty())
+	{
+		if(isOverBudget())
+			return;
+
+		int v = path.last();
+		int &e = nextEdge.last();
+
+		if(e == m_snapshot->edgeEnd(v))
+		{
+			onPath[v] = false;
+			path.pop_back();
+			nextEdge.pop_back();
+			continue;
+		}
+
+		int target = m_snapshot->edgeTarget(e++);
+
+		if(target == useNode)
+		{
+			QVector<int> found(path);
+			found.append(target);
+			paths.append(found);
+			continue;
+		}
+
+		if(onPath.at(target) || !canPass(target, variable))
+			continue;
+
+		onPath[target] = true;
+		path.append(target);
+		nextEdge.append(m_snapshot->edgeBegin(target));
+	}
+}
+
+void DataFlowAlgorithm::addDuPath(const QVector<int> &path)
+{
+	QByteArray key((const char*)path.constData(), path.size() * sizeof(int));
+
+	// the same path can serve several definitions
+	if(m_addedPaths.contains(key))
+		return;
+
+	m_addedPaths.insert(key);
+
+	QList<Node*> pathNodes;
+
+	foreach(int v, path)
+		pathNodes.append(m_snapshot->node(v));
+
+	addReqResult(new Path(pathNodes));
+}
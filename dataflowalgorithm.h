@@ -0,0 +1,77 @@
+#ifndef DATAFLOWALGORITHM_H
+#define DATAFLOWALGORITHM_H
+
+#include <QList>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QByteArray>
+
+#include "abstractalgorithm.h"
+#include "graphsnapshot.h"
+
+namespace Algorithm
+{
+	/* Common part of the data flow criteria. Every variable a node defines
+	   is one definition, reaching definitions are solved with one bit per
+	   definition over the snapshot of the graph. A du-path goes from a
+	   definition to a use of the same variable, no node inside it defines
+	   the variable again and no node repeats except when the path returns
+	   to the defining node.
+	*/
+	class DataFlowAlgorithm : public AbstractAlgorithm
+	{
+		public:
+			DataFlowAlgorithm();
+			virtual ~DataFlowAlgorithm();
+
+		protected:
+			typedef struct
+			{
+				int node;
+				int variable;
+			} Definition;
+
+			void analyze();
+			void releaseAnalysis();
+
+			int definitionCount() const { return m_definitions.size(); }
+			const Definition &definition(int def) const { return m_definitions.at(def); }
+
+			bool defines(int node, int variable) const;
+			bool uses(int node, int variable) const;
+			bool reaches(int def, int node) const;
+
+			// nodes using the variable of the definition which it reaches
+			QList<int> reachedUses(int def) const;
+
+			// useNode -1 stops at the nearest use
+			QVector<int> shortestDuPath(int def, int useNode = -1) const;
+			QList<QVector<int> > allDuPaths(int def, int useNode);
+
+			void addDuPath(const QVector<int> &path);
+
+		private:
+			GraphSnapshot *m_snapshot;
+
+			QHash<QString, int> m_variables;
+			QList<Definition> m_definitions;
+
+			// per node variable indexes
+			QVector<QVector<int> > m_nodeDefs;
+			QVector<QVector<int> > m_nodeUses;
+
+			// definitions reaching the entry of every node, m_words per node
+			int m_words;
+			QVector<quint64> m_in;
+
+			QSet<QByteArray> m_addedPaths;
+
+			int variableIndex(const QString &name);
+			bool canPass(int node, int variable) const;
+			void collectDuPaths(int def, int useNode, QVector<int> &path, QVector<bool> &onPath,
+					    QList<QVector<int> > &paths);
+	};
+}
+
+#endif // DATAFLOWALGORITHM_H
@@ -0,0 +1,272 @@
+#include "dominatortree.h"
+
+using namespace Algorithm;
+
+namespace
+{
+	/* The node with the smallest semidominator on the forest path up from v,
+	   compressing the path on the way. chain is only scratch space. */
+	int eval(int v, QVector<int> &ancestor, QVector<int> &label, const QVector<int> &semi, QVector<int> &chain)
+	{
+		if(ancestor.at(v) == -1)
+			return v;
+
+		for(int x = v; ancestor.at(ancestor.at(x)) != -1; x = ancestor.at(x))
+			chain.append(x);
+
+		while(!chain.isEmpty())
+		{
+			int x = chain.last();
+			chain.pop_back();
+
+			if(semi.at(label.at(ancestor.at(x))) < semi.at(label.at(x)))
+				label[x] = label.at(ancestor.at(x));
+
+			ancestor[x] = ancestor.at(ancestor.at(x));
+		}
+
+		return label.at(v);
+	}
+}
+
+DominatorTree::DominatorTree(const GraphSnapshot &snapshot, Direction direction)
+{
+	compute(snapshot, direction);
+	numberTree();
+}
+
+void DominatorTree::compute(const GraphSnapshot &snapshot, Direction direction)
+{
+	int n = snapshot.nodeCount();
+	int root = n;
+	bool forward = direction == Dominators;
+
+	// the successors in the direction of the walk, the root's are the start or end nodes
+	QVector<int> rootEdges;
+
+	for(int v = 0; v < n; ++v)
+		if(forward ? snapshot.isStart(v) : snapshot.isEnd(v))
+			rootEdges.append(v);
+
+	QVector<int> dfn(n + 1, -1);
+	QVector<int> vertex;
+	QVector<int> parent(n + 1, -1);
+
+	// depth first numbering, with the next successor to try for every node on the stack
+	QVector<int> stack;
+	QVector<int> nextEdge;
+
+	dfn[root] = 0;
+	vertex.append(root);
+	stack.append(root);
+	nextEdge.append(0);
+
+	while(!stack.isEmpty())
+	{
+		int v = stack.last();
+		int i = nextEdge.last()++;
+		int target;
+
+		if(v == root)
+		{
+			if(i == rootEdges.size())
+			{
+				stack.pop_back();
+				nextEdge.pop_back();
+				continue;
+			}
+
+			target = rootEdges.at(i);
+		}
+		else if(forward)
+		{
+			if(snapshot.edgeBegin(v) + i == snapshot.edgeEnd(v))
+			{
+				stack.pop_back();
+				nextEdge.pop_back();
+				continue;
+			}
+
+			target = snapshot.edgeTarget(snapshot.edgeBegin(v) + i);
+		}
+		else
+		{
+			if(snapshot.inEdgeBegin(v) + i == snapshot.inEdgeEnd(v))
+			{
+				stack.pop_back();
+				nextEdge.pop_back();
+				continue;
+			}
+
+			target = snapshot.edgeSource(snapshot.inEdge(snapshot.inEdgeBegin(v) + i));
+		}
+
+		if(dfn.at(target) != -1)
+			continue;
+
+		dfn[target] = vertex.size();
+		vertex.append(target);
+		parent[target] = v;
+		stack.append(target);
+		nextEdge.append(0);
+	}
+
+	QVector<int> semi(dfn);
+	QVector<int> label(n + 1);
+	QVector<int> ancestor(n + 1, -1);
+
+	// buckets as linked lists of the nodes with the same semidominator
+	QVector<int> bucketHead(n + 1, -1);
+	QVector<int> bucketNext(n + 1, -1);
+
+	m_idom.fill(-1, n + 1);
+
+	for(int v = 0; v <= n; ++v)
+		label[v] = v;
+
+	QVector<int> predecessors;
+	QVector<int> chain;
+
+	for(int i = vertex.size() - 1; i > 0; --i)
+	{
+		int w = vertex.at(i);
+
+		// the predecessors against the direction of the walk
+		predecessors.clear();
+
+		if(forward ? snapshot.isStart(w) : snapshot.isEnd(w))
+			predecessors.append(root);
+
+		if(forward)
+		{
+			for(int k = snapshot.inEdgeBegin(w); k < snapshot.inEdgeEnd(w); ++k)
+				predecessors.append(snapshot.edgeSource(snapshot.inEdge(k)));
+		}
+		else
+		{
+			for(int e = snapshot.edgeBegin(w); e < snapshot.edgeEnd(w); ++e)
+				predecessors.append(snapshot.edgeTarget(e));
+		}
+
+		foreach(int v, predecessors)
+		{
+			if(dfn.at(v) == -1)
+				continue;
+
+			int u = eval(v, ancestor, label, semi, chain);
+
+			if(semi.at(u) < semi.at(w))
+				semi[w] = semi.at(u);
+		}
+
+		int s = vertex.at(semi.at(w));
+		bucketNext[w] = bucketHead.at(s);
+		bucketHead[s] = w;
+
+		int p = parent.at(w);
+		ancestor[w] = p;
+
+		for(int v = bucketHead.at(p); v != -1; v = bucketNext.at(v))
+		{
+			int u = eval(v, ancestor, label, semi, chain);
+			m_idom[v] = semi.at(u) < semi.at(v) ? u : p;
+		}
+
+		bucketHead[p] = -1;
+	}
+
+	for(int i = 1; i < vertex.size(); ++i)
+	{
+		int w = vertex.at(i);
+
+		if(m_idom.at(w) != vertex.at(semi.at(w)))
+			m_idom[w] = m_idom.at(m_idom.at(w));
+	}
+}
+
+void DominatorTree::numberTree()
+{
+	int count = m_idom.size();
+	int root = count - 1;
+
+	m_children.fill(QVector<int>(), count);
+
+	for(int v = 0; v < root; ++v)
+		if(m_idom.at(v) != -1)
+			m_children[m_idom.at(v)].append(v);
+
+	m_pre.fill(-1, count);
+	m_post.fill(-1, count);
+
+	QVector<int> stack;
+	QVector<int> nextChild;
+	int clock = 0;
+
+	m_pre[root] = clock++;
+	stack.append(root);
+	nextChild.append(0);
+
+	while(!stack.isEmpty())
+	{
+		int v = stack.last();
+
+		if(nextChild.last() == m_children.at(v).size())
+		{
+			m_post[v] = clock++;
+			stack.pop_back();
+			nextChild.pop_back();
+			continue;
+		}
+
+		int child = m_children.at(v).at(nextChild.last()++);
+
+		m_pre[child] = clock++;
+		stack.append(child);
+		nextChild.append(0);
+	}
+}
+
+bool DominatorTree::dominates(int a, int b) const
+{
+	if(!contains(a) || !contains(b))
+		return false;
+
+	return m_pre.at(a) <= m_pre.at(b) && m_post.at(b) <= m_post.at(a);
+}
+
+Dominance::Dominance(const QList<Node*> &nodes)
+	: m_snapshot(nodes),
+	  m_dominators(m_snapshot, DominatorTree::Dominators),
+	  m_postDominators(m_snapshot, DominatorTree::PostDominators)
+{
+}
+
+bool Dominance::dominates(Node *a, Node *b) const
+{
+	int from = m_snapshot.indexOf(a);
+	int to = m_snapshot.indexOf(b);
+
+	return from != -1 && to != -1 && m_dominators.dominates(from, to);
+}
+
+bool Dominance::postDominates(Node *b, Node *a) const
+{
+	int from = m_snapshot.indexOf(a);
+	int to = m_snapshot.indexOf(b);
+
+	return from != -1 && to != -1 && m_postDominators.dominates(to, from);
+}
+
+bool Dominance::isReachableFromStart(Node *node) const
+{
+	int v = m_snapshot.indexOf(node);
+
+	return v != -1 && m_dominators.contains(v);
+}
+
+bool Dominance::canReachEnd(Node *node) const
+{
+	int v = m_snapshot.indexOf(node);
+
+	return v != -1 && m_postDominators.contains(v);
+}
@@ -0,0 +1,76 @@
+#ifndef DOMINATORTREE_H
+#define DOMINATORTREE_H
+
+#include <QList>
+#include <QVector>
+
+#include "algorithmnode.h"
+#include "graphsnapshot.h"
+
+namespace Algorithm
+{
+	/* Dominator tree of the snapshot (Lengauer-Tarjan, without recursion),
+	   or the post-dominator tree when walked against the edges. A virtual
+	   root stands for all the start nodes, or all the end nodes, so a graph
+	   with several of them has a single tree. Nodes the root doesn't reach
+	   are not in the tree. Dominance is answered from the pre and post
+	   order numbers of the tree: a dominates b when b's interval lies in a's.
+	*/
+	class DominatorTree
+	{
+		public:
+			enum Direction { Dominators, PostDominators };
+
+			DominatorTree(const GraphSnapshot &snapshot, Direction direction);
+
+			// the virtual root, one past the last node
+			int root() const { return m_idom.size() - 1; }
+
+			bool contains(int v) const { return m_pre.at(v) != -1; }
+
+			// root() for the nodes right under the root, -1 outside the tree
+			int immediateDominator(int v) const { return m_idom.at(v); }
+
+			// every node dominates itself
+			bool dominates(int a, int b) const;
+
+			const QVector<int> &children(int v) const { return m_children.at(v); }
+
+		private:
+			QVector<int> m_idom;
+			QVector<QVector<int> > m_children;
+			QVector<int> m_pre;
+			QVector<int> m_post;
+
+			void compute(const GraphSnapshot &snapshot, Direction direction);
+			void numberTree();
+	};
+
+	/* Both trees of one graph. The graph proxy keeps one until the graph is
+	   edited, algorithms get it with AbstractAlgorithm::setDominance(). */
+	class Dominance
+	{
+		public:
+			Dominance(const QList<Node*> &nodes);
+
+			const GraphSnapshot &snapshot() const { return m_snapshot; }
+			const DominatorTree &dominators() const { return m_dominators; }
+			const DominatorTree &postDominators() const { return m_postDominators; }
+
+			// every path from a start node to b goes through a
+			bool dominates(Node *a, Node *b) const;
+
+			// every path from a to an end node goes through b
+			bool postDominates(Node *b, Node *a) const;
+
+			bool isReachableFromStart(Node *node) const;
+			bool canReachEnd(Node *node) const;
+
+		private:
+			GraphSnapshot m_snapshot;
+			DominatorTree m_dominators;
+			DominatorTree m_postDominators;
+	};
+}
+
+#endif // DOMINATORTREE_H
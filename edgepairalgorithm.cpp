@@ -10,6 +10,9 @@ void EdgePairAlgorithm::onCompute()
 		{
 			foreach(Node *node3, node2->links())
 			{
+				if(isOverBudget())
+					return;
+
 				Path *path = new Path();
 				path->appendNode(node1);
 				path->appendNode(node2);
@@ -8,6 +8,9 @@ void EdgesAlgorithm::onCompute()
 	{
 		foreach(Node *nodeTo, node->links())
 		{
+			if(isOverBudget())
+				return;
+
 			Path *path = new Path(node);
 			path->appendNode(nodeTo);
 			addReqResult(path);
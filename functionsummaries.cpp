@@ -0,0 +1,253 @@
+#include "functionsummaries.h"
+
+#include <QFileInfo>
+#include <QDir>
+
+#include "graphmodel.h"
+#include "graphscenememento.h"
+#include "graphsnapshot.h"
+
+#define QCS_MAGIC 0x3fac9e3f
+
+using namespace Algorithm;
+
+FunctionSummaries::FunctionSummaries(AbstractAlgorithm *algorithm, const QString &criterion)
+	: m_algorithm(algorithm), m_criterion(criterion)
+{
+}
+
+QString FunctionSummaries::key(const QString &fileName)
+{
+	QFileInfo info(fileName);
+
+	// a missing file has no canonical path
+	return info.exists() ? info.canonicalFilePath() : info.absoluteFilePath();
+}
+
+FunctionSummaries::Summary FunctionSummaries::summary(const QString &fileName)
+{
+	QString file = key(fileName);
+	QDateTime modified = QFileInfo(file).lastModified();
+
+	QHash<QString, Summary>::const_iterator it = m_summaries.constFind(file);
+
+	if(it != m_summaries.constEnd() && it.value().modified == modified && it.value().errorString.isEmpty())
+		return it.value();
+
+	Summary result = compute(file, modified);
+	m_summaries.insert(file, result);
+	m_computed.insert(file);
+
+	return result;
+}
+
+FunctionSummaries::Summary FunctionSummaries::compute(const QString &fileName, const QDateTime &modified)
+{
+	Summary result;
+	result.modified = modified;
+	result.truncated = false;
+
+	GraphModel model;
+
+	if(!GraphSceneMemento::readFile(fileName, model, &result.errorString))
+		return result;
+
+	QList<Node*> nodes = nodesFromModel(model);
+	QHash<Node*, int> indexes;
+	QDir dir = QFileInfo(fileName).absoluteDir();
+
+	for(int i = 0; i < nodes.size(); ++i)
+	{
+		Node *node = nodes.at(i);
+
+		indexes.insert(node, i);
+		result.labels << node->label();
+		result.callees << (node->callee().isEmpty() ? QString() : key(dir.absoluteFilePath(node->callee())));
+	}
+
+	m_algorithm->setConstraints(constraintsFromModel(model, nodes));
+	m_algorithm->compute(nodes);
+
+	foreach(Path *path, m_algorithm->requirementsResults())
+	{
+		QVector<int> requirement;
+
+		foreach(Node *node, path->nodes())
+			requirement.append(indexes.value(node));
+
+		result.requirements.append(requirement);
+	}
+
+	foreach(Path *path, m_algorithm->coverageResults())
+	{
+		QVector<int> testPath;
+
+		foreach(Node *node, path->nodes())
+			testPath.append(indexes.value(node));
+
+		result.testPaths.append(testPath);
+	}
+
+	result.truncated = m_algorithm->isTruncated();
+	m_algorithm->clearResults();
+
+	// the connector, breadth first from all the start nodes to the nearest end
+	GraphSnapshot snapshot(nodes);
+	QVector<int> parent(snapshot.nodeCount(), -1);
+	QVector<bool> visited(snapshot.nodeCount(), false);
+	QVector<int> queue;
+
+	for(int v = 0; v < snapshot.nodeCount(); ++v)
+	{
+		if(snapshot.isStart(v))
+		{
+			visited[v] = true;
+			queue.append(v);
+		}
+	}
+
+	for(int i = 0; i < queue.size(); ++i)
+	{
+		int v = queue.at(i);
+
+		if(snapshot.isEnd(v))
+		{
+			for(int w = v; w != -1; w = parent.at(w))
+				result.connector.prepend(w);
+
+			break;
+		}
+
+		for(int e = snapshot.edgeBegin(v); e < snapshot.edgeEnd(v); ++e)
+		{
+			int target = snapshot.edgeTarget(e);
+
+			if(visited.at(target))
+				continue;
+
+			visited[target] = true;
+			parent[target] = v;
+			queue.append(target);
+		}
+	}
+
+	qDeleteAll(nodes);
+
+	return result;
+}
+
+QStringList FunctionSummaries::functions(const QString &fileName)
+{
+	QStringList result;
+	QStringList stack;
+
+	stack.append(key(fileName));
+
+	while(!stack.isEmpty())
+	{
+		QString file = stack.takeLast();
+
+		if(result.contains(file))
+			continue;
+
+		result.append(file);
+
+		QStringList callees = summary(file).callees;
+
+		// reversed, so that they come out in the order of the nodes
+		for(int i = callees.size() - 1; i >= 0; --i)
+			if(!callees.at(i).isEmpty() && !result.contains(callees.at(i)))
+				stack.append(callees.at(i));
+	}
+
+	return result;
+}
+
+QList<QStringList> FunctionSummaries::programTestPaths(const QString &fileName)
+{
+	QString file = key(fileName);
+	Summary function = summary(file);
+
+	QList<QStringList> result;
+
+	m_splicing.insert(file);
+
+	foreach(const QVector<int> &path, function.testPaths)
+	{
+		QStringList labels;
+		appendSpliced(labels, QString(), function, path);
+		result.append(labels);
+	}
+
+	m_splicing.remove(file);
+
+	return result;
+}
+
+void FunctionSummaries::appendSpliced(QStringList &labels, const QString &prefix, const Summary &function,
+				      const QVector<int> &path)
+{
+	foreach(int v, path)
+	{
+		labels << prefix + function.labels.at(v);
+
+		const QString &callee = function.callees.at(v);
+
+		if(callee.isEmpty() || m_splicing.contains(callee))
+			continue;
+
+		// the summary of the callee is copied, computing it may grow the cache
+		Summary called = summary(callee);
+
+		m_splicing.insert(callee);
+		appendSpliced(labels, prefix + QFileInfo(callee).completeBaseName() + ":", called, called.connector);
+		m_splicing.remove(callee);
+	}
+}
+
+void FunctionSummaries::save(QDataStream &stream) const
+{
+	QList<QString> files;
+
+	// failed ones are tried again next time
+	for(QHash<QString, Summary>::const_iterator it = m_summaries.constBegin(); it != m_summaries.constEnd(); ++it)
+		if(it.value().errorString.isEmpty())
+			files.append(it.key());
+
+	stream << (quint32)QCS_MAGIC << m_criterion << (qint32)files.size();
+
+	foreach(const QString &file, files)
+	{
+		const Summary &function = m_summaries[file];
+
+		stream << file << function.modified << function.labels << function.callees
+		       << function.requirements << function.testPaths << function.connector << function.truncated;
+	}
+}
+
+bool FunctionSummaries::load(QDataStream &stream)
+{
+	quint32 magic;
+	QString criterion;
+	qint32 count;
+
+	stream >> magic >> criterion >> count;
+
+	// summaries of another criterion are of no use
+	if(stream.status() != QDataStream::Ok || magic != (quint32)QCS_MAGIC || criterion != m_criterion)
+		return false;
+
+	for(qint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i)
+	{
+		QString file;
+		Summary function;
+
+		stream >> file >> function.modified >> function.labels >> function.callees
+		       >> function.requirements >> function.testPaths >> function.connector >> function.truncated;
+
+		if(stream.status() == QDataStream::Ok)
+			m_summaries.insert(file, function);
+	}
+
+	return stream.status() == QDataStream::Ok;
+}
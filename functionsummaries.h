@@ -0,0 +1,80 @@
+#ifndef FUNCTIONSUMMARIES_H
+#define FUNCTIONSUMMARIES_H
+
+#include <QList>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QDateTime>
+#include <QDataStream>
+
+#include "abstractalgorithm.h"
+
+namespace Algorithm
+{
+	/* Results of a program made of graph files, one per function, where a
+	   node with a callee calls the function of that file. A function is
+	   computed on its own graph only, so its requirements and test paths
+	   are kept until its file changes. The test paths of the program are
+	   those of the caller with the connector of the callee spliced in after
+	   every call node: its shortest path from a start to an end node, with
+	   its own calls spliced the same way. Editing one function recomputes
+	   only that one.
+	*/
+	class FunctionSummaries
+	{
+		public:
+			typedef struct
+			{
+				QDateTime modified;
+
+				// per node in the order of the file, callees as absolute file names
+				QStringList labels;
+				QStringList callees;
+
+				// node indexes
+				QList<QVector<int> > requirements;
+				QList<QVector<int> > testPaths;
+				QVector<int> connector;
+
+				bool truncated;
+				QString errorString;
+			} Summary;
+
+			// the algorithm is not owned, it computes every function
+			FunctionSummaries(AbstractAlgorithm *algorithm, const QString &criterion);
+
+			Summary summary(const QString &fileName);
+
+			// the function of the file and all it calls, callers first
+			QStringList functions(const QString &fileName);
+
+			// test paths of the function with the calls spliced in, as labels
+			QList<QStringList> programTestPaths(const QString &fileName);
+
+			// whether the function was computed here rather than found in a loaded cache
+			bool wasComputed(const QString &fileName) const { return m_computed.contains(key(fileName)); }
+
+			void save(QDataStream &stream) const;
+			bool load(QDataStream &stream);
+
+			static QString key(const QString &fileName);
+
+		private:
+			AbstractAlgorithm *m_algorithm;
+			QString m_criterion;
+			QHash<QString, Summary> m_summaries;
+			QSet<QString> m_computed;
+
+			// functions being spliced, a recursive call is left as it is
+			QSet<QString> m_splicing;
+
+			Summary compute(const QString &fileName, const QDateTime &modified);
+			void appendSpliced(QStringList &labels, const QString &prefix, const Summary &summary,
+					   const QVector<int> &path);
+	};
+}
+
+#endif // FUNCTIONSUMMARIES_H
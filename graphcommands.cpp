@@ -0,0 +1,230 @@
+#include "graphcommands.h"
+
+#include <QObject>
+
+#include "graphscene.h"
+
+using namespace GraphModelTypes;
+
+AddNodeCommand::AddNodeCommand(GraphScene *scene, const QString &label, const QPointF &centerPos)
+	: m_scene(scene), m_nodeId(-1), m_label(label), m_pos(centerPos), m_centered(false)
+{
+	setText(QObject::tr("add node %1").arg(label));
+}
+
+void AddNodeCommand::redo()
+{
+	m_nodeId = m_scene->insertNode(m_label, GraphNode::NormalNode, m_pos, m_nodeId);
+
+	// the node is put where it was clicked, which needs its size
+	if(!m_centered)
+	{
+		m_pos -= m_scene->model().node(m_nodeId).bounds.center();
+		m_scene->moveNode(m_nodeId, m_pos);
+		m_centered = true;
+	}
+}
+
+void AddNodeCommand::undo()
+{
+	m_scene->removeNode(m_nodeId);
+}
+
+DeleteNodeCommand::DeleteNodeCommand(GraphScene *scene, int nodeId)
+	: m_scene(scene)
+{
+	const GraphModel &model = scene->model();
+
+	m_node = model.node(nodeId);
+
+	foreach(int edgeId, m_node.edgeIds)
+		m_edges.append(model.edge(edgeId));
+
+	setText(QObject::tr("delete node %1").arg(m_node.label));
+}
+
+void DeleteNodeCommand::redo()
+{
+	m_scene->removeNode(m_node.id);
+}
+
+void DeleteNodeCommand::undo()
+{
+	m_scene->insertNode(m_node.label, m_node.type, m_node.pos, m_node.id);
+
+	if(!m_node.defs.isEmpty() || !m_node.uses.isEmpty())
+		m_scene->setNodeDataFlow(m_node.id, m_node.defs, m_node.uses);
+
+	if(!m_node.callee.isEmpty())
+		m_scene->setNodeCallee(m_node.id, m_node.callee);
+
+	foreach(const ModelEdge &edge, m_edges)
+	{
+		m_scene->insertEdge(edge.fromNodeId, edge.toNodeId, edge.id);
+
+		if(edge.cost != 1.0)
+			m_scene->setEdgeCost(edge.id, edge.cost);
+	}
+}
+
+AddEdgeCommand::AddEdgeCommand(GraphScene *scene, int fromNodeId, int toNodeId)
+	: m_scene(scene), m_edgeId(-1), m_fromNodeId(fromNodeId), m_toNodeId(toNodeId)
+{
+	setText(QObject::tr("add edge"));
+}
+
+void AddEdgeCommand::redo()
+{
+	m_edgeId = m_scene->insertEdge(m_fromNodeId, m_toNodeId, m_edgeId);
+}
+
+void AddEdgeCommand::undo()
+{
+	m_scene->removeEdge(m_edgeId);
+}
+
+DeleteEdgeCommand::DeleteEdgeCommand(GraphScene *scene, int edgeId)
+	: m_scene(scene), m_edge(scene->model().edge(edgeId))
+{
+	setText(QObject::tr("delete edge"));
+}
+
+void DeleteEdgeCommand::redo()
+{
+	m_scene->removeEdge(m_edge.id);
+}
+
+void DeleteEdgeCommand::undo()
+{
+	m_scene->insertEdge(m_edge.fromNodeId, m_edge.toNodeId, m_edge.id);
+
+	if(m_edge.cost != 1.0)
+		m_scene->setEdgeCost(m_edge.id, m_edge.cost);
+}
+
+MoveNodesCommand::MoveNodesCommand(GraphScene *scene, const QList<int> &nodeIds,
+				   const QList<QPointF> &oldPositions, const QList<QPointF> &newPositions)
+	: m_scene(scene), m_nodeIds(nodeIds), m_oldPositions(oldPositions), m_newPositions(newPositions)
+{
+	setText(QObject::tr("move"));
+}
+
+void MoveNodesCommand::redo()
+{
+	for(int i = 0; i < m_nodeIds.size(); ++i)
+		m_scene->moveNode(m_nodeIds.at(i), m_newPositions.at(i));
+}
+
+void MoveNodesCommand::undo()
+{
+	for(int i = 0; i < m_nodeIds.size(); ++i)
+		m_scene->moveNode(m_nodeIds.at(i), m_oldPositions.at(i));
+}
+
+SetNodeTypeCommand::SetNodeTypeCommand(GraphScene *scene, const QList<int> &nodeIds, GraphNode::NodeType type)
+	: m_scene(scene), m_nodeIds(nodeIds), m_type(type)
+{
+	foreach(int nodeId, nodeIds)
+		m_oldTypes.append(scene->model().node(nodeId).type);
+
+	setText(QObject::tr("change node type"));
+}
+
+void SetNodeTypeCommand::redo()
+{
+	foreach(int nodeId, m_nodeIds)
+		m_scene->setNodeType(nodeId, m_type);
+}
+
+void SetNodeTypeCommand::undo()
+{
+	for(int i = 0; i < m_nodeIds.size(); ++i)
+		m_scene->setNodeType(m_nodeIds.at(i), m_oldTypes.at(i));
+}
+
+SetNodeLabelCommand::SetNodeLabelCommand(GraphScene *scene, int nodeId, const QString &oldLabel, const QString &label)
+	: m_scene(scene), m_nodeId(nodeId), m_oldLabel(oldLabel), m_label(label)
+{
+	setText(QObject::tr("rename node %1").arg(oldLabel));
+}
+
+void SetNodeLabelCommand::redo()
+{
+	m_scene->setNodeLabel(m_nodeId, m_label);
+}
+
+void SetNodeLabelCommand::undo()
+{
+	m_scene->setNodeLabel(m_nodeId, m_oldLabel);
+}
+
+SetNodeDataFlowCommand::SetNodeDataFlowCommand(GraphScene *scene, int nodeId, const QStringList &defs, const QStringList &uses)
+	: m_scene(scene), m_nodeId(nodeId), m_oldDefs(scene->model().node(nodeId).defs),
+	  m_oldUses(scene->model().node(nodeId).uses), m_defs(defs), m_uses(uses)
+{
+	setText(QObject::tr("change definitions and uses of %1").arg(scene->model().node(nodeId).label));
+}
+
+void SetNodeDataFlowCommand::redo()
+{
+	m_scene->setNodeDataFlow(m_nodeId, m_defs, m_uses);
+}
+
+void SetNodeDataFlowCommand::undo()
+{
+	m_scene->setNodeDataFlow(m_nodeId, m_oldDefs, m_oldUses);
+}
+
+SetNodeCalleeCommand::SetNodeCalleeCommand(GraphScene *scene, int nodeId, const QString &callee)
+	: m_scene(scene), m_nodeId(nodeId), m_oldCallee(scene->model().node(nodeId).callee), m_callee(callee)
+{
+	setText(QObject::tr("change the function called by %1").arg(scene->model().node(nodeId).label));
+}
+
+void SetNodeCalleeCommand::redo()
+{
+	m_scene->setNodeCallee(m_nodeId, m_callee);
+}
+
+void SetNodeCalleeCommand::undo()
+{
+	m_scene->setNodeCallee(m_nodeId, m_oldCallee);
+}
+
+SetEdgeCostCommand::SetEdgeCostCommand(GraphScene *scene, const QList<int> &edgeIds, double cost)
+	: m_scene(scene), m_edgeIds(edgeIds), m_cost(cost)
+{
+	foreach(int edgeId, edgeIds)
+		m_oldCosts.append(scene->model().edge(edgeId).cost);
+
+	setText(QObject::tr("change the cost of %n edge(s)", "", edgeIds.size()));
+}
+
+void SetEdgeCostCommand::redo()
+{
+	foreach(int edgeId, m_edgeIds)
+		m_scene->setEdgeCost(edgeId, m_cost);
+}
+
+void SetEdgeCostCommand::undo()
+{
+	for(int i = 0; i < m_edgeIds.size(); ++i)
+		m_scene->setEdgeCost(m_edgeIds.at(i), m_oldCosts.at(i));
+}
+
+SetConstraintsCommand::SetConstraintsCommand(GraphScene *scene, const QList<ModelConstraint> &constraints,
+					     const QString &text)
+	: m_scene(scene), m_oldConstraints(scene->model().constraints()), m_constraints(constraints)
+{
+	setText(text);
+}
+
+void SetConstraintsCommand::redo()
+{
+	m_scene->setConstraints(m_constraints);
+}
+
+void SetConstraintsCommand::undo()
+{
+	m_scene->setConstraints(m_oldConstraints);
+}
@@ -0,0 +1,189 @@
+#ifndef GRAPHCOMMANDS_H
+#define GRAPHCOMMANDS_H
+
+#include <QUndoCommand>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QPointF>
+
+#include "graphnode.h"
+#include "graphmodel.h"
+
+class GraphScene;
+
+/* Undoable edits of the graph. Each command only keeps what it changes,
+   items are referred to by their model ids which stay the same across
+   undo and redo.
+*/
+
+class AddNodeCommand : public QUndoCommand
+{
+	public:
+		AddNodeCommand(GraphScene *scene, const QString &label, const QPointF &centerPos);
+
+		void undo();
+		void redo();
+
+		int nodeId() const { return m_nodeId; }
+
+	private:
+		GraphScene *m_scene;
+		int m_nodeId;
+		QString m_label;
+		QPointF m_pos;
+		bool m_centered;
+};
+
+class DeleteNodeCommand : public QUndoCommand
+{
+	public:
+		DeleteNodeCommand(GraphScene *scene, int nodeId);
+
+		void undo();
+		void redo();
+
+	private:
+		GraphScene *m_scene;
+		GraphModelTypes::ModelNode m_node;
+		QList<GraphModelTypes::ModelEdge> m_edges;
+};
+
+class AddEdgeCommand : public QUndoCommand
+{
+	public:
+		AddEdgeCommand(GraphScene *scene, int fromNodeId, int toNodeId);
+
+		void undo();
+		void redo();
+
+	private:
+		GraphScene *m_scene;
+		int m_edgeId;
+		int m_fromNodeId;
+		int m_toNodeId;
+};
+
+class DeleteEdgeCommand : public QUndoCommand
+{
+	public:
+		DeleteEdgeCommand(GraphScene *scene, int edgeId);
+
+		void undo();
+		void redo();
+
+	private:
+		GraphScene *m_scene;
+		GraphModelTypes::ModelEdge m_edge;
+};
+
+class MoveNodesCommand : public QUndoCommand
+{
+	public:
+		MoveNodesCommand(GraphScene *scene, const QList<int> &nodeIds,
+				 const QList<QPointF> &oldPositions, const QList<QPointF> &newPositions);
+
+		void undo();
+		void redo();
+
+	private:
+		GraphScene *m_scene;
+		QList<int> m_nodeIds;
+		QList<QPointF> m_oldPositions;
+		QList<QPointF> m_newPositions;
+};
+
+class SetNodeTypeCommand : public QUndoCommand
+{
+	public:
+		SetNodeTypeCommand(GraphScene *scene, const QList<int> &nodeIds, GraphNode::NodeType type);
+
+		void undo();
+		void redo();
+
+	private:
+		GraphScene *m_scene;
+		QList<int> m_nodeIds;
+		QList<GraphNode::NodeType> m_oldTypes;
+		GraphNode::NodeType m_type;
+};
+
+class SetNodeLabelCommand : public QUndoCommand
+{
+	public:
+		SetNodeLabelCommand(GraphScene *scene, int nodeId, const QString &oldLabel, const QString &label);
+
+		void undo();
+		void redo();
+
+	private:
+		GraphScene *m_scene;
+		int m_nodeId;
+		QString m_oldLabel;
+		QString m_label;
+};
+
+class SetNodeDataFlowCommand : public QUndoCommand
+{
+	public:
+		SetNodeDataFlowCommand(GraphScene *scene, int nodeId, const QStringList &defs, const QStringList &uses);
+
+		void undo();
+		void redo();
+
+	private:
+		GraphScene *m_scene;
+		int m_nodeId;
+		QStringList m_oldDefs;
+		QStringList m_oldUses;
+		QStringList m_defs;
+		QStringList m_uses;
+};
+
+class SetNodeCalleeCommand : public QUndoCommand
+{
+	public:
+		SetNodeCalleeCommand(GraphScene *scene, int nodeId, const QString &callee);
+
+		void undo();
+		void redo();
+
+	private:
+		GraphScene *m_scene;
+		int m_nodeId;
+		QString m_oldCallee;
+		QString m_callee;
+};
+
+class SetEdgeCostCommand : public QUndoCommand
+{
+	public:
+		SetEdgeCostCommand(GraphScene *scene, const QList<int> &edgeIds, double cost);
+
+		void undo();
+		void redo();
+
+	private:
+		GraphScene *m_scene;
+		QList<int> m_edgeIds;
+		QList<double> m_oldCosts;
+		double m_cost;
+};
+
+// the whole list of constraints is swapped, it is short
+class SetConstraintsCommand : public QUndoCommand
+{
+	public:
+		SetConstraintsCommand(GraphScene *scene, const QList<GraphModelTypes::ModelConstraint> &constraints,
+				      const QString &text);
+
+		void undo();
+		void redo();
+
+	private:
+		GraphScene *m_scene;
+		QList<GraphModelTypes::ModelConstraint> m_oldConstraints;
+		QList<GraphModelTypes::ModelConstraint> m_constraints;
+};
+
+#endif // GRAPHCOMMANDS_H
@@ -23,6 +23,7 @@ GraphEdge::GraphEdge(GraphNode *fromNode, GraphNode *toNode,
 	initSettings();
 
 	m_highlight = false;
+	m_modelId = -1;
 
 	setColor(Qt::black);
 	setPen(QPen(pen().color(), 4, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
@@ -41,6 +42,12 @@ void GraphEdge::initSettings()
 	m_highlightColor = m_settings.value("highlightColor").toString();
 }
 
+void GraphEdge::setNodes(GraphNode *from, GraphNode *to)
+{
+	m_fromNode = from;
+	m_toNode = to;
+}
+
 void GraphEdge::bringToFront()
 {
 	setZValue(-1.0f);
@@ -240,3 +247,16 @@ void GraphEdge::mousePressEvent(QGraphicsSceneMouseEvent *event)
 	if(isSelected())
 		bringToFront();
 }
+
+QVariant GraphEdge::itemChange(GraphicsItemChange change, const QVariant &value)
+{
+	if(change == QGraphicsItem::ItemSelectedHasChanged)
+	{
+		GraphScene *graphScene = qobject_cast<GraphScene*>(scene());
+
+		if(graphScene != 0)
+			graphScene->edgeItemChanged(this);
+	}
+
+	return QGraphicsLineItem::itemChange(change, value);
+}
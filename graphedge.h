@@ -25,6 +25,11 @@ class GraphEdge : public QGraphicsLineItem
 
 		GraphNode *fromNode() const { return m_fromNode; }
 		GraphNode *toNode() const { return m_toNode; }
+		void setNodes(GraphNode *from, GraphNode *to);
+
+		int modelId() const { return m_modelId; }
+		void setModelId(int id) { m_modelId = id; }
+
 		QRectF boundingRect() const;
 		QPainterPath shape() const;
 
@@ -55,6 +60,8 @@ class GraphEdge : public QGraphicsLineItem
 
 		bool m_highlight;
 
+		int m_modelId;
+
 		void initSettings();
 		void updateSimpleShape();
 		static QPointF findPolygonIntersection(const QPolygonF &polygon, const QPointF &polyPos, const QLineF &line);
@@ -62,6 +69,7 @@ class GraphEdge : public QGraphicsLineItem
 	protected:
 		void paint(QPainter *painter, const QStyleOptionGraphicsItem*, QWidget*);
 		void mousePressEvent(QGraphicsSceneMouseEvent *event);
+		QVariant itemChange(GraphicsItemChange change, const QVariant &value);
 };
 
 #endif // GRAPHEDGE_H
@@ -0,0 +1,444 @@
+#include "graphexporter.h"
+
+#include <QFile>
+#include <QPainter>
+#include <QPrinter>
+#include <QFontMetricsF>
+#include <QFontDatabase>
+#include <QStringList>
+#include <QFuture>
+#include <QtConcurrentRun>
+#include <QXmlStreamWriter>
+#include <QtEndian>
+#include <QDebug>
+
+#include <math.h>
+#include <zlib.h>
+
+using namespace GraphModelTypes;
+
+GraphExporter::GraphExporter(const GraphModel &model)
+	: m_model(model), m_painter(model), m_onlyHighlighted(false), m_transparent(false)
+{
+	m_sourceRect = model.boundingRect();
+}
+
+void GraphExporter::setOnlyHighlighted(bool onlyHighlighted)
+{
+	m_onlyHighlighted = onlyHighlighted;
+	m_painter.setOnlyHighlighted(onlyHighlighted);
+}
+
+bool GraphExporter::fitsInMemory() const
+{
+	QSize size(m_sourceRect.size().toSize());
+
+	return (qint64)size.width() * size.height() <= MaxImagePixels;
+}
+
+void GraphExporter::paintRegion(QPainter *painter, const QRectF &targetRect) const
+{
+	QFontMetricsF metrics(painter->font());
+
+	// the title goes in the top left corner of the whole picture
+	if(!m_title.isEmpty())
+		painter->drawText(QRectF(1, 1, m_sourceRect.width(), metrics.height() + 2), m_title);
+
+	painter->translate(-m_sourceRect.topLeft());
+
+	/* Strokes and arrow heads stick out of the items' rectangles,
+	   so look a bit further for the items to draw. */
+	qreal margin = m_painter.margin();
+	QRectF sceneRect(targetRect.translated(m_sourceRect.topLeft()));
+
+	m_painter.paint(painter, sceneRect.adjusted(-margin, -margin, margin, margin));
+}
+
+QImage GraphExporter::renderTile(const QRect &tile) const
+{
+	QImage image(tile.size(), QImage::Format_ARGB32_Premultiplied);
+
+	if(m_transparent)
+		image.fill(qRgba(0, 0, 0, 0));
+	else
+		image.fill(qRgba(255, 255, 255, 255));
+
+	QPainter painter(&image);
+
+	painter.setRenderHint(QPainter::Antialiasing);
+	painter.setRenderHint(QPainter::TextAntialiasing);
+	painter.translate(-tile.topLeft());
+
+	paintRegion(&painter, tile);
+
+	painter.end();
+
+	return image.convertToFormat(QImage::Format_ARGB32);
+}
+
+bool GraphExporter::writePngChunk(QIODevice *device, const char *type, const QByteArray &data)
+{
+	uchar length[4];
+	qToBigEndian<quint32>(data.size(), length);
+
+	uLong crc = crc32(0L, Z_NULL, 0);
+	crc = crc32(crc, (const Bytef*)type, 4);
+	crc = crc32(crc, (const Bytef*)data.constData(), data.size());
+
+	uchar crcBytes[4];
+	qToBigEndian<quint32>((quint32)crc, crcBytes);
+
+	return device->write((const char*)length, 4) == 4 &&
+	       device->write(type, 4) == 4 &&
+	       device->write(data) == data.size() &&
+	       device->write((const char*)crcBytes, 4) == 4;
+}
+
+bool GraphExporter::exportPng(const QString &filename)
+{
+	QSize size(m_sourceRect.size().toSize());
+
+	if(size.isEmpty())
+	{
+		m_errorString = QObject::tr("There is nothing to export.");
+		return false;
+	}
+
+	QFile file(filename);
+
+	if(!file.open(QIODevice::WriteOnly))
+	{
+		m_errorString = file.errorString();
+		return false;
+	}
+
+	QByteArray header(13, 0);
+	qToBigEndian<quint32>(size.width(), (uchar*)header.data());
+	qToBigEndian<quint32>(size.height(), (uchar*)header.data() + 4);
+	header[8] = 8;	// bits per sample
+	header[9] = 6;	// RGBA
+
+	if(file.write("\x89PNG\r\n\x1a\n", 8) != 8 || !writePngChunk(&file, "IHDR", header))
+	{
+		m_errorString = file.errorString();
+		return false;
+	}
+
+	z_stream stream;
+	stream.zalloc = Z_NULL;
+	stream.zfree = Z_NULL;
+	stream.opaque = Z_NULL;
+
+	if(deflateInit(&stream, Z_DEFAULT_COMPRESSION) != Z_OK)
+	{
+		m_errorString = QObject::tr("Could not initialize compression.");
+		return false;
+	}
+
+	QByteArray output(64 * 1024, 0);
+	QByteArray scanLine(1 + size.width() * 4, 0);
+	bool ok = true;
+	bool compressed = true;
+
+	// without it labels drawn off the main thread crash or come out empty on X11
+	bool threaded = QFontDatabase::supportsThreadedFontRendering();
+
+	for(int bandTop = 0; bandTop < size.height() && ok; bandTop += TileSize)
+	{
+		int bandHeight = qMin((int)TileSize, size.height() - bandTop);
+
+		// a band of tiles is rendered in parallel and written out before the next one
+		QList<QFuture<QImage> > futures;
+		QList<QImage> tiles;
+
+		for(int x = 0; x < size.width(); x += TileSize)
+		{
+			QRect tile(x, bandTop, qMin((int)TileSize, size.width() - x), bandHeight);
+
+			if(threaded)
+				futures.append(QtConcurrent::run(this, &GraphExporter::renderTile, tile));
+			else
+				tiles.append(renderTile(tile));
+		}
+
+		for(int i = 0; i < futures.size(); ++i)
+			tiles.append(futures[i].result());
+
+		for(int row = 0; row < bandHeight && ok; ++row)
+		{
+			uchar *out = (uchar*)scanLine.data();
+			*out++ = 0;	// no filter
+
+			foreach(const QImage &tile, tiles)
+			{
+				const QRgb *pixel = (const QRgb*)tile.scanLine(row);
+
+				for(int x = 0; x < tile.width(); ++x, ++pixel)
+				{
+					*out++ = qRed(*pixel);
+					*out++ = qGreen(*pixel);
+					*out++ = qBlue(*pixel);
+					*out++ = qAlpha(*pixel);
+				}
+			}
+
+			stream.next_in = (Bytef*)scanLine.data();
+			stream.avail_in = scanLine.size();
+
+			while(stream.avail_in > 0 && ok)
+			{
+				stream.next_out = (Bytef*)output.data();
+				stream.avail_out = output.size();
+
+				if(deflate(&stream, Z_NO_FLUSH) == Z_STREAM_ERROR)
+				{
+					compressed = false;
+					break;
+				}
+
+				int produced = output.size() - stream.avail_out;
+
+				if(produced > 0)
+					ok = writePngChunk(&file, "IDAT", output.left(produced));
+			}
+
+			ok = ok && compressed;
+		}
+	}
+
+	int result = Z_OK;
+
+	while(result != Z_STREAM_END && ok)
+	{
+		stream.next_out = (Bytef*)output.data();
+		stream.avail_out = output.size();
+
+		result = deflate(&stream, Z_FINISH);
+
+		int produced = output.size() - stream.avail_out;
+
+		if(produced > 0)
+			ok = writePngChunk(&file, "IDAT", output.left(produced));
+
+		if(result == Z_STREAM_ERROR)
+			ok = compressed = false;
+	}
+
+	// also when writing failed, the stream holds memory
+	deflateEnd(&stream);
+
+	ok = ok && writePngChunk(&file, "IEND", QByteArray());
+
+	if(!ok)
+	{
+		m_errorString = compressed ? file.errorString() : QObject::tr("Could not compress the image.");
+		return false;
+	}
+
+	file.close();
+
+	return true;
+}
+
+bool GraphExporter::exportImage(const QString &filename, const char *format, int quality)
+{
+	QSize size(m_sourceRect.size().toSize());
+
+	if(!fitsInMemory())
+	{
+		m_errorString = QObject::tr("The image would be too large, export it to PNG, SVG or PDF instead.");
+		return false;
+	}
+
+	QImage image(renderTile(QRect(QPoint(), size)));
+
+	if(!image.save(filename, format, quality))
+	{
+		m_errorString = QObject::tr("Could not write the image.");
+		return false;
+	}
+
+	return true;
+}
+
+bool GraphExporter::exportSvg(const QString &filename)
+{
+	QFile file(filename);
+
+	if(!file.open(QIODevice::WriteOnly | QIODevice::Text))
+	{
+		m_errorString = file.errorString();
+		return false;
+	}
+
+	QList<int> edgeIds;
+	QList<int> nodeIds;
+
+	qreal margin = m_painter.margin();
+	m_painter.itemsIn(m_sourceRect.adjusted(-margin, -margin, margin, margin), edgeIds, nodeIds);
+
+	QXmlStreamWriter xml(&file);
+	xml.setAutoFormatting(true);
+
+	xml.writeStartDocument();
+	xml.writeStartElement("svg");
+	xml.writeDefaultNamespace("http://www.w3.org/2000/svg");
+	xml.writeAttribute("version", "1.1");
+	xml.writeAttribute("width", QString::number(m_sourceRect.width()));
+	xml.writeAttribute("height", QString::number(m_sourceRect.height()));
+	xml.writeAttribute("viewBox", QString("%1 %2 %3 %4").arg(m_sourceRect.x()).arg(m_sourceRect.y())
+			   .arg(m_sourceRect.width()).arg(m_sourceRect.height()));
+
+	if(!m_transparent)
+	{
+		xml.writeEmptyElement("rect");
+		xml.writeAttribute("x", QString::number(m_sourceRect.x()));
+		xml.writeAttribute("y", QString::number(m_sourceRect.y()));
+		xml.writeAttribute("width", QString::number(m_sourceRect.width()));
+		xml.writeAttribute("height", QString::number(m_sourceRect.height()));
+		xml.writeAttribute("fill", "#ffffff");
+	}
+
+	if(!m_title.isEmpty())
+	{
+		xml.writeStartElement("text");
+		xml.writeAttribute("x", QString::number(m_sourceRect.x() + 1));
+		xml.writeAttribute("y", QString::number(m_sourceRect.y() + 15));
+		xml.writeCharacters(m_title);
+		xml.writeEndElement();
+	}
+
+	xml.writeStartElement("g");
+	xml.writeAttribute("stroke-width", QString::number(m_painter.penWidth()));
+	xml.writeAttribute("stroke-linecap", "round");
+	xml.writeAttribute("stroke-linejoin", "round");
+
+	foreach(int id, edgeIds)
+	{
+		const ModelEdge &edge = m_model.edge(id);
+		QString color = m_painter.edgeColor(edge).name();
+
+		if(edge.fromNodeId == edge.toNodeId)
+		{
+			QRectF arcRect;
+			int startAngle, spanAngle;
+
+			m_painter.edgeArc(edge, arcRect, startAngle, spanAngle);
+
+			// Qt angles go counter-clockwise on screen, in 1/16th of a degree
+			qreal start = startAngle / 16.0 * M_PI / 180.0;
+			qreal end = (startAngle + spanAngle) / 16.0 * M_PI / 180.0;
+			qreal rx = arcRect.width() / 2.0;
+			qreal ry = arcRect.height() / 2.0;
+			QPointF center(arcRect.center());
+
+			QPointF from(center.x() + rx * cos(start), center.y() - ry * sin(start));
+			QPointF to(center.x() + rx * cos(end), center.y() - ry * sin(end));
+
+			xml.writeEmptyElement("path");
+			xml.writeAttribute("d", QString("M %1 %2 A %3 %4 0 %5 0 %6 %7")
+					   .arg(from.x()).arg(from.y()).arg(rx).arg(ry)
+					   .arg(spanAngle > 180 * 16 ? 1 : 0)
+					   .arg(to.x()).arg(to.y()));
+			xml.writeAttribute("fill", "none");
+			xml.writeAttribute("stroke", color);
+
+			continue;
+		}
+
+		QLineF line;
+		QPolygonF arrowHead;
+
+		if(!m_painter.edgeLine(edge, line, arrowHead))
+			continue;
+
+		xml.writeEmptyElement("line");
+		xml.writeAttribute("x1", QString::number(line.x1()));
+		xml.writeAttribute("y1", QString::number(line.y1()));
+		xml.writeAttribute("x2", QString::number(line.x2()));
+		xml.writeAttribute("y2", QString::number(line.y2()));
+		xml.writeAttribute("stroke", color);
+
+		QStringList points;
+
+		foreach(const QPointF &point, arrowHead)
+			points << QString("%1,%2").arg(point.x()).arg(point.y());
+
+		xml.writeEmptyElement("polygon");
+		xml.writeAttribute("points", points.join(" "));
+		xml.writeAttribute("fill", color);
+		xml.writeAttribute("stroke", color);
+	}
+
+	foreach(int id, nodeIds)
+	{
+		const ModelNode &node = m_model.node(id);
+		QRectF rect(m_model.nodeRect(id));
+		QColor fillColor(m_painter.nodeFillColor(node));
+
+		xml.writeEmptyElement("rect");
+		xml.writeAttribute("x", QString::number(rect.x()));
+		xml.writeAttribute("y", QString::number(rect.y()));
+		xml.writeAttribute("width", QString::number(rect.width()));
+		xml.writeAttribute("height", QString::number(rect.height()));
+		xml.writeAttribute("rx", QString::number(m_painter.rounding()));
+		xml.writeAttribute("fill", fillColor.name());
+		xml.writeAttribute("fill-opacity", QString::number(fillColor.alphaF()));
+		xml.writeAttribute("stroke", m_painter.nodeBorderColor(node).name());
+
+		xml.writeStartElement("text");
+		xml.writeAttribute("x", QString::number(rect.center().x()));
+		xml.writeAttribute("y", QString::number(rect.center().y()));
+		xml.writeAttribute("text-anchor", "middle");
+		xml.writeAttribute("dominant-baseline", "central");
+		xml.writeAttribute("stroke", "none");
+		xml.writeCharacters(node.label);
+		xml.writeEndElement();
+	}
+
+	xml.writeEndElement();	// g
+	xml.writeEndElement();	// svg
+	xml.writeEndDocument();
+
+	if(xml.hasError())
+	{
+		m_errorString = file.errorString();
+		return false;
+	}
+
+	file.close();
+
+	return true;
+}
+
+bool GraphExporter::exportPdf(const QString &filename)
+{
+	QPrinter printer(QPrinter::HighResolution);
+
+	printer.setOutputFormat(QPrinter::PdfFormat);
+	printer.setOutputFileName(filename);
+	printer.setFullPage(true);
+	printer.setPaperSize(m_sourceRect.size(), QPrinter::Point);
+
+	QPainter painter;
+
+	if(!painter.begin(&printer))
+	{
+		m_errorString = QObject::tr("Could not write the PDF file.");
+		return false;
+	}
+
+	QRectF pageRect(printer.pageRect());
+
+	painter.setRenderHint(QPainter::Antialiasing);
+	painter.scale(pageRect.width() / m_sourceRect.width(), pageRect.height() / m_sourceRect.height());
+
+	if(!m_transparent)
+		painter.fillRect(QRectF(QPointF(), m_sourceRect.size()), Qt::white);
+
+	paintRegion(&painter, QRectF(QPointF(), m_sourceRect.size()));
+
+	painter.end();
+
+	return true;
+}
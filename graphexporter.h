@@ -0,0 +1,53 @@
+#ifndef GRAPHEXPORTER_H
+#define GRAPHEXPORTER_H
+
+#include <QString>
+#include <QRectF>
+#include <QImage>
+#include <QIODevice>
+
+#include "graphmodel.h"
+#include "graphpainter.h"
+
+/* Exports a region of the graph without ever holding the whole picture
+   in memory. Raster output is rendered in tiles on the thread pool and
+   streamed into a PNG file band by band, SVG is written element by element.
+*/
+class GraphExporter
+{
+	public:
+		GraphExporter(const GraphModel &model);
+
+		void setSourceRect(const QRectF &rect) { m_sourceRect = rect; }
+		void setOnlyHighlighted(bool onlyHighlighted);
+		void setTransparent(bool transparent) { m_transparent = transparent; }
+		void setTitle(const QString &title) { m_title = title; }
+
+		bool exportPng(const QString &filename);
+		bool exportImage(const QString &filename, const char *format = 0, int quality = -1);
+		bool exportSvg(const QString &filename);
+		bool exportPdf(const QString &filename);
+
+		bool fitsInMemory() const;
+		const QString &errorString() const { return m_errorString; }
+
+		static const int TileSize = 256;
+		static const qint64 MaxImagePixels = 64 * 1024 * 1024;
+
+	private:
+		const GraphModel &m_model;
+		GraphPainter m_painter;
+
+		QRectF m_sourceRect;
+		bool m_onlyHighlighted;
+		bool m_transparent;
+		QString m_title;
+		QString m_errorString;
+
+		QImage renderTile(const QRect &tile) const;
+		void paintRegion(QPainter *painter, const QRectF &targetRect) const;
+
+		bool writePngChunk(QIODevice *device, const char *type, const QByteArray &data);
+};
+
+#endif // GRAPHEXPORTER_H
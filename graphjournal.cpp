@@ -0,0 +1,474 @@
+#include "graphjournal.h"
+
+#include <QDataStream>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDir>
+#include <QDesktopServices>
+#include <QDebug>
+
+#include <zlib.h>
+
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#endif
+
+#include "graphscene.h"
+
+using namespace GraphModelTypes;
+
+static void writeChange(QDataStream &stream, const GraphChange &change)
+{
+	stream << (quint8)change.type;
+
+	switch(change.type)
+	{
+		case GraphChange::NodeAdded:
+			stream << (qint32)change.nodeId << change.label << (qint32)change.nodeType << change.pos;
+		break;
+
+		case GraphChange::NodeRemoved:
+			stream << (qint32)change.nodeId;
+		break;
+
+		case GraphChange::EdgeAdded:
+			stream << (qint32)change.edgeId << (qint32)change.fromNodeId << (qint32)change.toNodeId;
+		break;
+
+		case GraphChange::EdgeRemoved:
+			stream << (qint32)change.edgeId;
+		break;
+
+		case GraphChange::NodeMoved:
+			stream << (qint32)change.nodeId << change.pos;
+		break;
+
+		case GraphChange::NodeRetyped:
+			stream << (qint32)change.nodeId << (qint32)change.nodeType;
+		break;
+
+		case GraphChange::NodeRelabeled:
+			stream << (qint32)change.nodeId << change.label;
+		break;
+
+		case GraphChange::NodeDataFlowChanged:
+			stream << (qint32)change.nodeId << change.defs << change.uses;
+		break;
+
+		case GraphChange::NodeCalleeChanged:
+			stream << (qint32)change.nodeId << change.callee;
+		break;
+
+		case GraphChange::EdgeCostChanged:
+			stream << (qint32)change.edgeId << change.cost;
+		break;
+
+		case GraphChange::ConstraintsChanged:
+			stream << (qint32)change.constraints.size();
+
+			foreach(const ModelConstraint &constraint, change.constraints)
+				stream << (qint32)constraint.type << constraint.nodeIds;
+		break;
+	}
+}
+
+static bool readChange(QDataStream &stream, GraphChange &change)
+{
+	quint8 type;
+	qint32 nodeId = -1, edgeId = -1, fromNodeId = -1, toNodeId = -1, nodeType = 0;
+
+	stream >> type;
+
+	switch(type)
+	{
+		case GraphChange::NodeAdded:
+			stream >> nodeId >> change.label >> nodeType >> change.pos;
+		break;
+
+		case GraphChange::NodeRemoved:
+			stream >> nodeId;
+		break;
+
+		case GraphChange::EdgeAdded:
+			stream >> edgeId >> fromNodeId >> toNodeId;
+		break;
+
+		case GraphChange::EdgeRemoved:
+			stream >> edgeId;
+		break;
+
+		case GraphChange::NodeMoved:
+			stream >> nodeId >> change.pos;
+		break;
+
+		case GraphChange::NodeRetyped:
+			stream >> nodeId >> nodeType;
+		break;
+
+		case GraphChange::NodeRelabeled:
+			stream >> nodeId >> change.label;
+		break;
+
+		case GraphChange::NodeDataFlowChanged:
+			stream >> nodeId >> change.defs >> change.uses;
+		break;
+
+		case GraphChange::NodeCalleeChanged:
+			stream >> nodeId >> change.callee;
+		break;
+
+		case GraphChange::EdgeCostChanged:
+			stream >> edgeId >> change.cost;
+		break;
+
+		case GraphChange::ConstraintsChanged:
+		{
+			qint32 count = 0;
+			stream >> count;
+
+			for(int i = 0; i < count && stream.status() == QDataStream::Ok; ++i)
+			{
+				qint32 constraintType;
+				ModelConstraint constraint;
+
+				stream >> constraintType >> constraint.nodeIds;
+				constraint.type = (ModelConstraint::ConstraintType)constraintType;
+
+				change.constraints.append(constraint);
+			}
+		}
+		break;
+
+		default:
+			return false;
+	}
+
+	change.type = (GraphChange::ChangeType)type;
+	change.nodeId = nodeId;
+	change.edgeId = edgeId;
+	change.fromNodeId = fromNodeId;
+	change.toNodeId = toNodeId;
+	change.nodeType = (GraphNode::NodeType)nodeType;
+
+	return stream.status() == QDataStream::Ok;
+}
+
+GraphJournal::GraphJournal(QObject *parent)
+	: QObject(parent)
+{
+	m_syncTimer.setSingleShot(true);
+	m_syncTimer.setInterval(SyncInterval);
+
+	connect(&m_syncTimer, SIGNAL(timeout()), this, SLOT(sync()));
+}
+
+GraphJournal::~GraphJournal()
+{
+	if(isActive())
+		sync();
+}
+
+QString GraphJournal::journalFilename(const QString &graphFilename)
+{
+	if(!graphFilename.isEmpty())
+		return graphFilename + ".journal";
+
+	// a graph which was never saved has nowhere else to go
+	QDir dir(QDesktopServices::storageLocation(QDesktopServices::DataLocation));
+	dir.mkpath(".");
+
+	return dir.filePath("Untitled.qcv.journal");
+}
+
+void GraphJournal::baseFileInfo(const QString &graphFilename, qint64 &size, quint32 &modified)
+{
+	QFileInfo info(graphFilename);
+
+	if(graphFilename.isEmpty() || !info.exists())
+	{
+		size = -1;
+		modified = 0;
+		return;
+	}
+
+	size = info.size();
+	modified = info.lastModified().toTime_t();
+}
+
+bool GraphJournal::syncFile(QFile &file)
+{
+	if(!file.flush())
+		return false;
+
+#if defined(Q_OS_UNIX)
+	return ::fsync(file.handle()) == 0;
+#elif defined(Q_OS_WIN)
+	return ::_commit(file.handle()) == 0;
+#else
+	return true;
+#endif
+}
+
+bool GraphJournal::start(const QString &graphFilename, const GraphModel &model)
+{
+	QString filename(journalFilename(graphFilename));
+
+	if(isActive() && m_file.fileName() != filename)
+		stop(true);
+	else if(isActive())
+		m_file.close();
+
+	m_syncTimer.stop();
+	m_buffer.clear();
+	m_errorString.clear();
+
+	m_file.setFileName(filename);
+
+	if(!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+	{
+		m_errorString = m_file.errorString();
+		return false;
+	}
+
+	qint64 baseSize;
+	quint32 baseModified;
+	baseFileInfo(graphFilename, baseSize, baseModified);
+
+	/* The saved file has the nodes and edges in the order of their ids,
+	   which is all that is needed to find them again. */
+	QDataStream out(&m_file);
+	out.setVersion(QDataStream::Qt_4_0);
+
+	out << (quint32)QCV_JOURNAL_MAGIC << (quint32)QCV_JOURNAL_VERSION;
+	out << baseSize << baseModified;
+	out << model.nodeIds() << model.edgeIds();
+
+	if(out.status() != QDataStream::Ok || !syncFile(m_file))
+	{
+		m_errorString = m_file.errorString();
+		m_file.close();
+		return false;
+	}
+
+	return true;
+}
+
+void GraphJournal::stop(bool remove)
+{
+	if(!isActive())
+		return;
+
+	m_syncTimer.stop();
+
+	if(remove)
+	{
+		m_buffer.clear();
+		m_file.close();
+		m_file.remove();
+	}
+	else
+	{
+		sync();
+		m_file.close();
+	}
+}
+
+void GraphJournal::record(const GraphChange &change)
+{
+	if(!isActive())
+		return;
+
+	QByteArray payload;
+
+	QDataStream payloadStream(&payload, QIODevice::WriteOnly);
+	payloadStream.setVersion(QDataStream::Qt_4_0);
+	writeChange(payloadStream, change);
+
+	// a crash may tear the last record, the checksum tells
+	QDataStream out(&m_buffer, QIODevice::WriteOnly | QIODevice::Append);
+	out.setVersion(QDataStream::Qt_4_0);
+
+	out << (quint32)payload.size();
+	out << (quint32)crc32(0, (const Bytef*)payload.constData(), payload.size());
+	out.writeRawData(payload.constData(), payload.size());
+
+	if(!m_syncTimer.isActive())
+		m_syncTimer.start();
+}
+
+bool GraphJournal::sync()
+{
+	m_syncTimer.stop();
+
+	if(!isActive() || m_buffer.isEmpty())
+		return true;
+
+	if(m_file.write(m_buffer) != m_buffer.size() || !syncFile(m_file))
+	{
+		m_errorString = m_file.errorString();
+
+#ifdef DEBUG
+		qWarning() << "GraphJournal::sync:" << m_errorString;
+#endif
+		return false;
+	}
+
+	m_buffer.clear();
+
+	return true;
+}
+
+bool GraphJournal::readRecovery(const QString &graphFilename, Recovery &recovery)
+{
+	recovery.nodeIds.clear();
+	recovery.edgeIds.clear();
+	recovery.changes.clear();
+
+	QFile file(journalFilename(graphFilename));
+
+	if(!file.exists() || !file.open(QIODevice::ReadOnly))
+		return false;
+
+	QDataStream in(&file);
+	in.setVersion(QDataStream::Qt_4_0);
+
+	quint32 magic, version;
+	qint64 baseSize, expectedSize;
+	quint32 baseModified, expectedModified;
+	QList<int> nodeIds, edgeIds;
+
+	in >> magic >> version;
+
+	if(magic != (quint32)QCV_JOURNAL_MAGIC || version != QCV_JOURNAL_VERSION)
+		return false;
+
+	in >> baseSize >> baseModified;
+
+	// the journal is only good for the file it was started from
+	baseFileInfo(graphFilename, expectedSize, expectedModified);
+
+	if(baseSize != expectedSize || baseModified != expectedModified)
+		return false;
+
+	in >> nodeIds >> edgeIds;
+
+	if(in.status() != QDataStream::Ok)
+		return false;
+
+	for(int i = 0; i < nodeIds.size(); ++i)
+		recovery.nodeIds.insert(nodeIds.at(i), i);
+
+	for(int i = 0; i < edgeIds.size(); ++i)
+		recovery.edgeIds.insert(edgeIds.at(i), i);
+
+	while(!in.atEnd())
+	{
+		quint32 size, checksum;
+
+		in >> size >> checksum;
+
+		if(in.status() != QDataStream::Ok || size > (quint32)(file.size() - file.pos()))
+			break;
+
+		QByteArray payload(size, 0);
+
+		if(in.readRawData(payload.data(), size) != (int)size ||
+		   crc32(0, (const Bytef*)payload.constData(), size) != checksum)
+			break;
+
+		QDataStream payloadStream(payload);
+		payloadStream.setVersion(QDataStream::Qt_4_0);
+
+		GraphChange change;
+
+		if(!readChange(payloadStream, change))
+			break;
+
+		recovery.changes.append(change);
+	}
+
+	return true;
+}
+
+void GraphJournal::replay(const Recovery &recovery, GraphScene *scene)
+{
+	/* Journal ids are mapped to the ids the model has now - the saved
+	   ones got their file positions, new ones whatever the model gives. */
+	QHash<int, int> nodeIds(recovery.nodeIds);
+	QHash<int, int> edgeIds(recovery.edgeIds);
+
+	foreach(const GraphChange &change, recovery.changes)
+	{
+		int nodeId = nodeIds.value(change.nodeId, -1);
+		int edgeId = edgeIds.value(change.edgeId, -1);
+
+		switch(change.type)
+		{
+			case GraphChange::NodeAdded:
+				nodeIds.insert(change.nodeId, scene->insertNode(change.label, change.nodeType, change.pos));
+			break;
+
+			case GraphChange::NodeRemoved:
+				scene->removeNode(nodeId);
+				nodeIds.remove(change.nodeId);
+			break;
+
+			case GraphChange::EdgeAdded:
+				edgeId = scene->insertEdge(nodeIds.value(change.fromNodeId, -1),
+							   nodeIds.value(change.toNodeId, -1));
+
+				if(edgeId != -1)
+					edgeIds.insert(change.edgeId, edgeId);
+			break;
+
+			case GraphChange::EdgeRemoved:
+				scene->removeEdge(edgeId);
+				edgeIds.remove(change.edgeId);
+			break;
+
+			case GraphChange::NodeMoved:
+				scene->moveNode(nodeId, change.pos);
+			break;
+
+			case GraphChange::NodeRetyped:
+				scene->setNodeType(nodeId, change.nodeType);
+			break;
+
+			case GraphChange::NodeRelabeled:
+				scene->setNodeLabel(nodeId, change.label);
+			break;
+
+			case GraphChange::NodeDataFlowChanged:
+				scene->setNodeDataFlow(nodeId, change.defs, change.uses);
+			break;
+
+			case GraphChange::NodeCalleeChanged:
+				scene->setNodeCallee(nodeId, change.callee);
+			break;
+
+			case GraphChange::EdgeCostChanged:
+				scene->setEdgeCost(edgeId, change.cost);
+			break;
+
+			case GraphChange::ConstraintsChanged:
+			{
+				QList<ModelConstraint> constraints;
+
+				foreach(ModelConstraint constraint, change.constraints)
+				{
+					for(int i = 0; i < constraint.nodeIds.size(); ++i)
+						constraint.nodeIds[i] = nodeIds.value(constraint.nodeIds.at(i), -1);
+
+					constraints.append(constraint);
+				}
+
+				scene->setConstraints(constraints);
+			}
+			break;
+		}
+	}
+}
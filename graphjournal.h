@@ -0,0 +1,70 @@
+#ifndef GRAPHJOURNAL_H
+#define GRAPHJOURNAL_H
+
+#include <QObject>
+#include <QFile>
+#include <QTimer>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+#include "graphmodel.h"
+
+#define QCV_JOURNAL_MAGIC 0x3fac9e4a
+#define QCV_JOURNAL_VERSION 1
+
+class GraphScene;
+
+/* Append-only record of the edits made since the graph was last loaded or
+   saved, kept next to the .qcv file. Edits are buffered and written out
+   (and synced to disk) every few seconds, a save compacts the journal back
+   to just its header. If the application dies, the edits can be replayed
+   on top of the saved file.
+
+   The header remembers which model ids the saved nodes and edges had, the
+   records refer to model ids.
+*/
+class GraphJournal : public QObject
+{
+	Q_OBJECT
+
+	public:
+		typedef struct
+		{
+			QHash<int, int> nodeIds;
+			QHash<int, int> edgeIds;
+			QList<GraphModelTypes::GraphChange> changes;
+		} Recovery;
+
+		GraphJournal(QObject *parent = 0);
+		~GraphJournal();
+
+		bool start(const QString &graphFilename, const GraphModel &model);
+		void stop(bool remove);
+
+		bool isActive() const { return m_file.isOpen(); }
+		const QString &errorString() const { return m_errorString; }
+
+		static QString journalFilename(const QString &graphFilename);
+		static bool readRecovery(const QString &graphFilename, Recovery &recovery);
+		static void replay(const Recovery &recovery, GraphScene *scene);
+
+		static bool syncFile(QFile &file);
+
+	public slots:
+		void record(const GraphModelTypes::GraphChange &change);
+		bool sync();
+
+	private:
+		QFile m_file;
+		QByteArray m_buffer;
+		QTimer m_syncTimer;
+		QString m_errorString;
+
+		static const int SyncInterval = 2000;
+
+		static void baseFileInfo(const QString &graphFilename, qint64 &size, quint32 &modified);
+};
+
+#endif // GRAPHJOURNAL_H
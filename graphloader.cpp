@@ -0,0 +1,149 @@
+#include "graphloader.h"
+
+#include <QFile>
+#include <QDataStream>
+#include <QMutexLocker>
+#include <QCoreApplication>
+
+using namespace GraphSceneMementoTypes;
+
+GraphLoader::GraphLoader(const QString &filename, QObject *parent)
+	: QThread(parent), m_filename(filename), m_cancelled(false)
+{
+}
+
+GraphLoader::~GraphLoader()
+{
+	cancel();
+	wait();
+}
+
+void GraphLoader::cancel()
+{
+	QMutexLocker locker(&m_mutex);
+	m_cancelled = true;
+}
+
+bool GraphLoader::isCancelled()
+{
+	QMutexLocker locker(&m_mutex);
+	return m_cancelled;
+}
+
+bool GraphLoader::takeChunks(QList<StoredNode> &nodes, QList<StoredEdge> &edges, StoredSections &sections)
+{
+	QMutexLocker locker(&m_mutex);
+
+	nodes = m_pendingNodes;
+	edges = m_pendingEdges;
+	sections = m_pendingSections;
+
+	m_pendingNodes.clear();
+	m_pendingEdges.clear();
+	m_pendingSections.clear();
+
+	return !nodes.isEmpty() || !edges.isEmpty() || !sections.isEmpty();
+}
+
+void GraphLoader::flush(QList<StoredNode> &nodes, QList<StoredEdge> &edges, StoredSections &sections)
+{
+	{
+		QMutexLocker locker(&m_mutex);
+
+		m_pendingNodes += nodes;
+		m_pendingEdges += edges;
+		m_pendingSections.append(sections);
+	}
+
+	nodes.clear();
+	edges.clear();
+	sections.clear();
+
+	emit chunkReady();
+}
+
+void GraphLoader::run()
+{
+	QFile file(m_filename);
+
+	if(!file.open(QIODevice::ReadOnly))
+	{
+		m_errorString = tr("Could not open file <i>") + m_filename +
+				tr("</i> with error: <b>") +
+				file.errorString() + "</b>";
+		return;
+	}
+
+	QDataStream in(&file);
+	in.setVersion(QDataStream::Qt_4_0);
+
+	quint32 magic;
+
+	in >> magic;
+
+	if(magic != (quint32)QCV_MAGIC)
+	{
+		m_errorString = tr("File %1 is either corrupted or is not %2 graph!").
+				arg(m_filename, QCoreApplication::applicationName());
+		return;
+	}
+
+	qint64 fileSize = qMax(file.size(), (qint64)1);
+
+	/* This is how QDataStream stores a QList, reading it element
+	   by element lets us pass the graph on while it is read. */
+	QList<StoredNode> nodes;
+	QList<StoredEdge> edges;
+	StoredSections sections;
+	quint32 count;
+
+	in >> count;
+
+	for(quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+	{
+		StoredNode node;
+		in >> node;
+		nodes.append(node);
+
+		if(nodes.size() == ChunkSize)
+		{
+			if(isCancelled())
+				return;
+
+			flush(nodes, edges, sections);
+			emit progress((int)(file.pos() * 100 / fileSize));
+		}
+	}
+
+	in >> count;
+
+	for(quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+	{
+		StoredEdge edge;
+		in >> edge;
+		edges.append(edge);
+
+		if(edges.size() == ChunkSize)
+		{
+			if(isCancelled())
+				return;
+
+			flush(nodes, edges, sections);
+			emit progress((int)(file.pos() * 100 / fileSize));
+		}
+	}
+
+	// the optional sections are small, they come in one piece
+	if(in.status() == QDataStream::Ok)
+		GraphSceneMemento::readSections(in, sections);
+
+	if(in.status() != QDataStream::Ok)
+	{
+		m_errorString = tr("File %1 is either corrupted or is not %2 graph!").
+				arg(m_filename, QCoreApplication::applicationName());
+		return;
+	}
+
+	flush(nodes, edges, sections);
+	emit progress(100);
+}
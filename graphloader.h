@@ -0,0 +1,59 @@
+#ifndef GRAPHLOADER_H
+#define GRAPHLOADER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QString>
+#include <QList>
+
+#include "graphscenememento.h"
+
+/* Reads a .qcv file on a worker thread and hands it over in chunks,
+   so that the graph can be shown (and scrolled) while it is loading.
+   Edges and the optional sections always arrive after all the nodes
+   they refer to.
+*/
+class GraphLoader : public QThread
+{
+	Q_OBJECT
+
+	public:
+		GraphLoader(const QString &filename, QObject *parent = 0);
+		~GraphLoader();
+
+		bool takeChunks(QList<GraphSceneMementoTypes::StoredNode> &nodes,
+				QList<GraphSceneMementoTypes::StoredEdge> &edges,
+				GraphSceneMementoTypes::StoredSections &sections);
+
+		void cancel();
+
+		const QString &filename() const { return m_filename; }
+		bool hasFailed() const { return !m_errorString.isEmpty(); }
+		const QString &errorString() const { return m_errorString; }
+
+	signals:
+		void chunkReady();
+		void progress(int percent);
+
+	protected:
+		void run();
+
+	private:
+		QString m_filename;
+		QString m_errorString;
+
+		QMutex m_mutex;
+		QList<GraphSceneMementoTypes::StoredNode> m_pendingNodes;
+		QList<GraphSceneMementoTypes::StoredEdge> m_pendingEdges;
+		GraphSceneMementoTypes::StoredSections m_pendingSections;
+		bool m_cancelled;
+
+		bool isCancelled();
+		void flush(QList<GraphSceneMementoTypes::StoredNode> &nodes,
+			   QList<GraphSceneMementoTypes::StoredEdge> &edges,
+			   GraphSceneMementoTypes::StoredSections &sections);
+
+		static const int ChunkSize = 4096;
+};
+
+#endif // GRAPHLOADER_H
@@ -0,0 +1,353 @@
+#include "graphmodel.h"
+
+#include <QtAlgorithms>
+#include <QDebug>
+
+using namespace GraphModelTypes;
+
+GraphModel::GraphModel()
+	: m_nextNodeId(0), m_nextEdgeId(0)
+{
+}
+
+int GraphModel::addNode(const QString &label, GraphNode::NodeType type, const QPointF &pos, int id)
+{
+	if(id == -1)
+		id = m_nextNodeId;
+
+	if(id >= m_nextNodeId)
+		m_nextNodeId = id + 1;
+
+	ModelNode node;
+	node.id = id;
+	node.type = type;
+	node.label = label;
+	node.pos = pos;
+	node.bounds = defaultNodeBounds();
+	node.selected = false;
+	node.highlighted = false;
+
+	m_nodes.insert(id, node);
+	m_nodeIndex.insert(id, nodeRect(id));
+
+	return id;
+}
+
+void GraphModel::removeNode(int id)
+{
+	if(!m_nodes.contains(id))
+		return;
+
+	foreach(int edgeId, m_nodes.value(id).edgeIds)
+		removeEdge(edgeId);
+
+	m_nodes.remove(id);
+	m_nodeIndex.remove(id);
+}
+
+int GraphModel::addEdge(int fromNodeId, int toNodeId, int id)
+{
+	if(!m_nodes.contains(fromNodeId) || !m_nodes.contains(toNodeId))
+	{
+#ifdef DEBUG
+		qWarning() << "addEdge: no such node";
+#endif
+		return -1;
+	}
+
+	if(id == -1)
+		id = m_nextEdgeId;
+
+	if(id >= m_nextEdgeId)
+		m_nextEdgeId = id + 1;
+
+	ModelEdge edge;
+	edge.id = id;
+	edge.fromNodeId = fromNodeId;
+	edge.toNodeId = toNodeId;
+	edge.selected = false;
+	edge.highlighted = false;
+	edge.cost = 1.0;
+
+	m_edges.insert(id, edge);
+
+	m_nodes[fromNodeId].edgeIds.append(id);
+
+	if(toNodeId != fromNodeId)
+		m_nodes[toNodeId].edgeIds.append(id);
+
+	m_edgeIndex.insert(id, edgeRect(id));
+
+	return id;
+}
+
+void GraphModel::removeEdge(int id)
+{
+	if(!m_edges.contains(id))
+		return;
+
+	ModelEdge edge = m_edges.take(id);
+
+	m_nodes[edge.fromNodeId].edgeIds.removeOne(id);
+	m_nodes[edge.toNodeId].edgeIds.removeOne(id);
+
+	m_edgeIndex.remove(id);
+}
+
+int GraphModel::findEdge(int fromNodeId, int toNodeId) const
+{
+	if(!m_nodes.contains(fromNodeId))
+		return -1;
+
+	foreach(int edgeId, m_nodes.value(fromNodeId).edgeIds)
+	{
+		const ModelEdge &edge = m_edges[edgeId];
+
+		if(edge.fromNodeId == fromNodeId && edge.toNodeId == toNodeId)
+			return edgeId;
+	}
+
+	return -1;
+}
+
+const ModelNode &GraphModel::node(int id) const
+{
+	return *m_nodes.constFind(id);
+}
+
+const ModelEdge &GraphModel::edge(int id) const
+{
+	return *m_edges.constFind(id);
+}
+
+void GraphModel::updateNodeGeometry(int id)
+{
+	m_nodeIndex.update(id, nodeRect(id));
+
+	foreach(int edgeId, m_nodes.value(id).edgeIds)
+		m_edgeIndex.update(edgeId, edgeRect(edgeId));
+}
+
+void GraphModel::setNodePos(int id, const QPointF &pos)
+{
+	if(!m_nodes.contains(id) || m_nodes.value(id).pos == pos)
+		return;
+
+	m_nodes[id].pos = pos;
+	updateNodeGeometry(id);
+}
+
+void GraphModel::setNodeBounds(int id, const QRectF &bounds)
+{
+	if(!m_nodes.contains(id) || m_nodes.value(id).bounds == bounds)
+		return;
+
+	m_nodes[id].bounds = bounds;
+	updateNodeGeometry(id);
+}
+
+void GraphModel::setNodeLabel(int id, const QString &label)
+{
+	if(m_nodes.contains(id))
+		m_nodes[id].label = label;
+}
+
+void GraphModel::setNodeType(int id, GraphNode::NodeType type)
+{
+	if(m_nodes.contains(id))
+		m_nodes[id].type = type;
+}
+
+void GraphModel::setNodeDataFlow(int id, const QStringList &defs, const QStringList &uses)
+{
+	if(!m_nodes.contains(id))
+		return;
+
+	m_nodes[id].defs = defs;
+	m_nodes[id].uses = uses;
+}
+
+void GraphModel::setNodeCallee(int id, const QString &callee)
+{
+	if(m_nodes.contains(id))
+		m_nodes[id].callee = callee;
+}
+
+void GraphModel::setEdgeCost(int id, double cost)
+{
+	if(m_edges.contains(id))
+		m_edges[id].cost = cost;
+}
+
+void GraphModel::setConstraints(const QList<ModelConstraint> &constraints)
+{
+	m_constraints = constraints;
+}
+
+bool GraphModel::isConstraintValid(const ModelConstraint &constraint) const
+{
+	const QList<int> &ids = constraint.nodeIds;
+
+	if(constraint.type == ModelConstraint::ExclusiveEdges)
+		return ids.size() == 4 && findEdge(ids.at(0), ids.at(1)) != -1 && findEdge(ids.at(2), ids.at(3)) != -1;
+
+	if(ids.size() < 2)
+		return false;
+
+	for(int i = 1; i < ids.size(); ++i)
+		if(findEdge(ids.at(i - 1), ids.at(i)) == -1)
+			return false;
+
+	return true;
+}
+
+void GraphModel::setNodeSelected(int id, bool selected)
+{
+	if(m_nodes.contains(id))
+		m_nodes[id].selected = selected;
+}
+
+void GraphModel::setNodeHighlighted(int id, bool highlighted)
+{
+	if(m_nodes.contains(id))
+		m_nodes[id].highlighted = highlighted;
+}
+
+void GraphModel::setEdgeSelected(int id, bool selected)
+{
+	if(m_edges.contains(id))
+		m_edges[id].selected = selected;
+}
+
+void GraphModel::setEdgeHighlighted(int id, bool highlighted)
+{
+	if(m_edges.contains(id))
+		m_edges[id].highlighted = highlighted;
+}
+
+QList<int> GraphModel::nodeIds() const
+{
+	QList<int> ids = m_nodes.keys();
+	qSort(ids);
+
+	return ids;
+}
+
+QList<int> GraphModel::edgeIds() const
+{
+	QList<int> ids = m_edges.keys();
+	qSort(ids);
+
+	return ids;
+}
+
+QList<int> GraphModel::selectedNodeIds() const
+{
+	QList<int> ids;
+
+	foreach(const ModelNode &node, m_nodes)
+		if(node.selected)
+			ids.append(node.id);
+
+	return ids;
+}
+
+QList<int> GraphModel::selectedEdgeIds() const
+{
+	QList<int> ids;
+
+	foreach(const ModelEdge &edge, m_edges)
+		if(edge.selected)
+			ids.append(edge.id);
+
+	return ids;
+}
+
+QRectF GraphModel::nodeRect(int id) const
+{
+	const ModelNode &node = *m_nodes.constFind(id);
+
+	return node.bounds.translated(node.pos);
+}
+
+QRectF GraphModel::edgeRect(int id) const
+{
+	const ModelEdge &edge = *m_edges.constFind(id);
+
+	QRectF from(nodeRect(edge.fromNodeId));
+	QRectF to(nodeRect(edge.toNodeId));
+
+	// a recursive edge is drawn as an arc sticking out of the node
+	if(edge.fromNodeId == edge.toNodeId)
+		return from.adjusted(-from.width(), -from.height() / 2.0, 0, from.height() / 2.0);
+
+	return QRectF(from.center(), to.center()).normalized() | QRectF(from.center(), QSizeF(1.0, 1.0));
+}
+
+QRectF GraphModel::boundingRect() const
+{
+	return m_nodeIndex.boundingRect() | m_edgeIndex.boundingRect();
+}
+
+QRectF GraphModel::highlightedRect() const
+{
+	QRectF rect;
+
+	foreach(const ModelNode &node, m_nodes)
+		if(node.highlighted)
+			rect |= nodeRect(node.id);
+
+	foreach(const ModelEdge &edge, m_edges)
+		if(edge.highlighted)
+			rect |= edgeRect(edge.id);
+
+	return rect;
+}
+
+QList<int> GraphModel::nodesIn(const QRectF &rect) const
+{
+	return m_nodeIndex.query(rect);
+}
+
+QList<int> GraphModel::edgesIn(const QRectF &rect) const
+{
+	return m_edgeIndex.query(rect);
+}
+
+void GraphModel::clearSelection()
+{
+	QHash<int, ModelNode>::iterator nodeIt;
+
+	for(nodeIt = m_nodes.begin(); nodeIt != m_nodes.end(); ++nodeIt)
+		nodeIt.value().selected = false;
+
+	QHash<int, ModelEdge>::iterator edgeIt;
+
+	for(edgeIt = m_edges.begin(); edgeIt != m_edges.end(); ++edgeIt)
+		edgeIt.value().selected = false;
+}
+
+void GraphModel::clearHighlight()
+{
+	QHash<int, ModelNode>::iterator nodeIt;
+
+	for(nodeIt = m_nodes.begin(); nodeIt != m_nodes.end(); ++nodeIt)
+		nodeIt.value().highlighted = false;
+
+	QHash<int, ModelEdge>::iterator edgeIt;
+
+	for(edgeIt = m_edges.begin(); edgeIt != m_edges.end(); ++edgeIt)
+		edgeIt.value().highlighted = false;
+}
+
+void GraphModel::clear()
+{
+	m_nodes.clear();
+	m_edges.clear();
+	m_constraints.clear();
+	m_nodeIndex.clear();
+	m_edgeIndex.clear();
+
+	m_nextNodeId = 0;
+	m_nextEdgeId = 0;
+}
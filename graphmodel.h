@@ -0,0 +1,170 @@
+#ifndef GRAPHMODEL_H
+#define GRAPHMODEL_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QPointF>
+#include <QRectF>
+
+#include "graphnode.h"
+#include "graphspatialindex.h"
+
+namespace GraphModelTypes
+{
+	typedef struct
+	{
+		int id;
+		GraphNode::NodeType type;
+		QString label;
+		QPointF pos;
+		QRectF bounds;
+		bool selected;
+		bool highlighted;
+		QList<int> edgeIds;
+
+		// variables defined and used in the node, for the data flow criteria
+		QStringList defs;
+		QStringList uses;
+
+		// graph file of the function the node calls, relative to this graph's file
+		QString callee;
+	} ModelNode;
+
+	typedef struct
+	{
+		int id;
+		int fromNodeId;
+		int toNodeId;
+		bool selected;
+		bool highlighted;
+
+		// of executing the edge, for the cheapest test suite
+		double cost;
+	} ModelEdge;
+
+	/* A path the program can never take, or two edges no execution takes
+	   both of. Kept by node ids, an exclusive pair is from, to, from, to;
+	   a constraint naming a node or edge which is gone is ignored. */
+	struct ModelConstraint
+	{
+		enum ConstraintType { ForbiddenPath, ExclusiveEdges };
+
+		ConstraintType type;
+		QList<int> nodeIds;
+
+		ModelConstraint(ConstraintType constraintType = ForbiddenPath) : type(constraintType) {}
+
+		bool operator==(const ModelConstraint &other) const
+		{
+			return type == other.type && nodeIds == other.nodeIds;
+		}
+	};
+
+	/* Describes a single edit of the graph - enough to redo it
+	   and to know what has to be recomputed. */
+	struct GraphChange
+	{
+		enum ChangeType { NodeAdded, NodeRemoved, EdgeAdded, EdgeRemoved,
+				  NodeMoved, NodeRetyped, NodeRelabeled, NodeDataFlowChanged,
+				  NodeCalleeChanged, ConstraintsChanged, EdgeCostChanged };
+
+		ChangeType type;
+		int nodeId;
+		int edgeId;
+
+		QString label;
+		GraphNode::NodeType nodeType;
+		QPointF pos;
+		int fromNodeId;
+		int toNodeId;
+		QStringList defs;
+		QStringList uses;
+		QString callee;
+		QList<ModelConstraint> constraints;
+		double cost;
+
+		GraphChange(ChangeType changeType = NodeAdded)
+			: type(changeType), nodeId(-1), edgeId(-1),
+			  nodeType(GraphNode::NormalNode), fromNodeId(-1), toNodeId(-1), cost(1.0) {}
+	};
+}
+
+/* Plain graph data, independent of QGraphicsItems. The scene only keeps
+   items for the part of the model which is currently visible.
+*/
+class GraphModel
+{
+	public:
+		GraphModel();
+
+		int addNode(const QString &label, GraphNode::NodeType type, const QPointF &pos, int id = -1);
+		void removeNode(int id);
+
+		int addEdge(int fromNodeId, int toNodeId, int id = -1);
+		void removeEdge(int id);
+
+		bool hasNode(int id) const { return m_nodes.contains(id); }
+		bool hasEdge(int id) const { return m_edges.contains(id); }
+		int findEdge(int fromNodeId, int toNodeId) const;
+
+		const GraphModelTypes::ModelNode &node(int id) const;
+		const GraphModelTypes::ModelEdge &edge(int id) const;
+
+		void setNodePos(int id, const QPointF &pos);
+		void setNodeBounds(int id, const QRectF &bounds);
+		void setNodeLabel(int id, const QString &label);
+		void setNodeType(int id, GraphNode::NodeType type);
+		void setNodeDataFlow(int id, const QStringList &defs, const QStringList &uses);
+		void setNodeCallee(int id, const QString &callee);
+		void setNodeSelected(int id, bool selected);
+		void setNodeHighlighted(int id, bool highlighted);
+		void setEdgeCost(int id, double cost);
+		void setEdgeSelected(int id, bool selected);
+		void setEdgeHighlighted(int id, bool highlighted);
+
+		const QList<GraphModelTypes::ModelConstraint> &constraints() const { return m_constraints; }
+		void setConstraints(const QList<GraphModelTypes::ModelConstraint> &constraints);
+
+		// whether all the nodes and edges of the constraint still exist
+		bool isConstraintValid(const GraphModelTypes::ModelConstraint &constraint) const;
+
+		QList<int> nodeIds() const;
+		QList<int> edgeIds() const;
+		QList<int> selectedNodeIds() const;
+		QList<int> selectedEdgeIds() const;
+
+		int nodeCount() const { return m_nodes.size(); }
+		int edgeCount() const { return m_edges.size(); }
+		bool isEmpty() const { return m_nodes.isEmpty(); }
+
+		QRectF nodeRect(int id) const;
+		QRectF edgeRect(int id) const;
+		QRectF boundingRect() const;
+		QRectF highlightedRect() const;
+
+		QList<int> nodesIn(const QRectF &rect) const;
+		QList<int> edgesIn(const QRectF &rect) const;
+
+		void clearSelection();
+		void clearHighlight();
+		void clear();
+
+		static QRectF defaultNodeBounds() { return QRectF(-5.0, -5.0, 40.0, 36.0); }
+
+	private:
+		QHash<int, GraphModelTypes::ModelNode> m_nodes;
+		QHash<int, GraphModelTypes::ModelEdge> m_edges;
+		QList<GraphModelTypes::ModelConstraint> m_constraints;
+
+		GraphSpatialIndex m_nodeIndex;
+		GraphSpatialIndex m_edgeIndex;
+
+		int m_nextNodeId;
+		int m_nextEdgeId;
+
+		void updateNodeGeometry(int id);
+};
+
+#endif // GRAPHMODEL_H
@@ -18,6 +18,7 @@ GraphNode::GraphNode(const QString &text, QGraphicsItem *parent, QGraphicsScene
 	initSettings();
 
 	m_highlight = false;
+	m_modelId = -1;
 
 	setNodeType(NormalNode);
 
@@ -108,6 +109,20 @@ const QString GraphNode::label() const
 	return m_nodeText->toPlainText();
 }
 
+void GraphNode::setLabel(const QString &label)
+{
+	m_nodeText->setPlainText(label);
+	setBoundingRect(m_nodeText->boundingRect());
+}
+
+void GraphNode::notifyScene()
+{
+	GraphScene *graphScene = qobject_cast<GraphScene*>(scene());
+
+	if(graphScene != 0)
+		graphScene->nodeItemChanged(this);
+}
+
 
 void GraphNode::setNodeType(enum NodeType type)
 {
@@ -140,6 +155,7 @@ void GraphNode::setBoundingRect(const QRectF &rect)
 void GraphNode::nodeTextKeyPressed()
 {
 	setBoundingRect(m_nodeText->boundingRect());
+	notifyScene();
 }
 
 void GraphNode::mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event)
@@ -196,7 +212,14 @@ void GraphNode::nodeTextLostFocus()
 QVariant GraphNode::itemChange(GraphicsItemChange change, const QVariant &value)
 {
 	if(change == QGraphicsItem::ItemPositionHasChanged)
+	{
 		updateEdgesPositions();
+		notifyScene();
+	}
+	else if(change == QGraphicsItem::ItemSelectedHasChanged)
+	{
+		notifyScene();
+	}
 
 	return value;
 }
@@ -38,6 +38,10 @@ class GraphNode : public QObject, public QGraphicsPolygonItem
 
 		NodeType nodeType() { return m_nodeType; }
 		const QString label() const;
+		void setLabel(const QString &label);
+
+		int modelId() const { return m_modelId; }
+		void setModelId(int id) { m_modelId = id; }
 
 		void updateEdgesPositions();
 
@@ -76,7 +80,10 @@ class GraphNode : public QObject, public QGraphicsPolygonItem
 
 		bool m_highlight;
 
+		int m_modelId;
+
 		void initSettings();
+		void notifyScene();
 
 	protected:
 		void mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event);
@@ -0,0 +1,218 @@
+#include "graphpainter.h"
+
+#include <QSettings>
+#include <QPen>
+#include <QBrush>
+#include <QtAlgorithms>
+
+#include <math.h>
+
+using namespace GraphModelTypes;
+
+GraphPainter::GraphPainter(const GraphModel &model)
+	: m_model(model), m_onlyHighlighted(false)
+{
+	QSettings settings;
+
+	m_normalNodeColor = settings.value("normalNodeColor").toString();
+	m_startNodeColor = settings.value("startNodeColor").toString();
+	m_endNodeColor = settings.value("endNodeColor").toString();
+	m_startEndNodeColor = settings.value("startEndNodeColor").toString();
+	m_highlightColor = settings.value("highlightColor").toString();
+
+	// the same as in GraphNode and GraphEdge
+	m_penWidth = 4.0;
+	m_arrowSize = 15.0;
+	m_padding = 5.0;
+	m_rounding = 15.0;
+}
+
+void GraphPainter::itemsIn(const QRectF &sceneRect, QList<int> &edgeIds, QList<int> &nodeIds) const
+{
+	QList<int> foundEdges = m_model.edgesIn(sceneRect);
+	QList<int> foundNodes = m_model.nodesIn(sceneRect);
+
+	// keep the output stable no matter how the index returns things
+	qSort(foundEdges);
+	qSort(foundNodes);
+
+	edgeIds.clear();
+	nodeIds.clear();
+
+	// highlighted edges are brought to front in the scene too
+	if(!m_onlyHighlighted)
+		foreach(int id, foundEdges)
+			if(!m_model.edge(id).highlighted)
+				edgeIds.append(id);
+
+	foreach(int id, foundEdges)
+		if(m_model.edge(id).highlighted)
+			edgeIds.append(id);
+
+	foreach(int id, foundNodes)
+		if(!m_onlyHighlighted || m_model.node(id).highlighted)
+			nodeIds.append(id);
+}
+
+void GraphPainter::paint(QPainter *painter, const QRectF &sceneRect) const
+{
+	QList<int> edgeIds;
+	QList<int> nodeIds;
+
+	itemsIn(sceneRect, edgeIds, nodeIds);
+
+	painter->save();
+
+	foreach(int id, edgeIds)
+		paintEdge(painter, m_model.edge(id));
+
+	foreach(int id, nodeIds)
+		paintNode(painter, m_model.node(id));
+
+	painter->restore();
+}
+
+QColor GraphPainter::nodeFillColor(const ModelNode &node) const
+{
+	QColor color;
+
+	switch(node.type)
+	{
+		case GraphNode::NormalNode: color = m_normalNodeColor; break;
+		case GraphNode::StartNode: color = m_startNodeColor; break;
+		case GraphNode::EndNode: color = m_endNodeColor; break;
+		case GraphNode::StartEndNode: color = m_startEndNodeColor; break;
+	}
+
+	color.setAlpha(200);
+
+	return color;
+}
+
+QColor GraphPainter::nodeBorderColor(const ModelNode &node) const
+{
+	if(node.highlighted)
+		return m_highlightColor;
+
+	switch(node.type)
+	{
+		case GraphNode::StartNode: return m_startNodeColor;
+		case GraphNode::EndNode: return m_endNodeColor;
+		case GraphNode::StartEndNode: return m_startEndNodeColor;
+		default: ;
+	}
+
+	return Qt::black;
+}
+
+QColor GraphPainter::edgeColor(const ModelEdge &edge) const
+{
+	if(edge.highlighted)
+		return m_highlightColor;
+
+	return Qt::black;
+}
+
+bool GraphPainter::edgeLine(const ModelEdge &edge, QLineF &line, QPolygonF &arrowHead) const
+{
+	QRectF fromRect(m_model.nodeRect(edge.fromNodeId));
+	QRectF toRect(m_model.nodeRect(edge.toNodeId));
+
+	// GraphEdge doesn't draw edges between overlapping nodes either
+	if(fromRect.intersects(toRect))
+		return false;
+
+	QLineF centerLine(fromRect.center(), toRect.center());
+	line = QLineF(findRectIntersection(toRect, centerLine), findRectIntersection(fromRect, centerLine));
+
+	double angle = ::acos(line.dx() / line.length());
+
+	if(line.dy() >= 0)
+		angle = (M_PI * 2) - angle;
+
+	QPointF arrowP1 = line.p1() + QPointF(sin(angle + M_PI / 3) * m_arrowSize,
+					      cos(angle + M_PI / 3) * m_arrowSize);
+	QPointF arrowP2 = line.p1() + QPointF(sin(angle + M_PI - M_PI / 3) * m_arrowSize,
+					      cos(angle + M_PI - M_PI / 3) * m_arrowSize);
+
+	arrowHead.clear();
+	arrowHead << line.p1() << arrowP1 << arrowP2;
+
+	return true;
+}
+
+void GraphPainter::edgeArc(const ModelEdge &edge, QRectF &arcRect, int &startAngle, int &spanAngle) const
+{
+	QRectF nodeRect(m_model.nodeRect(edge.fromNodeId));
+
+	qreal margin = m_penWidth * 2.0;
+	QSizeF size(nodeRect.width() / 2.0 + margin, nodeRect.height() + margin);
+
+	arcRect = QRectF();
+	arcRect.setSize(size);
+	arcRect.moveCenter(QPointF(nodeRect.left(), nodeRect.top() + nodeRect.height() / 2.0));
+
+	qreal angle = asin(nodeRect.height() / size.height()) / M_PI * 180.0;
+
+	startAngle = (int)(angle * 16);
+	spanAngle = (int)((360 - 2 * angle) * 16);
+}
+
+void GraphPainter::paintNode(QPainter *painter, const ModelNode &node) const
+{
+	QRectF rect(m_model.nodeRect(node.id));
+
+	painter->setPen(QPen(nodeBorderColor(node), m_penWidth));
+	painter->setBrush(QBrush(nodeFillColor(node), Qt::SolidPattern));
+	painter->drawRoundedRect(rect, m_rounding, m_rounding, Qt::AbsoluteSize);
+
+	painter->setPen(Qt::black);
+	painter->drawText(rect.adjusted(m_padding, m_padding, -m_padding, -m_padding),
+			  Qt::AlignCenter, node.label);
+}
+
+void GraphPainter::paintEdge(QPainter *painter, const ModelEdge &edge) const
+{
+	QColor color(edgeColor(edge));
+
+	painter->setPen(QPen(color, m_penWidth, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+	painter->setBrush(color);
+
+	if(edge.fromNodeId == edge.toNodeId)
+	{
+		QRectF arcRect;
+		int startAngle, spanAngle;
+
+		edgeArc(edge, arcRect, startAngle, spanAngle);
+
+		painter->setBrush(Qt::NoBrush);
+		painter->drawArc(arcRect, startAngle, spanAngle);
+
+		return;
+	}
+
+	QLineF line;
+	QPolygonF arrowHead;
+
+	if(!edgeLine(edge, line, arrowHead))
+		return;
+
+	painter->drawLine(line);
+	painter->drawPolygon(arrowHead);
+}
+
+QPointF GraphPainter::findRectIntersection(const QRectF &rect, const QLineF &line)
+{
+	QPointF corners[4] = { rect.topLeft(), rect.topRight(), rect.bottomRight(), rect.bottomLeft() };
+
+	for(int i = 0; i < 4; ++i)
+	{
+		QLineF side(corners[i], corners[(i + 1) % 4]);
+		QPointF point;
+
+		if(side.intersect(line, &point) == QLineF::BoundedIntersection)
+			return point;
+	}
+
+	return line.p1();
+}
@@ -0,0 +1,60 @@
+#ifndef GRAPHPAINTER_H
+#define GRAPHPAINTER_H
+
+#include <QPainter>
+#include <QRectF>
+#include <QLineF>
+#include <QColor>
+#include <QPolygonF>
+#include <QList>
+
+#include "graphmodel.h"
+
+/* Draws the graph straight from the model, the way GraphNode and GraphEdge
+   draw themselves. It needs no graphics items, so it can be used for any
+   part of the graph and from worker threads (it only reads the model).
+*/
+class GraphPainter
+{
+	public:
+		GraphPainter(const GraphModel &model);
+
+		void setOnlyHighlighted(bool onlyHighlighted) { m_onlyHighlighted = onlyHighlighted; }
+		void paint(QPainter *painter, const QRectF &sceneRect) const;
+
+		void itemsIn(const QRectF &sceneRect, QList<int> &edgeIds, QList<int> &nodeIds) const;
+
+		QColor nodeFillColor(const GraphModelTypes::ModelNode &node) const;
+		QColor nodeBorderColor(const GraphModelTypes::ModelNode &node) const;
+		QColor edgeColor(const GraphModelTypes::ModelEdge &edge) const;
+
+		bool edgeLine(const GraphModelTypes::ModelEdge &edge, QLineF &line, QPolygonF &arrowHead) const;
+		void edgeArc(const GraphModelTypes::ModelEdge &edge, QRectF &arcRect, int &startAngle, int &spanAngle) const;
+
+		qreal penWidth() const { return m_penWidth; }
+		qreal padding() const { return m_padding; }
+		qreal rounding() const { return m_rounding; }
+		qreal margin() const { return m_penWidth + m_arrowSize; }
+
+	private:
+		const GraphModel &m_model;
+		bool m_onlyHighlighted;
+
+		QColor m_normalNodeColor;
+		QColor m_startNodeColor;
+		QColor m_endNodeColor;
+		QColor m_startEndNodeColor;
+		QColor m_highlightColor;
+
+		qreal m_penWidth;
+		qreal m_arrowSize;
+		qreal m_padding;
+		qreal m_rounding;
+
+		void paintNode(QPainter *painter, const GraphModelTypes::ModelNode &node) const;
+		void paintEdge(QPainter *painter, const GraphModelTypes::ModelEdge &edge) const;
+
+		static QPointF findRectIntersection(const QRectF &rect, const QLineF &line);
+};
+
+#endif // GRAPHPAINTER_H
@@ -6,25 +6,34 @@
 #include <QApplication>
 #include <QLabel>
 #include <QListWidgetItem>
+#include <QSettings>
+#include <QSet>
+#include <QDir>
+#include <QDesktopServices>
+#include <QTime>
 
 using namespace Algorithm;
 
 GraphProxy::GraphProxy(GraphScene *graphScene, QListWidget *requirementsList, QListWidget *coverageList)
-	: m_graphScene(graphScene), m_requirementsList(requirementsList), m_coverageList(coverageList)
+	: m_graphScene(graphScene), m_dominance(0), m_graphVersion(0), m_requirementsList(requirementsList), m_coverageList(coverageList),
+	  m_portfolio(0)
 {
 	connect(m_requirementsList, SIGNAL(currentRowChanged(int)), this, SLOT(requirementsListItemActivated(int)));
 	connect(m_coverageList, SIGNAL(currentRowChanged(int)), this, SLOT(coverageListItemActivated(int)));
+	connect(m_graphScene, SIGNAL(graphEdited(GraphModelTypes::GraphChange)),
+		this, SLOT(graphEdited(GraphModelTypes::GraphChange)));
 
 	m_invalidated = true;
+	m_coverageLowerBound = 0;
+	m_objective = FewestPaths;
+	m_suiteCost = 0;
+	m_truncation = ResourceBudget::NoLimit;
+	m_constraintsIgnored = false;
 }
 
-Node *GraphProxy::findCorrespondingNode(GraphNode *graphNode)
+Node *GraphProxy::findCorrespondingNode(int nodeId)
 {
-	foreach(Node *node, m_nodes)
-		if(node->graphNode() == graphNode)
-			return node;
-
-	return 0;
+	return m_nodesById.value(nodeId);
 }
 
 bool GraphProxy::hasStartNode()
@@ -61,7 +70,8 @@ QStringList GraphProxy::unreachableEndNodeLabels()
 		   node->type() == GraphNode::StartEndNode)
 			continue;
 
-		if(!Algorithm::Path::isEndReachable(node))
+		// the post-dominator tree holds exactly the nodes which reach an end
+		if(!dominance()->canReachEnd(node))
 			list << node->label();
 	}
 
@@ -78,16 +88,32 @@ QStringList GraphProxy::unreachableStartNodeLabels()
 		   node->type() == GraphNode::StartEndNode)
 			continue;
 
-		if(node->distanceToNearestStartNode() == -1)
+		if(!dominance()->isReachableFromStart(node))
 			list << node->label();
 	}
 
 	return list;
 }
 
+const Dominance *GraphProxy::dominance()
+{
+	if(m_dominance == 0)
+		m_dominance = new Dominance(m_nodes);
+
+	return m_dominance;
+}
+
 void GraphProxy::invalidateScene()
 {
 	m_invalidated = true;
+	m_graphVersion++;
+}
+
+void GraphProxy::graphEdited(const GraphModelTypes::GraphChange &change)
+{
+	m_pendingChanges.append(change);
+	m_invalidated = true;
+	m_graphVersion++;
 }
 
 void GraphProxy::clear()
@@ -99,30 +125,19 @@ void GraphProxy::clear()
 void GraphProxy::convertNodes()
 {
 	clear();
+	m_pendingChanges.clear();
 
-	foreach(QGraphicsItem *item, m_graphScene->items())
-		if(item->type() == GraphNode::Type)
-		{
-			GraphNode *graphNode = qgraphicsitem_cast<GraphNode*>(item);
-			Node *node = new Node(graphNode);
+	m_nodes = nodesFromModel(m_graphScene->model());
 
-			m_nodes.append(node);
-		}
-
-	foreach(QGraphicsItem *item, m_graphScene->items())
-		if(item->type() == GraphEdge::Type)
-		{
-			GraphEdge *graphEdge = qgraphicsitem_cast<GraphEdge*>(item);
-
-			Node *fromNode = findCorrespondingNode(graphEdge->fromNode());
-			Node *toNode = findCorrespondingNode(graphEdge->toNode());
-
-			if(fromNode->type() == GraphNode::EndNode)
-				m_invalidEndNodes << fromNode->label();
+	foreach(Node *node, m_nodes)
+	{
+		m_nodesById.insert(node->id(), node);
 
-			fromNode->addLink(toNode, graphEdge);
-			toNode->addBackLink(fromNode);
-		}
+		// one entry for every edge leaving an end node
+		if(node->type() == GraphNode::EndNode)
+			for(int i = 0; i < node->linkCount(); ++i)
+				m_invalidEndNodes << node->label();
+	}
 }
 
 const QList<Algorithm::Node*> &GraphProxy::nodes() const
@@ -132,13 +147,7 @@ const QList<Algorithm::Node*> &GraphProxy::nodes() const
 
 void GraphProxy::clearHighlight()
 {
-	foreach(QGraphicsItem *item, m_graphScene->items())
-	{
-		if(item->type() == GraphNode::Type)
-			qgraphicsitem_cast<GraphNode*>(item)->clearHighlight();
-		else if(item->type() == GraphEdge::Type)
-			qgraphicsitem_cast<GraphEdge*>(item)->clearHighlight();
-	}
+	m_graphScene->clearHighlight();
 }
 
 void GraphProxy::highlightPath(const Path &path)
@@ -147,21 +156,21 @@ void GraphProxy::highlightPath(const Path &path)
 
 	foreach(Node *node, path.nodes())
 	{
-		node->graphNode()->highlight();
+		m_graphScene->highlightNode(node->id());
 	}
 
 	for(int i = 0; i < (path.nodes().size() - 1); ++i)
 	{
-		GraphEdge *edge = path.nodes().at(i)->getGraphEdgeToNode(path.nodes().at(i + 1));
+		int edgeId = path.nodes().at(i)->edgeIdToNode(path.nodes().at(i + 1));
 
 #ifdef DEBUG
-		if(edge == 0)
+		if(edgeId == -1)
 			qDebug() << "highlightPath: invalidPath: edge(" +
 					path.nodes().at(i)->label() + "->" +
 					path.nodes().at(i + 1)->label() + ")";
 #endif
-		if(edge != 0)
-			edge->highlight();
+		if(edgeId != -1)
+			m_graphScene->highlightEdge(edgeId);
 
 	}
 }
@@ -237,12 +246,19 @@ void GraphProxy::fillListsWithResults()
 
 	m_requirementsList->clear();
 
+	QSet<Path*> infeasible = m_infeasibleResults.toSet();
+
 	foreach(Path *path, m_reqResults)
 	{
 		//m_requirementsList->addItem(path->toText());
 
+		QString text = path->toRichText();
+
+		if(infeasible.contains(path))
+			text = tr("<font color=\"gray\">%1 (infeasible)</font>").arg(text);
+
 		QListWidgetItem *item = new QListWidgetItem();
-		QLabel *label = new QLabel(path->toRichText());
+		QLabel *label = new QLabel(text);
 		label->setTextFormat(Qt::RichText);
 		label->adjustSize();
 		item->setSizeHint(label->sizeHint());
@@ -254,12 +270,142 @@ void GraphProxy::fillListsWithResults()
 
 }
 
+ResourceBudget GraphProxy::budgetFromSettings()
+{
+	QSettings settings;
+	ResourceBudget budget;
+
+	budget.maxRequirements = settings.value("maxRequirements", 1000000).toInt();
+	budget.maxBytes = settings.value("maxRequirementsMemoryMB", 1024).toLongLong() * 1024 * 1024;
+	budget.timeLimit = settings.value("algorithmTimeLimit", 60000).toInt();
+
+	return budget;
+}
+
+TouringMode GraphProxy::touringFromSettings()
+{
+	QSettings settings;
+
+	return touringModeFromText(settings.value("touring", "direct").toString());
+}
+
+Objective GraphProxy::objectiveFromSettings()
+{
+	QSettings settings;
+
+	return objectiveFromText(settings.value("objective", "fewest").toString());
+}
+
+int GraphProxy::optimizationTimeFromSettings()
+{
+	QSettings settings;
+
+	return settings.value("optimizationTimeLimit", 0).toInt();
+}
+
+bool GraphProxy::portfolioFromSettings()
+{
+	QSettings settings;
+
+	return settings.value("portfolio", false).toBool();
+}
+
+bool GraphProxy::perRequirementFromSettings()
+{
+	QSettings settings;
+
+	return settings.value("perRequirement", false).toBool();
+}
+
+QString GraphProxy::portfolioWinner() const
+{
+	if(m_portfolio == 0 || m_portfolio->winner() == -1)
+		return QString();
+
+	return Portfolio::strategyText(m_portfolio->entries().at(m_portfolio->winner()).strategy);
+}
+
+void GraphProxy::recordPortfolio(const QString &graphFilename)
+{
+	if(m_portfolio == 0)
+		return;
+
+	QDir dir(QDesktopServices::storageLocation(QDesktopServices::DataLocation));
+	dir.mkpath(".");
+
+	m_portfolio->appendRecord(dir.filePath("portfolio.csv"), graphFilename, m_criterion);
+}
+
 void GraphProxy::runAlgorithm(AbstractAlgorithm &alg)
 {
-	alg.compute(m_nodes);
+	delete m_portfolio;
+	m_portfolio = 0;
+
+	bool raced = portfolioFromSettings();
+	ResourceBudget budget = budgetFromSettings();
+	PathConstraints constraints = constraintsFromModel(m_graphScene->model(), m_nodes);
+
+	alg.setBudget(budget);
+	alg.setTouring(touringFromSettings());
+	alg.setObjective(objectiveFromSettings());
+	alg.setOptimizationTime(optimizationTimeFromSettings());
+	alg.setOnePathPerRequirement(perRequirementFromSettings());
+	alg.setGraphVersion(m_graphVersion);
+	alg.setDominance(dominance(), m_graphVersion);
+	alg.setConstraints(constraints);
+
+	QTime timer;
+	timer.start();
+
+	alg.compute(m_nodes, !raced);
 
 	m_covResults = alg.coverageResults();
 	m_reqResults = alg.requirementsResults();
+	m_infeasibleResults = alg.infeasibleResults();
+	m_coverageLowerBound = alg.coverageLowerBound();
+	m_objective = alg.objective();
+	m_suiteCost = alg.suiteCost();
+	m_truncation = alg.truncation();
+	m_constraintsIgnored = alg.constraintsIgnored();
+
+	// requirements cut short by the time are not worth racing for
+	if(raced && !m_reqResults.isEmpty() && m_truncation != ResourceBudget::TimeLimit)
+	{
+		m_portfolio = new Portfolio(m_nodes, m_reqResults);
+
+		int searchTime = optimizationTimeFromSettings();
+
+		if(budget.timeLimit > 0)
+			budget.timeLimit = qMax(budget.timeLimit - timer.elapsed(), 1);
+
+		m_portfolio->setBudget(budget);
+		m_portfolio->setTouring(alg.touring());
+		m_portfolio->setObjective(alg.objective());
+		m_portfolio->setConstraints(constraints);
+		m_portfolio->setSearchTime(searchTime > 0 ? searchTime : (int)Portfolio::DefaultSearchTime);
+		m_portfolio->run();
+
+		int winner = m_portfolio->winner();
+
+		m_covResults = m_portfolio->coverageResults();
+		m_infeasibleResults.clear();
+		m_coverageLowerBound = qMax(m_coverageLowerBound, m_portfolio->lowerBound());
+		m_suiteCost = 0;
+
+		if(winner != -1)
+		{
+			const Portfolio::Entry &entry = m_portfolio->entries().at(winner);
+
+			foreach(int r, entry.infeasible)
+				m_infeasibleResults.append(m_reqResults.at(r));
+
+			m_suiteCost = entry.cost;
+			m_constraintsIgnored = entry.constraintsIgnored;
+
+			if(m_truncation == ResourceBudget::NoLimit)
+				m_truncation = entry.truncation;
+		}
+	}
 
 	fillListsWithResults();
 	m_invalidated = false;
@@ -270,24 +416,59 @@ void GraphProxy::runAlgorithm(AlgorithmType algorithmType)
 	switch(algorithmType)
 	{
 		case NodesAlg:
+			m_criterion = "nodes";
 			runAlgorithm(nodesAlgorithm);
 		break;
 
 		case EdgesAlg:
+			m_criterion = "edges";
 			runAlgorithm(edgesAlgorithm);
 		break;
 
 		case EdgePairAlg:
+			m_criterion = "edgepair";
 			runAlgorithm(edgePairAlgorithm);
 		break;
 
 		case SimplePathsAlg:
+			m_criterion = "simple";
 			runAlgorithm(simplePathsAlgorithm);
 		break;
 
 		case PrimePathsAlg:
+			m_criterion = "prime";
 			runAlgorithm(primePathsAlgorithm);
 		break;
+
+		case AllDefsAlg:
+			m_criterion = "alldefs";
+			runAlgorithm(allDefsAlgorithm);
+		break;
+
+		case AllUsesAlg:
+			m_criterion = "alluses";
+			runAlgorithm(allUsesAlgorithm);
+		break;
+
+		case AllDuPathsAlg:
+			m_criterion = "alldupaths";
+			runAlgorithm(allDuPathsAlgorithm);
+		break;
+
+		case BasisPathsAlg:
+			m_criterion = "basis";
+			runAlgorithm(basisPathsAlgorithm);
+		break;
+
+		case SimpleRoundTripAlg:
+			m_criterion = "simpleroundtrip";
+			runAlgorithm(simpleRoundTripAlgorithm);
+		break;
+
+		case CompleteRoundTripAlg:
+			m_criterion = "completeroundtrip";
+			runAlgorithm(completeRoundTripAlgorithm);
+		break;
 	}
 }
 
@@ -297,14 +478,21 @@ GraphProxy::~GraphProxy()
 	m_coverageList->clear();
 	m_requirementsList->clear();
 
+	delete m_portfolio;
+
 	clearNodes();
 }
 
 
 void GraphProxy::clearNodes()
 {
+	delete m_dominance;
+	m_dominance = 0;
+	m_graphVersion++;
+
 	foreach(Node *node, m_nodes)
 		delete node;
 
 	m_nodes.clear();
+	m_nodesById.clear();
 }
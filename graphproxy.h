@@ -2,6 +2,7 @@
 #define GRAPHPROXY_H
 
 #include <QList>
+#include <QHash>
 #include <QStringList>
 #include <QListWidget>
 #include <QObject>
@@ -19,6 +20,14 @@
 #include "edgepairalgorithm.h"
 #include "simplepathsalgorithm.h"
 #include "primepathsalgorithm.h"
+#include "alldefsalgorithm.h"
+#include "allusesalgorithm.h"
+#include "alldupathsalgorithm.h"
+#include "basispathsalgorithm.h"
+#include "simpleroundtripalgorithm.h"
+#include "completeroundtripalgorithm.h"
+#include "dominatortree.h"
+#include "portfolio.h"
 
 class GraphProxy : public QObject
 {
@@ -27,9 +36,17 @@ class GraphProxy : public QObject
 	private:
 		GraphScene *m_graphScene;
 		QList<Algorithm::Node*> m_nodes;
+		QHash<int, Algorithm::Node*> m_nodesById;
+
+		// built on demand for the converted nodes
+		Algorithm::Dominance *m_dominance;
+
+		// counts the edits and conversions, the nodes and trees belong to one
+		int m_graphVersion;
 
 		QList<Algorithm::Path*> m_reqResults;
 		QList<Algorithm::Path*> m_covResults;
+		QList<Algorithm::Path*> m_infeasibleResults;
 
 		QStringList m_invalidEndNodes;
 
@@ -37,9 +54,21 @@ class GraphProxy : public QObject
 		QListWidget *m_coverageList;
 
 		bool m_invalidated;
+		int m_coverageLowerBound;
+		Algorithm::Objective m_objective;
+		double m_suiteCost;
+		Algorithm::ResourceBudget::Limit m_truncation;
+		bool m_constraintsIgnored;
+		QList<GraphModelTypes::GraphChange> m_pendingChanges;
+
+		// of the last run when it raced strategies, owns its test paths
+		Algorithm::Portfolio *m_portfolio;
+
+		// of the last run, named as on the command line
+		QString m_criterion;
 		bool m_listsLocked;
 
-		Algorithm::Node *findCorrespondingNode(GraphNode *graphNode);
+		Algorithm::Node *findCorrespondingNode(int nodeId);
 		bool isInvalidatedWarning();
 
 		Algorithm::NodesAlgorithm nodesAlgorithm;
@@ -47,12 +76,20 @@ class GraphProxy : public QObject
 		Algorithm::EdgePairAlgorithm edgePairAlgorithm;
 		Algorithm::SimplePathsAlgorithm simplePathsAlgorithm;
 		Algorithm::PrimePathsAlgorithm primePathsAlgorithm;
+		Algorithm::AllDefsAlgorithm allDefsAlgorithm;
+		Algorithm::AllUsesAlgorithm allUsesAlgorithm;
+		Algorithm::AllDuPathsAlgorithm allDuPathsAlgorithm;
+		Algorithm::BasisPathsAlgorithm basisPathsAlgorithm;
+		Algorithm::SimpleRoundTripAlgorithm simpleRoundTripAlgorithm;
+		Algorithm::CompleteRoundTripAlgorithm completeRoundTripAlgorithm;
 
 		void clear();
 		void clearNodes();
 
 	public:
-		enum AlgorithmType {NodesAlg, EdgesAlg, EdgePairAlg, SimplePathsAlg, PrimePathsAlg};
+		enum AlgorithmType {NodesAlg, EdgesAlg, EdgePairAlg, SimplePathsAlg, PrimePathsAlg,
+				    AllDefsAlg, AllUsesAlg, AllDuPathsAlg, BasisPathsAlg,
+				    SimpleRoundTripAlg, CompleteRoundTripAlg};
 
 		GraphProxy(GraphScene *graphScene, QListWidget *requirementsList, QListWidget *coverageList);
 		~GraphProxy();
@@ -67,6 +104,9 @@ class GraphProxy : public QObject
 
 		const QList<Algorithm::Node*> &nodes() const;
 
+		// dominator trees of the converted nodes, kept until they are converted again
+		const Algorithm::Dominance *dominance();
+
 		void clearHighlight();
 
 		void highlightPath(const Algorithm::Path &path);
@@ -74,10 +114,49 @@ class GraphProxy : public QObject
 		void fillListsWithResults();
 		void invalidateScene();
 
+		// edits made since the nodes were last converted
+		const QList<GraphModelTypes::GraphChange> &pendingChanges() const { return m_pendingChanges; }
+
 		void runAlgorithm(Algorithm::AbstractAlgorithm &alg);
 		void runAlgorithm(AlgorithmType algorithmType);
 
+		int coverageLowerBound() const { return m_coverageLowerBound; }
+
+		// of the last run
+		Algorithm::Objective objective() const { return m_objective; }
+		double suiteCost() const { return m_suiteCost; }
+
+		// requirements the constraints of the graph leave no test path for
+		int infeasibleCount() const { return m_infeasibleResults.size(); }
+
+		// set when the constraints were too many to build the test paths around
+		bool constraintsIgnored() const { return m_constraintsIgnored; }
+
+		// set when the last run hit a resource limit and its results are partial
+		Algorithm::ResourceBudget::Limit truncation() const { return m_truncation; }
+
+		// the strategy whose test paths were kept, empty when they were not raced
+		QString portfolioWinner() const;
+
+		/* Appends how the strategies of the last run did to portfolio.csv in
+		   the data location. */
+		void recordPortfolio(const QString &graphFilename);
+
+		static Algorithm::ResourceBudget budgetFromSettings();
+		static Algorithm::TouringMode touringFromSettings();
+		static Algorithm::Objective objectiveFromSettings();
+
+		// milliseconds for improving the test paths, 0 when they are not
+		static int optimizationTimeFromSettings();
+
+		// whether test paths are built by several strategies at once
+		static bool portfolioFromSettings();
+
+		// whether every requirement gets a shortest test path of its own
+		static bool perRequirementFromSettings();
+
 	private slots:
+		void graphEdited(const GraphModelTypes::GraphChange &change);
 		void coverageListItemActivated(int index);
 		void requirementsListItemActivated(int index);
 
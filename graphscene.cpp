@@ -6,6 +6,17 @@
 #include <QGraphicsView>
 #include <QGraphicsItem>
 #include <QMessageBox>
+#include <QSet>
+#include <QPair>
+
+#include "graphcommands.h"
+
+/* Items are kept for the visible rectangle grown by this part of its size,
+   so that panning a bit doesn't need new items right away. */
+#define VISIBLE_MARGIN 0.5
+#define MAX_POOLED_ITEMS 512
+
+using namespace GraphModelTypes;
 
 GraphScene::GraphScene(QMenu *nodeMenu, QObject *parent)
 	: QGraphicsScene(parent), m_mode(Manipulate), m_nodeMenu(nodeMenu)
@@ -13,12 +24,20 @@ GraphScene::GraphScene(QMenu *nodeMenu, QObject *parent)
 	initSettings();
 	m_currentID = 0;
 	m_line = 0;
+	m_syncing = false;
+	m_undoStack = 0;
 
 	QColor tmpColor(m_insertingLineColor);
 	tmpColor.setAlpha(220);
 	m_insertingLinePen = QPen(QBrush(tmpColor), 4, Qt::SolidLine, Qt::RoundCap);
 }
 
+GraphScene::~GraphScene()
+{
+	qDeleteAll(m_nodePool);
+	qDeleteAll(m_edgePool);
+}
+
 void GraphScene::initSettings()
 {
 	m_insertingLineColor = m_settings.value("insertingLineColor").toString();
@@ -31,19 +50,737 @@ void GraphScene::setMode(Mode mode)
 
 void GraphScene::editorLostFocus(GraphNode *node)
 {
-	if(node->label().isEmpty())
+	int id = node->modelId();
+
+	if(id == -1)
+		return;
+
+	QString oldLabel(m_model.node(id).label);
+	QString label(node->label());
+
+	if(label == oldLabel)
+		return;
+
+	/* We are called from within the node, so it can't be taken
+	   out of the scene until the event is over. */
+	if(label.isEmpty())
+	{
+		QMetaObject::invokeMethod(this, "deleteEmptyNode", Qt::QueuedConnection, Q_ARG(int, id));
+		return;
+	}
+
+	pushCommand(new SetNodeLabelCommand(this, id, oldLabel, label));
+}
+
+void GraphScene::deleteEmptyNode(int id)
+{
+	if(!m_model.hasNode(id))
+		return;
+
+	pushCommand(new DeleteNodeCommand(this, id));
+}
+
+void GraphScene::pushCommand(QUndoCommand *command)
+{
+	if(m_undoStack != 0)
 	{
-		removeItem(node);
-		node->deleteLater();
+		m_undoStack->push(command);
+		return;
+	}
+
+	command->redo();
+	delete command;
+}
+
+GraphNode *GraphScene::acquireNodeItem(int id)
+{
+	GraphNode *item;
+
+	if(!m_nodePool.isEmpty())
+	{
+		item = m_nodePool.takeLast();
+	}
+	else
+	{
+		item = new GraphNode(QString());
+
+		connect(item, SIGNAL(lostFocus(GraphNode*)), this, SLOT(editorLostFocus(GraphNode*)));
+		connect(item, SIGNAL(dragFinish()), this, SLOT(nodeDragged()));
 	}
+
+	const ModelNode &node = m_model.node(id);
+
+	m_syncing = true;
+
+	item->setModelId(id);
+	item->setLabel(node.label);
+	item->clearHighlight();
+	item->setNodeType(node.type);
+	item->setPos(node.pos);
+	item->setToolTip(nodeToolTip(node));
+
+	addItem(item);
+
+	item->setSelected(node.selected);
+
+	if(node.highlighted)
+		item->highlight();
+
+	m_syncing = false;
+
+	m_model.setNodeBounds(id, item->boundingRect());
+	m_nodeItems.insert(id, item);
+
+	return item;
 }
 
-void GraphScene::addNode(GraphNode *node)
+QString GraphScene::nodeToolTip(const ModelNode &node)
 {
-	connect(node, SIGNAL(lostFocus(GraphNode*)), this, SLOT(editorLostFocus(GraphNode*)));
-	connect(node, SIGNAL(dragFinish()), this, SLOT(nodeDragged()));
+	QStringList lines;
+
+	if(!node.defs.isEmpty())
+		lines << tr("def: %1").arg(node.defs.join(", "));
+
+	if(!node.uses.isEmpty())
+		lines << tr("use: %1").arg(node.uses.join(", "));
+
+	if(!node.callee.isEmpty())
+		lines << tr("calls: %1").arg(node.callee);
+
+	return lines.join("\n");
+}
+
+QString GraphScene::edgeToolTip(const ModelEdge &edge)
+{
+	if(edge.cost == 1.0)
+		return QString();
+
+	return tr("cost: %1").arg(edge.cost);
+}
+
+GraphEdge *GraphScene::acquireEdgeItem(int id)
+{
+	const ModelEdge &edge = m_model.edge(id);
+
+	GraphNode *fromNode = m_nodeItems.value(edge.fromNodeId);
+	GraphNode *toNode = m_nodeItems.value(edge.toNodeId);
+
+	GraphEdge *item;
+
+	if(!m_edgePool.isEmpty())
+	{
+		item = m_edgePool.takeLast();
+		item->setNodes(fromNode, toNode);
+	}
+	else
+	{
+		item = new GraphEdge(fromNode, toNode);
+	}
+
+	m_syncing = true;
+
+	item->setModelId(id);
+
+	fromNode->addEdge(item);
+	toNode->addEdge(item);
+
+	addItem(item);
+
+	item->updatePosition();
+	item->clearHighlight();
+	item->setSelected(edge.selected);
+	item->setToolTip(edgeToolTip(edge));
+
+	if(edge.highlighted)
+		item->highlight();
+
+	m_syncing = false;
+
+	m_edgeItems.insert(id, item);
+
+	return item;
+}
+
+void GraphScene::releaseNodeItem(int id)
+{
+	GraphNode *item = m_nodeItems.take(id);
+
+	m_syncing = true;
+	removeItem(item);
+	m_syncing = false;
+
+	item->setModelId(-1);
+
+	if(m_nodePool.size() < MAX_POOLED_ITEMS)
+		m_nodePool.append(item);
+	else
+		delete item;
+}
+
+void GraphScene::releaseEdgeItem(int id)
+{
+	GraphEdge *item = m_edgeItems.take(id);
+
+	item->fromNode()->removeEdge(item);
+	item->toNode()->removeEdge(item);
+
+	m_syncing = true;
+	removeItem(item);
+	m_syncing = false;
+
+	item->setModelId(-1);
+
+	if(m_edgePool.size() < MAX_POOLED_ITEMS)
+		m_edgePool.append(item);
+	else
+		delete item;
+}
+
+bool GraphScene::isItemBusy(QGraphicsItem *item)
+{
+	QGraphicsItem *grabber = mouseGrabberItem();
+	QGraphicsItem *focused = focusItem();
+
+	if(grabber != 0 && (item == grabber || item->isAncestorOf(grabber) || item->isSelected()))
+		return true;
+
+	if(focused != 0 && (item == focused || item->isAncestorOf(focused)))
+		return true;
+
+	return false;
+}
+
+void GraphScene::setVisibleRect(const QRectF &rect)
+{
+	m_visibleRect = rect;
+	updateVisibleItems();
+}
+
+QRectF GraphScene::visibleArea() const
+{
+	QRectF area(m_visibleRect);
+
+	// the view hasn't told us anything yet
+	if(area.isEmpty())
+		area = sceneRect();
+
+	qreal margin = qMax(area.width(), area.height()) * VISIBLE_MARGIN;
+
+	return area.adjusted(-margin, -margin, margin, margin);
+}
+
+void GraphScene::materializeNode(int id)
+{
+	if(!m_nodeItems.contains(id))
+		acquireNodeItem(id);
+
+	foreach(int edgeId, m_model.node(id).edgeIds)
+	{
+		if(m_edgeItems.contains(edgeId))
+			continue;
+
+		const ModelEdge &edge = m_model.edge(edgeId);
+
+		if(m_nodeItems.contains(edge.fromNodeId) && m_nodeItems.contains(edge.toNodeId))
+			acquireEdgeItem(edgeId);
+	}
+}
+
+void GraphScene::updateVisibleItems()
+{
+	QRectF area(visibleArea());
+
+	QSet<int> wantedNodes = m_model.nodesIn(area).toSet();
+
+	foreach(int edgeId, m_model.edgesIn(area))
+	{
+		const ModelEdge &edge = m_model.edge(edgeId);
+
+		wantedNodes.insert(edge.fromNodeId);
+		wantedNodes.insert(edge.toNodeId);
+	}
+
+	QHash<int, GraphNode*>::const_iterator nodeIt;
+
+	for(nodeIt = m_nodeItems.constBegin(); nodeIt != m_nodeItems.constEnd(); ++nodeIt)
+		if(isItemBusy(nodeIt.value()))
+			wantedNodes.insert(nodeIt.key());
+
+	/* An edge item lives as long as the items of both its nodes do,
+	   so edges go first. */
+	foreach(int edgeId, m_edgeItems.keys())
+	{
+		const ModelEdge &edge = m_model.edge(edgeId);
+
+		if(!wantedNodes.contains(edge.fromNodeId) || !wantedNodes.contains(edge.toNodeId))
+			releaseEdgeItem(edgeId);
+	}
+
+	foreach(int nodeId, m_nodeItems.keys())
+		if(!wantedNodes.contains(nodeId))
+			releaseNodeItem(nodeId);
+
+	foreach(int nodeId, wantedNodes)
+		if(!m_nodeItems.contains(nodeId))
+			acquireNodeItem(nodeId);
+
+	foreach(int nodeId, wantedNodes)
+	{
+		foreach(int edgeId, m_model.node(nodeId).edgeIds)
+		{
+			if(m_edgeItems.contains(edgeId))
+				continue;
+
+			const ModelEdge &edge = m_model.edge(edgeId);
+
+			if(m_nodeItems.contains(edge.fromNodeId) && m_nodeItems.contains(edge.toNodeId))
+				acquireEdgeItem(edgeId);
+		}
+	}
+}
+
+void GraphScene::nodeItemChanged(GraphNode *node)
+{
+	int id = node->modelId();
+
+	if(m_syncing || id == -1)
+		return;
+
+	// the label gets into the model when editing is finished
+	m_model.setNodePos(id, node->pos());
+	m_model.setNodeBounds(id, node->boundingRect());
+	m_model.setNodeSelected(id, node->isSelected());
+}
+
+void GraphScene::edgeItemChanged(GraphEdge *edge)
+{
+	int id = edge->modelId();
+
+	if(m_syncing || id == -1)
+		return;
+
+	m_model.setEdgeSelected(id, edge->isSelected());
+}
+
+int GraphScene::insertNode(const QString &label, GraphNode::NodeType type, const QPointF &pos, int id)
+{
+	id = m_model.addNode(label, type, pos, id);
+
+	if(m_model.nodeRect(id).intersects(visibleArea()))
+		acquireNodeItem(id);
+
+	GraphChange change(GraphChange::NodeAdded);
+	change.nodeId = id;
+	change.label = label;
+	change.nodeType = type;
+	change.pos = pos;
+
+	emit graphEdited(change);
+
+	return id;
+}
+
+int GraphScene::insertEdge(int fromNodeId, int toNodeId, int id)
+{
+	id = m_model.addEdge(fromNodeId, toNodeId, id);
+
+	if(id == -1)
+		return -1;
+
+	// the edge may cross the view while its nodes are far away
+	if(m_model.edgeRect(id).intersects(visibleArea()))
+	{
+		materializeNode(fromNodeId);
+		materializeNode(toNodeId);
+	}
+	else if(m_nodeItems.contains(fromNodeId) && m_nodeItems.contains(toNodeId))
+	{
+		acquireEdgeItem(id);
+	}
+
+	GraphChange change(GraphChange::EdgeAdded);
+	change.edgeId = id;
+	change.fromNodeId = fromNodeId;
+	change.toNodeId = toNodeId;
+
+	emit graphEdited(change);
+
+	return id;
+}
+
+void GraphScene::removeNode(int id)
+{
+	if(!m_model.hasNode(id))
+		return;
+
+	foreach(int edgeId, m_model.node(id).edgeIds)
+		removeEdge(edgeId);
+
+	if(m_nodeItems.contains(id))
+		releaseNodeItem(id);
+
+	m_model.removeNode(id);
+
+	GraphChange change(GraphChange::NodeRemoved);
+	change.nodeId = id;
+
+	emit graphEdited(change);
+}
+
+void GraphScene::removeEdge(int id)
+{
+	if(!m_model.hasEdge(id))
+		return;
+
+	if(m_edgeItems.contains(id))
+		releaseEdgeItem(id);
+
+	m_model.removeEdge(id);
+
+	GraphChange change(GraphChange::EdgeRemoved);
+	change.edgeId = id;
+
+	emit graphEdited(change);
+}
+
+void GraphScene::moveNode(int id, const QPointF &pos)
+{
+	if(!m_model.hasNode(id))
+		return;
+
+	m_model.setNodePos(id, pos);
+
+	if(m_nodeItems.contains(id))
+	{
+		m_syncing = true;
+		m_nodeItems.value(id)->setPos(pos);
+		m_syncing = false;
+	}
+	else if(m_model.nodeRect(id).intersects(visibleArea()))
+	{
+		materializeNode(id);
+	}
+
+	GraphChange change(GraphChange::NodeMoved);
+	change.nodeId = id;
+	change.pos = pos;
 
-	addItem(node);
+	emit graphEdited(change);
+}
+
+void GraphScene::setNodeType(int id, GraphNode::NodeType type)
+{
+	if(!m_model.hasNode(id))
+		return;
+
+	m_model.setNodeType(id, type);
+
+	if(m_nodeItems.contains(id))
+		m_nodeItems.value(id)->setNodeType(type);
+
+	GraphChange change(GraphChange::NodeRetyped);
+	change.nodeId = id;
+	change.nodeType = type;
+
+	emit graphEdited(change);
+}
+
+void GraphScene::setNodeLabel(int id, const QString &label)
+{
+	if(!m_model.hasNode(id))
+		return;
+
+	m_model.setNodeLabel(id, label);
+
+	if(m_nodeItems.contains(id))
+	{
+		GraphNode *item = m_nodeItems.value(id);
+
+		if(item->label() != label)
+		{
+			m_syncing = true;
+			item->setLabel(label);
+			m_syncing = false;
+		}
+
+		m_model.setNodeBounds(id, item->boundingRect());
+	}
+
+	GraphChange change(GraphChange::NodeRelabeled);
+	change.nodeId = id;
+	change.label = label;
+
+	emit graphEdited(change);
+}
+
+void GraphScene::setNodeDataFlow(int id, const QStringList &defs, const QStringList &uses)
+{
+	if(!m_model.hasNode(id))
+		return;
+
+	m_model.setNodeDataFlow(id, defs, uses);
+
+	if(m_nodeItems.contains(id))
+		m_nodeItems.value(id)->setToolTip(nodeToolTip(m_model.node(id)));
+
+	GraphChange change(GraphChange::NodeDataFlowChanged);
+	change.nodeId = id;
+	change.defs = defs;
+	change.uses = uses;
+
+	emit graphEdited(change);
+}
+
+void GraphScene::setNodeCallee(int id, const QString &callee)
+{
+	if(!m_model.hasNode(id))
+		return;
+
+	m_model.setNodeCallee(id, callee);
+
+	if(m_nodeItems.contains(id))
+		m_nodeItems.value(id)->setToolTip(nodeToolTip(m_model.node(id)));
+
+	GraphChange change(GraphChange::NodeCalleeChanged);
+	change.nodeId = id;
+	change.callee = callee;
+
+	emit graphEdited(change);
+}
+
+void GraphScene::setEdgeCost(int id, double cost)
+{
+	if(!m_model.hasEdge(id))
+		return;
+
+	m_model.setEdgeCost(id, cost);
+
+	if(m_edgeItems.contains(id))
+		m_edgeItems.value(id)->setToolTip(edgeToolTip(m_model.edge(id)));
+
+	GraphChange change(GraphChange::EdgeCostChanged);
+	change.edgeId = id;
+	change.cost = cost;
+
+	emit graphEdited(change);
+}
+
+void GraphScene::setConstraints(const QList<ModelConstraint> &constraints)
+{
+	m_model.setConstraints(constraints);
+
+	GraphChange change(GraphChange::ConstraintsChanged);
+	change.constraints = constraints;
+
+	emit graphEdited(change);
+}
+
+int GraphScene::deleteSelected()
+{
+	QList<int> edgeIds = m_model.selectedEdgeIds();
+	QList<int> nodeIds = m_model.selectedNodeIds();
+
+	int deletedCount = edgeIds.size() + nodeIds.size();
+
+	if(deletedCount == 0)
+		return 0;
+
+	/* Every command is created right before it is pushed, so a node
+	   only remembers the edges which are still there. */
+	if(m_undoStack != 0)
+		m_undoStack->beginMacro(tr("delete %n item(s)", "", deletedCount));
+
+	foreach(int edgeId, edgeIds)
+		pushCommand(new DeleteEdgeCommand(this, edgeId));
+
+	foreach(int nodeId, nodeIds)
+		pushCommand(new DeleteNodeCommand(this, nodeId));
+
+	if(m_undoStack != 0)
+		m_undoStack->endMacro();
+
+	return deletedCount;
+}
+
+int GraphScene::setSelectedNodesType(GraphNode::NodeType type)
+{
+	QList<int> nodeIds = m_model.selectedNodeIds();
+
+	if(!nodeIds.isEmpty())
+		pushCommand(new SetNodeTypeCommand(this, nodeIds, type));
+
+	return nodeIds.size();
+}
+
+void GraphScene::setSelectedNodeDataFlow(const QStringList &defs, const QStringList &uses)
+{
+	QList<int> nodeIds = m_model.selectedNodeIds();
+
+	if(nodeIds.size() == 1)
+		pushCommand(new SetNodeDataFlowCommand(this, nodeIds.first(), defs, uses));
+}
+
+void GraphScene::setSelectedNodeCallee(const QString &callee)
+{
+	QList<int> nodeIds = m_model.selectedNodeIds();
+
+	if(nodeIds.size() == 1)
+		pushCommand(new SetNodeCalleeCommand(this, nodeIds.first(), callee));
+}
+
+int GraphScene::setSelectedEdgesCost(double cost)
+{
+	QList<int> edgeIds = m_model.selectedEdgeIds();
+
+	if(!edgeIds.isEmpty())
+		pushCommand(new SetEdgeCostCommand(this, edgeIds, cost));
+
+	return edgeIds.size();
+}
+
+bool GraphScene::forbidSelectedPath()
+{
+	QList<int> edgeIds = m_model.selectedEdgeIds();
+	QHash<int, int> edgeFrom;
+	QSet<int> targets;
+
+	foreach(int edgeId, edgeIds)
+	{
+		const ModelEdge &edge = m_model.edge(edgeId);
+
+		// two edges leaving a node are not one path
+		if(edgeFrom.contains(edge.fromNodeId))
+			return false;
+
+		edgeFrom.insert(edge.fromNodeId, edgeId);
+		targets.insert(edge.toNodeId);
+	}
+
+	QList<int> firstNodes;
+
+	foreach(int nodeId, edgeFrom.keys())
+		if(!targets.contains(nodeId))
+			firstNodes.append(nodeId);
+
+	if(firstNodes.size() != 1)
+		return false;
+
+	ModelConstraint constraint(ModelConstraint::ForbiddenPath);
+	constraint.nodeIds.append(firstNodes.first());
+
+	while(edgeFrom.contains(constraint.nodeIds.last()))
+		constraint.nodeIds.append(m_model.edge(edgeFrom.take(constraint.nodeIds.last())).toNodeId);
+
+	if(!edgeFrom.isEmpty())
+		return false;
+
+	QList<ModelConstraint> constraints = m_model.constraints();
+
+	if(!constraints.contains(constraint))
+	{
+		constraints.append(constraint);
+		pushCommand(new SetConstraintsCommand(this, constraints, tr("forbid a path")));
+	}
+
+	return true;
+}
+
+bool GraphScene::makeSelectedEdgesExclusive()
+{
+	QList<int> edgeIds = m_model.selectedEdgeIds();
+
+	if(edgeIds.size() != 2)
+		return false;
+
+	ModelConstraint constraint(ModelConstraint::ExclusiveEdges);
+
+	foreach(int edgeId, edgeIds)
+		constraint.nodeIds << m_model.edge(edgeId).fromNodeId << m_model.edge(edgeId).toNodeId;
+
+	QList<ModelConstraint> constraints = m_model.constraints();
+
+	if(!constraints.contains(constraint))
+	{
+		constraints.append(constraint);
+		pushCommand(new SetConstraintsCommand(this, constraints, tr("make two edges exclusive")));
+	}
+
+	return true;
+}
+
+int GraphScene::removeSelectedConstraints()
+{
+	QSet<QPair<int, int> > selected;
+
+	foreach(int edgeId, m_model.selectedEdgeIds())
+		selected.insert(qMakePair(m_model.edge(edgeId).fromNodeId, m_model.edge(edgeId).toNodeId));
+
+	QList<ModelConstraint> constraints;
+
+	foreach(const ModelConstraint &constraint, m_model.constraints())
+	{
+		bool touched = false;
+
+		// the edges of an exclusive pair are not consecutive
+		int step = constraint.type == ModelConstraint::ExclusiveEdges ? 2 : 1;
+
+		for(int i = 0; i + 1 < constraint.nodeIds.size() && !touched; i += step)
+			touched = selected.contains(qMakePair(constraint.nodeIds.at(i), constraint.nodeIds.at(i + 1)));
+
+		if(!touched)
+			constraints.append(constraint);
+	}
+
+	int removedCount = m_model.constraints().size() - constraints.size();
+
+	if(removedCount > 0)
+		pushCommand(new SetConstraintsCommand(this, constraints, tr("remove %n constraint(s)", "", removedCount)));
+
+	return removedCount;
+}
+
+void GraphScene::highlightNode(int id)
+{
+	m_model.setNodeHighlighted(id, true);
+
+	if(m_nodeItems.contains(id))
+		m_nodeItems.value(id)->highlight();
+}
+
+void GraphScene::highlightEdge(int id)
+{
+	m_model.setEdgeHighlighted(id, true);
+
+	if(m_edgeItems.contains(id))
+		m_edgeItems.value(id)->highlight();
+}
+
+void GraphScene::clearHighlight()
+{
+	m_model.clearHighlight();
+
+	foreach(GraphNode *node, m_nodeItems)
+		node->clearHighlight();
+
+	foreach(GraphEdge *edge, m_edgeItems)
+		edge->clearHighlight();
+}
+
+void GraphScene::clearGraph()
+{
+	m_dragStartPositions.clear();
+
+	clear();
+
+	m_nodeItems.clear();
+	m_edgeItems.clear();
+
+	qDeleteAll(m_nodePool);
+	qDeleteAll(m_edgePool);
+	m_nodePool.clear();
+	m_edgePool.clear();
+
+	m_model.clear();
 }
 
 void GraphScene::mousePressEvent(QGraphicsSceneMouseEvent *mouseEvent)
@@ -51,7 +788,7 @@ void GraphScene::mousePressEvent(QGraphicsSceneMouseEvent *mouseEvent)
 	if(mouseEvent->button() == Qt::LeftButton)
 	{
 		QPointF pos(mouseEvent->scenePos());
-		GraphNode *node;
+		QGraphicsItem *item;
 
 		switch(m_mode)
 		{
@@ -59,13 +796,21 @@ void GraphScene::mousePressEvent(QGraphicsSceneMouseEvent *mouseEvent)
 
 				m_currentID++;
 
-				node = new GraphNode(QString::number(m_currentID));
-				pos -= node->boundingRect().center();
-				node->setPos(pos);
+				pushCommand(new AddNodeCommand(this, QString::number(m_currentID), pos));
+			break;
 
-				addNode(node);
+			case Manipulate:
 
-				emit changed();
+				/* Qt only deselects the items it has, the model has to forget
+				   about the selection of those which are scrolled away. */
+				item = itemAt(pos);
+
+				if(item != 0 && item->type() == GraphNodeText::Type)
+					item = item->parentItem();
+
+				if(!(mouseEvent->modifiers() & Qt::ControlModifier) &&
+				   (item == 0 || !item->isSelected()))
+					m_model.clearSelection();
 			break;
 
 			case InsertEdge:
@@ -84,6 +829,21 @@ void GraphScene::mousePressEvent(QGraphicsSceneMouseEvent *mouseEvent)
 	}
 
 	QGraphicsScene::mousePressEvent(mouseEvent);
+
+	/* Whatever is selected now is what a drag would move,
+	   the move becomes one command when the button goes up. */
+	m_dragStartPositions.clear();
+
+	if(m_mode == Manipulate && mouseEvent->button() == Qt::LeftButton)
+	{
+		foreach(QGraphicsItem *item, selectedItems())
+		{
+			GraphNode *node = qgraphicsitem_cast<GraphNode*>(item);
+
+			if(node != 0 && node->modelId() != -1)
+				m_dragStartPositions.insert(node->modelId(), node->pos());
+		}
+	}
 }
 
 void GraphScene::mouseMoveEvent(QGraphicsSceneMouseEvent *mouseEvent)
@@ -129,23 +889,10 @@ void GraphScene::mouseReleaseEvent(QGraphicsSceneMouseEvent *mouseEvent)
 				GraphNode *startNode = qgraphicsitem_cast<GraphNode*>(startItems.first());
 				GraphNode *endNode = qgraphicsitem_cast<GraphNode*>(endItems.first());
 
-				if(startNode->hasEdge(endNode))
-				{
+				if(m_model.findEdge(startNode->modelId(), endNode->modelId()) != -1)
 					QMessageBox::warning(0, tr("Warning"), tr("Such edge already exists!"));
-				}
 				else
-				{
-					GraphEdge *edge = new GraphEdge(startNode, endNode);
-
-					startNode->addEdge(edge);
-					endNode->addEdge(edge);
-
-					addItem(edge);
-
-					edge->updatePosition();
-
-					emit changed();
-				}
+					pushCommand(new AddEdgeCommand(this, startNode->modelId(), endNode->modelId()));
 			}
 
 		removeItem(m_line);
@@ -156,45 +903,60 @@ void GraphScene::mouseReleaseEvent(QGraphicsSceneMouseEvent *mouseEvent)
 	m_line = 0;
 
 	QGraphicsScene::mouseReleaseEvent(mouseEvent);
-}
-
-void GraphScene::storeToMemento(GraphSceneMemento &memento)
-{
-	QList<GraphNode*> nodes;
-	QList<GraphEdge*> edges;
 
-	foreach(QGraphicsItem *item, items())
+	if(m_mode == Manipulate && mouseEvent->button() == Qt::LeftButton && !m_dragStartPositions.isEmpty())
 	{
-		if(item->type() == GraphNode::Type)
-			nodes.append(qgraphicsitem_cast<GraphNode*>(item));
-		else if(item->type() == GraphEdge::Type)
-			edges.append(qgraphicsitem_cast<GraphEdge*>(item));
+		QList<int> nodeIds;
+		QList<QPointF> oldPositions;
+		QList<QPointF> newPositions;
+
+		QHash<int, QPointF>::const_iterator it;
+
+		for(it = m_dragStartPositions.constBegin(); it != m_dragStartPositions.constEnd(); ++it)
+		{
+			if(!m_model.hasNode(it.key()) || m_model.node(it.key()).pos == it.value())
+				continue;
+
+			nodeIds.append(it.key());
+			oldPositions.append(it.value());
+			newPositions.append(m_model.node(it.key()).pos);
+		}
+
+		m_dragStartPositions.clear();
+
+		if(!nodeIds.isEmpty())
+			pushCommand(new MoveNodesCommand(this, nodeIds, oldPositions, newPositions));
 	}
+}
 
-	memento.storeItems(edges, nodes);
+void GraphScene::storeToMemento(GraphSceneMemento &memento)
+{
+	memento.storeModel(m_model);
 }
 
 void GraphScene::restoreFromMemento(GraphSceneMemento &memento)
 {
-	clear();
+	clearGraph();
 
-	QList<GraphNode*> nodes;
-	QList<GraphEdge*> edges;
+	memento.restoreModel(m_model);
 
-	memento.createItems(edges, nodes);
+	// don't let the index be rebuilt for every inserted item
+	setItemIndexMethod(QGraphicsScene::NoIndex);
+	updateVisibleItems();
+	setItemIndexMethod(QGraphicsScene::BspTreeIndex);
 
-	foreach(GraphNode *node, nodes)
-	{
-		addNode(node);
-	}
+	update();
+}
 
-	foreach(GraphEdge *edge, edges)
-	{
-		addItem(edge);
-		edge->updatePosition();
-	}
+void GraphScene::appendStoredItems(const QList<GraphSceneMementoTypes::StoredNode> &nodes,
+				   const QList<GraphSceneMementoTypes::StoredEdge> &edges,
+				   const GraphSceneMementoTypes::StoredSections &sections)
+{
+	GraphSceneMemento::appendToModel(m_model, nodes, edges, sections);
 
-	update();
+	setItemIndexMethod(QGraphicsScene::NoIndex);
+	updateVisibleItems();
+	setItemIndexMethod(QGraphicsScene::BspTreeIndex);
 }
 
 void GraphScene::contextMenuEvent(QGraphicsSceneContextMenuEvent *contextMenuEvent)
@@ -206,6 +968,8 @@ void GraphScene::contextMenuEvent(QGraphicsSceneContextMenuEvent *contextMenuEve
 
 		if(item->type() == GraphNode::Type || item->type() == GraphNodeText::Type)
 		{
+			// the menu acts on the selection of the model, scrolled away nodes included
+			m_model.clearSelection();
 			clearSelection();
 
 			if(item->type() == GraphNode::Type)
@@ -224,14 +988,8 @@ void GraphScene::contextMenuEvent(QGraphicsSceneContextMenuEvent *contextMenuEve
 
 void GraphScene::updateEdgesPositions()
 {
-	foreach(QGraphicsItem *item, items())
-	{
-		if(item->type() == GraphEdge::Type)
-		{
-			GraphEdge *edge = qgraphicsitem_cast<GraphEdge*>(item);
-			edge->updatePosition();
-		}
-	}
+	foreach(GraphEdge *edge, m_edgeItems)
+		edge->updatePosition();
 }
 
 void GraphScene::nodeDragged()
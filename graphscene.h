@@ -10,7 +10,14 @@
 #include <QGraphicsDropShadowEffect>
 #include <QPen>
 
+#include <QHash>
+#include <QList>
+#include <QRectF>
+#include <QUndoStack>
+
 #include "graphnode.h"
+#include "graphedge.h"
+#include "graphmodel.h"
 #include "graphscenememento.h"
 
 class GraphScene : public QGraphicsScene
@@ -21,11 +28,60 @@ class GraphScene : public QGraphicsScene
 		enum Mode { InsertNode, InsertEdge, Manipulate, Idle };
 
 		GraphScene(QMenu *nodeMenu, QObject *parent = 0);
+		~GraphScene();
 
 		void storeToMemento(GraphSceneMemento &memento);
 		void restoreFromMemento(GraphSceneMemento &memento);
+		void appendStoredItems(const QList<GraphSceneMementoTypes::StoredNode> &nodes,
+				       const QList<GraphSceneMementoTypes::StoredEdge> &edges,
+				       const GraphSceneMementoTypes::StoredSections &sections);
+
+		GraphModel &model() { return m_model; }
+		const GraphModel &model() const { return m_model; }
+
+		void setVisibleRect(const QRectF &rect);
+		const QRectF &visibleRect() const { return m_visibleRect; }
+		void updateVisibleItems();
+
+		void setUndoStack(QUndoStack *undoStack) { m_undoStack = undoStack; }
+		QUndoStack *undoStack() const { return m_undoStack; }
+
+		/* Edit primitives used by the undo commands, they don't record
+		   anything themselves. */
+		int insertNode(const QString &label, GraphNode::NodeType type, const QPointF &pos, int id = -1);
+		int insertEdge(int fromNodeId, int toNodeId, int id = -1);
+		void removeNode(int id);
+		void removeEdge(int id);
+		void moveNode(int id, const QPointF &pos);
+		void setNodeType(int id, GraphNode::NodeType type);
+		void setNodeLabel(int id, const QString &label);
+		void setNodeDataFlow(int id, const QStringList &defs, const QStringList &uses);
+		void setNodeCallee(int id, const QString &callee);
+		void setEdgeCost(int id, double cost);
+		void setConstraints(const QList<GraphModelTypes::ModelConstraint> &constraints);
+
+		void clearGraph();
+		int deleteSelected();
+		int setSelectedNodesType(GraphNode::NodeType type);
+		void setSelectedNodeDataFlow(const QStringList &defs, const QStringList &uses);
+		void setSelectedNodeCallee(const QString &callee);
+		int setSelectedEdgesCost(double cost);
+
+		/* Constraints from the selected edges, false when they are not one
+		   path or not two edges. */
+		bool forbidSelectedPath();
+		bool makeSelectedEdgesExclusive();
+
+		// those which have one of the selected edges
+		int removeSelectedConstraints();
+
+		void highlightNode(int id);
+		void highlightEdge(int id);
+		void clearHighlight();
+
+		void nodeItemChanged(GraphNode *node);
+		void edgeItemChanged(GraphEdge *edge);
 
-		void addNode(GraphNode *node);
 		void updateEdgesPositions();
 
 		static QGraphicsDropShadowEffect *createDropShadowEffect();
@@ -39,6 +95,10 @@ class GraphScene : public QGraphicsScene
 
 	signals:
 		void changed();
+		void graphEdited(const GraphModelTypes::GraphChange &change);
+
+	private slots:
+		void deleteEmptyNode(int id);
 
 	private:
 		Mode m_mode;
@@ -51,6 +111,17 @@ class GraphScene : public QGraphicsScene
 
 		QMenu *m_nodeMenu;
 
+		GraphModel m_model;
+		QHash<int, GraphNode*> m_nodeItems;
+		QHash<int, GraphEdge*> m_edgeItems;
+		QList<GraphNode*> m_nodePool;
+		QList<GraphEdge*> m_edgePool;
+		QRectF m_visibleRect;
+		bool m_syncing;
+
+		QUndoStack *m_undoStack;
+		QHash<int, QPointF> m_dragStartPositions;
+
 		QSettings m_settings;
 		QColor m_insertingLineColor;
 		QPen m_insertingLinePen;
@@ -58,6 +129,18 @@ class GraphScene : public QGraphicsScene
 		void initSettings();
 		void filterNonNodeItems(QList<QGraphicsItem*> &itemList);
 
+		GraphNode *acquireNodeItem(int id);
+		GraphEdge *acquireEdgeItem(int id);
+		void releaseNodeItem(int id);
+		void releaseEdgeItem(int id);
+		bool isItemBusy(QGraphicsItem *item);
+		QRectF visibleArea() const;
+		void materializeNode(int id);
+		static QString nodeToolTip(const GraphModelTypes::ModelNode &node);
+		static QString edgeToolTip(const GraphModelTypes::ModelEdge &edge);
+
+		void pushCommand(QUndoCommand *command);
+
 	protected:
 		void mousePressEvent(QGraphicsSceneMouseEvent *mouseEvent);
 		void mouseMoveEvent(QGraphicsSceneMouseEvent *mouseEvent);
@@ -1,5 +1,7 @@
 #include "graphscenememento.h"
 
+#include <QHash>
+
 using namespace GraphSceneMementoTypes;
 
 QDataStream &operator<<(QDataStream& stream, const StoredEdge& edge)
@@ -30,6 +32,54 @@ QDataStream &operator>>(QDataStream& stream, StoredNode &node)
 	return stream;
 }
 
+QDataStream &operator<<(QDataStream& stream, const StoredDataFlow& dataFlow)
+{
+	stream << dataFlow.nodeIndex << dataFlow.defs << dataFlow.uses;
+	return stream;
+}
+
+QDataStream &operator>>(QDataStream& stream, StoredDataFlow &dataFlow)
+{
+	stream >> dataFlow.nodeIndex >> dataFlow.defs >> dataFlow.uses;
+	return stream;
+}
+
+QDataStream &operator<<(QDataStream& stream, const StoredCall& call)
+{
+	stream << call.nodeIndex << call.callee;
+	return stream;
+}
+
+QDataStream &operator>>(QDataStream& stream, StoredCall &call)
+{
+	stream >> call.nodeIndex >> call.callee;
+	return stream;
+}
+
+QDataStream &operator<<(QDataStream& stream, const StoredConstraint& constraint)
+{
+	stream << constraint.type << constraint.nodeIndexes;
+	return stream;
+}
+
+QDataStream &operator>>(QDataStream& stream, StoredConstraint &constraint)
+{
+	stream >> constraint.type >> constraint.nodeIndexes;
+	return stream;
+}
+
+QDataStream &operator<<(QDataStream& stream, const StoredEdgeCost& cost)
+{
+	stream << cost.edgeIndex << cost.cost;
+	return stream;
+}
+
+QDataStream &operator>>(QDataStream& stream, StoredEdgeCost &cost)
+{
+	stream >> cost.edgeIndex >> cost.cost;
+	return stream;
+}
+
 GraphSceneMemento::GraphSceneMemento()
 {
 }
@@ -43,12 +93,72 @@ void GraphSceneMemento::clear()
 {
 	m_storedNodes.clear();
 	m_storedEdges.clear();
+	m_storedSections.clear();
 }
 
 void GraphSceneMemento::write(QDataStream &stream)
 {
 	stream << m_storedNodes;
 	stream << m_storedEdges;
+
+	writeSections(stream, m_storedSections);
+}
+
+void GraphSceneMemento::writeSections(QDataStream &stream, const StoredSections &sections)
+{
+	if(!sections.dataFlow.isEmpty())
+		stream << (quint32)QCV_DATAFLOW_TAG << sections.dataFlow;
+
+	if(!sections.calls.isEmpty())
+		stream << (quint32)QCV_CALLS_TAG << sections.calls;
+
+	if(!sections.constraints.isEmpty())
+		stream << (quint32)QCV_CONSTRAINTS_TAG << sections.constraints;
+
+	if(!sections.costs.isEmpty())
+		stream << (quint32)QCV_COSTS_TAG << sections.costs;
+}
+
+void GraphSceneMemento::readSections(QDataStream &stream, StoredSections &sections)
+{
+	while(!stream.atEnd() && stream.status() == QDataStream::Ok)
+	{
+		quint32 tag;
+		stream >> tag;
+
+		if(tag == (quint32)QCV_DATAFLOW_TAG)
+		{
+			QList<StoredDataFlow> dataFlow;
+			stream >> dataFlow;
+			sections.dataFlow += dataFlow;
+		}
+		else if(tag == (quint32)QCV_CALLS_TAG)
+		{
+			QList<StoredCall> calls;
+			stream >> calls;
+			sections.calls += calls;
+		}
+		else if(tag == (quint32)QCV_CONSTRAINTS_TAG)
+		{
+			QList<StoredConstraint> constraints;
+			stream >> constraints;
+			sections.constraints += constraints;
+		}
+		else if(tag == (quint32)QCV_COSTS_TAG)
+		{
+			QList<StoredEdgeCost> costs;
+			stream >> costs;
+			sections.costs += costs;
+		}
+		else
+		{
+			// a section from a newer version, nothing after it can be understood
+#ifdef DEBUG
+			qWarning() << "readSections: unknown section" << tag;
+#endif
+			return;
+		}
+	}
 }
 
 void GraphSceneMemento::read(QDataStream &stream)
@@ -56,63 +166,170 @@ void GraphSceneMemento::read(QDataStream &stream)
 	clear();
 	stream >> m_storedNodes;
 	stream >> m_storedEdges;
+
+	readSections(stream, m_storedSections);
+}
+
+bool GraphSceneMemento::readFile(const QString &fileName, GraphModel &model, QString *errorString)
+{
+	QFile file(fileName);
+
+	if(!file.open(QIODevice::ReadOnly))
+	{
+		if(errorString != 0)
+			*errorString = file.errorString();
+
+		return false;
+	}
+
+	QDataStream in(&file);
+	in.setVersion(QDataStream::Qt_4_0);
+
+	quint32 magic;
+	in >> magic;
+
+	if(magic != (quint32)QCV_MAGIC)
+	{
+		if(errorString != 0)
+			*errorString = QObject::tr("not a QCoverage graph");
+
+		return false;
+	}
+
+	GraphSceneMemento memento;
+	memento.read(in);
+
+	if(in.status() != QDataStream::Ok)
+	{
+		if(errorString != 0)
+			*errorString = QObject::tr("file is corrupted");
+
+		return false;
+	}
+
+	memento.restoreModel(model);
+
+	return true;
 }
 
-void GraphSceneMemento::storeItems(const QList<GraphEdge*> &edges, const QList<GraphNode*> &nodes)
+void GraphSceneMemento::storeModel(const GraphModel &model)
 {
 	clear();
 
-	foreach(GraphNode* node, nodes)
+	QList<int> nodeIds = model.nodeIds();
+	QHash<int, int> nodeIndexes;
+
+	foreach(int id, nodeIds)
 	{
+		const GraphModelTypes::ModelNode &node = model.node(id);
+
 		StoredNode storedNode;
-		storedNode.label = node->label();
-		storedNode.type = node->nodeType();
-		storedNode.pos = node->pos();
+		storedNode.label = node.label;
+		storedNode.type = node.type;
+		storedNode.pos = node.pos;
 
+		if(!node.defs.isEmpty() || !node.uses.isEmpty())
+		{
+			StoredDataFlow dataFlow;
+			dataFlow.nodeIndex = m_storedNodes.size();
+			dataFlow.defs = node.defs;
+			dataFlow.uses = node.uses;
+
+			m_storedSections.dataFlow.append(dataFlow);
+		}
+
+		if(!node.callee.isEmpty())
+		{
+			StoredCall call;
+			call.nodeIndex = m_storedNodes.size();
+			call.callee = node.callee;
+
+			m_storedSections.calls.append(call);
+		}
+
+		nodeIndexes.insert(id, m_storedNodes.size());
 		m_storedNodes.append(storedNode);
 	}
 
-	foreach(GraphEdge* edge, edges)
+	foreach(int id, model.edgeIds())
 	{
+		const GraphModelTypes::ModelEdge &edge = model.edge(id);
+
 		StoredEdge storedEdge;
-		storedEdge.fromNodeIndex = nodes.indexOf(edge->fromNode());
-		storedEdge.toNodeIndex = nodes.indexOf(edge->toNode());
+		storedEdge.fromNodeIndex = nodeIndexes.value(edge.fromNodeId, -1);
+		storedEdge.toNodeIndex = nodeIndexes.value(edge.toNodeId, -1);
+
+		if(edge.cost != 1.0)
+		{
+			StoredEdgeCost cost;
+			cost.edgeIndex = m_storedEdges.size();
+			cost.cost = edge.cost;
+
+			m_storedSections.costs.append(cost);
+		}
 
 		m_storedEdges.append(storedEdge);
 
 #ifdef DEBUG
-		if(storedEdge.fromNodeIndex == -1 || storedEdge.toNodeIndex)
-			qWarning() << "storeItems: Data is inconsistent";
+		if(storedEdge.fromNodeIndex == -1 || storedEdge.toNodeIndex == -1)
+			qWarning() << "storeModel: Data is inconsistent";
 #endif
+	}
+
+	// those left over from deleted nodes or edges are dropped here
+	foreach(const GraphModelTypes::ModelConstraint &constraint, model.constraints())
+	{
+		if(!model.isConstraintValid(constraint))
+			continue;
+
+		StoredConstraint storedConstraint;
+		storedConstraint.type = constraint.type;
+
+		foreach(int id, constraint.nodeIds)
+			storedConstraint.nodeIndexes.append(nodeIndexes.value(id));
 
+		m_storedSections.constraints.append(storedConstraint);
 	}
 }
 
-void GraphSceneMemento::createItems(QList<GraphEdge*> &edges, QList<GraphNode*> &nodes)
+void GraphSceneMemento::restoreModel(GraphModel &model) const
 {
-	edges.clear();
-	nodes.clear();
+	model.clear();
+	appendToModel(model, m_storedNodes, m_storedEdges, m_storedSections);
+}
 
-	foreach(StoredNode storedNode, m_storedNodes)
-	{
-		GraphNode *node = new GraphNode(storedNode.label);
+void GraphSceneMemento::appendToModel(GraphModel &model, const QList<StoredNode> &nodes, const QList<StoredEdge> &edges,
+				      const StoredSections &sections)
+{
+	// node ids are the stored indexes, as long as the model started empty
+	foreach(const StoredNode &storedNode, nodes)
+		model.addNode(storedNode.label, storedNode.type, storedNode.pos);
 
-		node->setNodeType(storedNode.type);
-		node->setPos(storedNode.pos);
+	foreach(const StoredEdge &storedEdge, edges)
+		model.addEdge(storedEdge.fromNodeIndex, storedEdge.toNodeIndex);
 
-		nodes.append(node);
-	}
+	foreach(const StoredDataFlow &storedDataFlow, sections.dataFlow)
+		model.setNodeDataFlow(storedDataFlow.nodeIndex, storedDataFlow.defs, storedDataFlow.uses);
 
-	foreach(StoredEdge storedEdge, m_storedEdges)
-	{
-		GraphNode *fromNode = nodes.at(storedEdge.fromNodeIndex);
-		GraphNode *toNode = nodes.at(storedEdge.toNodeIndex);
-		GraphEdge *edge = new GraphEdge(fromNode, toNode);
+	foreach(const StoredCall &storedCall, sections.calls)
+		model.setNodeCallee(storedCall.nodeIndex, storedCall.callee);
+
+	// edge ids are the stored indexes too
+	foreach(const StoredEdgeCost &storedCost, sections.costs)
+		model.setEdgeCost(storedCost.edgeIndex, storedCost.cost);
 
-		fromNode->addEdge(edge);
-		toNode->addEdge(edge);
+	if(sections.constraints.isEmpty())
+		return;
 
-		edges.append(edge);
+	QList<GraphModelTypes::ModelConstraint> constraints = model.constraints();
+
+	foreach(const StoredConstraint &storedConstraint, sections.constraints)
+	{
+		GraphModelTypes::ModelConstraint constraint((GraphModelTypes::ModelConstraint::ConstraintType)storedConstraint.type);
+		constraint.nodeIds = storedConstraint.nodeIndexes;
+
+		constraints.append(constraint);
 	}
-}
 
+	model.setConstraints(constraints);
+}
@@ -3,6 +3,7 @@
 
 #include <QList>
 #include <QString>
+#include <QStringList>
 #include <QFile>
 #include <QDataStream>
 #include <QDebug>
@@ -10,6 +11,17 @@
 
 #include "graphedge.h"
 #include "graphnode.h"
+#include "graphmodel.h"
+
+#define QCV_MAGIC 0x3fac9e3d
+
+/* Optional sections follow the edges, each one starts with its tag.
+   Files without them are read as before and older readers stop
+   after the edges. */
+#define QCV_DATAFLOW_TAG 0x44465531
+#define QCV_CALLS_TAG 0x43414c31
+#define QCV_CONSTRAINTS_TAG 0x434e5331
+#define QCV_COSTS_TAG 0x434f5331
 
 namespace GraphSceneMementoTypes
 {
@@ -25,6 +37,59 @@ namespace GraphSceneMementoTypes
 		QString label;
 		QPointF pos;
 	} StoredNode;
+
+	// only nodes which define or use something are stored
+	typedef struct
+	{
+		int nodeIndex;
+		QStringList defs;
+		QStringList uses;
+	} StoredDataFlow;
+
+	// nodes calling the function of another graph file
+	typedef struct
+	{
+		int nodeIndex;
+		QString callee;
+	} StoredCall;
+
+	// edges costing other than 1
+	typedef struct
+	{
+		int edgeIndex;
+		double cost;
+	} StoredEdgeCost;
+
+	// infeasible paths, GraphModelTypes::ModelConstraint by node indexes
+	typedef struct
+	{
+		int type;
+		QList<int> nodeIndexes;
+	} StoredConstraint;
+
+	// everything in the optional sections
+	struct StoredSections
+	{
+		QList<StoredDataFlow> dataFlow;
+		QList<StoredCall> calls;
+		QList<StoredConstraint> constraints;
+		QList<StoredEdgeCost> costs;
+
+		bool isEmpty() const
+		{
+			return dataFlow.isEmpty() && calls.isEmpty() && constraints.isEmpty() && costs.isEmpty();
+		}
+
+		void clear() { dataFlow.clear(); calls.clear(); constraints.clear(); costs.clear(); }
+
+		void append(const StoredSections &sections)
+		{
+			dataFlow += sections.dataFlow;
+			calls += sections.calls;
+			constraints += sections.constraints;
+			costs += sections.costs;
+		}
+	};
 }
 
 QDataStream &operator<<(QDataStream& stream, const GraphSceneMementoTypes::StoredEdge& edge);
@@ -33,6 +98,18 @@ QDataStream &operator>>(QDataStream& stream, GraphSceneMementoTypes::StoredEdge
 QDataStream &operator<<(QDataStream& stream, const GraphSceneMementoTypes::StoredNode& node);
 QDataStream &operator>>(QDataStream& stream, GraphSceneMementoTypes::StoredNode &node);
 
+QDataStream &operator<<(QDataStream& stream, const GraphSceneMementoTypes::StoredDataFlow& dataFlow);
+QDataStream &operator>>(QDataStream& stream, GraphSceneMementoTypes::StoredDataFlow &dataFlow);
+
+QDataStream &operator<<(QDataStream& stream, const GraphSceneMementoTypes::StoredCall& call);
+QDataStream &operator>>(QDataStream& stream, GraphSceneMementoTypes::StoredCall &call);
+
+QDataStream &operator<<(QDataStream& stream, const GraphSceneMementoTypes::StoredConstraint& constraint);
+QDataStream &operator>>(QDataStream& stream, GraphSceneMementoTypes::StoredConstraint &constraint);
+
+QDataStream &operator<<(QDataStream& stream, const GraphSceneMementoTypes::StoredEdgeCost& cost);
+QDataStream &operator>>(QDataStream& stream, GraphSceneMementoTypes::StoredEdgeCost &cost);
+
 class GraphSceneMemento
 {
 	public:
@@ -43,14 +120,26 @@ class GraphSceneMemento
 		void write(QDataStream &stream);
 		void read(QDataStream &stream);
 
-		void storeItems(const QList<GraphEdge*> &edges, const QList<GraphNode*> &nodes);
-		void createItems(QList<GraphEdge*> &edges, QList<GraphNode*> &nodes);
+		void storeModel(const GraphModel &model);
+		void restoreModel(GraphModel &model) const;
+
+		static void appendToModel(GraphModel &model,
+					  const QList<GraphSceneMementoTypes::StoredNode> &nodes,
+					  const QList<GraphSceneMementoTypes::StoredEdge> &edges,
+					  const GraphSceneMementoTypes::StoredSections &sections);
+
+		static void writeSections(QDataStream &stream, const GraphSceneMementoTypes::StoredSections &sections);
+		static void readSections(QDataStream &stream, GraphSceneMementoTypes::StoredSections &sections);
+
+		// a whole file into an empty model, without the scene
+		static bool readFile(const QString &fileName, GraphModel &model, QString *errorString = 0);
 
 		void clear();
 
 	private:
 		QList<GraphSceneMementoTypes::StoredEdge> m_storedEdges;
 		QList<GraphSceneMementoTypes::StoredNode> m_storedNodes;
+		GraphSceneMementoTypes::StoredSections m_storedSections;
 
 };
 
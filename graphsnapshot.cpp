@@ -0,0 +1,75 @@
+#include "graphsnapshot.h"
+
+using namespace Algorithm;
+
+GraphSnapshot::GraphSnapshot(const QList<Node*> &nodes)
+	: m_nodes(nodes)
+{
+	int nodeCount = nodes.size();
+
+	for(int v = 0; v < nodeCount; ++v)
+		m_indexes.insert(nodes.at(v), v);
+
+	m_offsets.reserve(nodeCount + 1);
+	m_offsets.append(0);
+
+	for(int v = 0; v < nodeCount; ++v)
+	{
+		Node *node = nodes.at(v);
+		const QList<Node*> &links = node->links();
+
+		for(int i = 0; i < links.size(); ++i)
+		{
+			int target = m_indexes.value(links.at(i), -1);
+
+			// links leading out of the given nodes are dropped
+			if(target == -1)
+				continue;
+
+			m_targets.append(target);
+			m_sources.append(v);
+			m_edgeModelIds.append(node->edgeIds().value(i, -1));
+			m_edgeCosts.append(node->edgeCosts().value(i, 1.0));
+		}
+
+		m_offsets.append(m_targets.size());
+	}
+
+	// incoming edges, bucketed by target
+	m_inOffsets.fill(0, nodeCount + 1);
+
+	foreach(int target, m_targets)
+		m_inOffsets[target + 1]++;
+
+	for(int v = 0; v < nodeCount; ++v)
+		m_inOffsets[v + 1] += m_inOffsets[v];
+
+	m_inEdges.resize(m_targets.size());
+	QVector<int> fill(m_inOffsets);
+
+	for(int e = 0; e < m_targets.size(); ++e)
+		m_inEdges[fill[m_targets[e]]++] = e;
+}
+
+int GraphSnapshot::findEdge(int from, int to) const
+{
+	for(int e = edgeBegin(from); e < edgeEnd(from); ++e)
+		if(m_targets.at(e) == to)
+			return e;
+
+	return -1;
+}
+
+bool GraphSnapshot::isStart(int v) const
+{
+	GraphNode::NodeType type = m_nodes.at(v)->type();
+
+	return type == GraphNode::StartNode || type == GraphNode::StartEndNode;
+}
+
+bool GraphSnapshot::isEnd(int v) const
+{
+	GraphNode::NodeType type = m_nodes.at(v)->type();
+
+	return type == GraphNode::EndNode || type == GraphNode::StartEndNode;
+}
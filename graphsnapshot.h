@@ -0,0 +1,64 @@
+#ifndef GRAPHSNAPSHOT_H
+#define GRAPHSNAPSHOT_H
+
+#include <QList>
+#include <QVector>
+#include <QHash>
+
+#include "algorithmnode.h"
+
+namespace Algorithm
+{
+	/* Immutable compressed sparse row copy of the graph for the algorithms
+	   which walk it many times. Nodes are numbered 0..nodeCount()-1 in the
+	   order of the list they were taken from, outgoing edges of a node are
+	   edgeBegin(v)..edgeEnd(v)-1 and keep the order of Node::links().
+	*/
+	class GraphSnapshot
+	{
+		public:
+			GraphSnapshot(const QList<Node*> &nodes);
+
+			int nodeCount() const { return m_nodes.size(); }
+			int edgeCount() const { return m_targets.size(); }
+
+			int edgeBegin(int v) const { return m_offsets.at(v); }
+			int edgeEnd(int v) const { return m_offsets.at(v + 1); }
+			int edgeTarget(int e) const { return m_targets.at(e); }
+			int edgeSource(int e) const { return m_sources.at(e); }
+			int edgeModelId(int e) const { return m_edgeModelIds.at(e); }
+			double edgeCost(int e) const { return m_edgeCosts.at(e); }
+			int outDegree(int v) const { return edgeEnd(v) - edgeBegin(v); }
+
+			int inEdgeBegin(int v) const { return m_inOffsets.at(v); }
+			int inEdgeEnd(int v) const { return m_inOffsets.at(v + 1); }
+			int inEdge(int i) const { return m_inEdges.at(i); }
+			int inDegree(int v) const { return inEdgeEnd(v) - inEdgeBegin(v); }
+
+			int findEdge(int from, int to) const;
+
+			Node *node(int v) const { return m_nodes.at(v); }
+			int indexOf(Node *node) const { return m_indexes.value(node, -1); }
+
+			bool isStart(int v) const;
+			bool isEnd(int v) const;
+
+			const QVector<int> &offsets() const { return m_offsets; }
+			const QVector<int> &targets() const { return m_targets; }
+
+		private:
+			QList<Node*> m_nodes;
+			QHash<Node*, int> m_indexes;
+
+			QVector<int> m_offsets;
+			QVector<int> m_targets;
+			QVector<int> m_sources;
+			QVector<int> m_edgeModelIds;
+			QVector<double> m_edgeCosts;
+
+			QVector<int> m_inOffsets;
+			QVector<int> m_inEdges;
+	};
+}
+
+#endif // GRAPHSNAPSHOT_H
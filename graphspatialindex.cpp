@@ -0,0 +1,170 @@
+#include "graphspatialindex.h"
+
+#include <QSet>
+
+#include <math.h>
+
+GraphSpatialIndex::GraphSpatialIndex(qreal cellSize)
+	: m_cellSize(cellSize)
+{
+}
+
+quint64 GraphSpatialIndex::cellKey(int x, int y)
+{
+	return ((quint64)(quint32)x << 32) | (quint32)y;
+}
+
+void GraphSpatialIndex::cellRange(const QRectF &rect, int &x1, int &y1, int &x2, int &y2) const
+{
+	x1 = (int)floor(rect.left() / m_cellSize);
+	y1 = (int)floor(rect.top() / m_cellSize);
+	x2 = (int)floor(rect.right() / m_cellSize);
+	y2 = (int)floor(rect.bottom() / m_cellSize);
+}
+
+bool GraphSpatialIndex::isOversized(const QRectF &rect) const
+{
+	int x1, y1, x2, y2;
+	cellRange(rect, x1, y1, x2, y2);
+
+	return (qint64)(x2 - x1 + 1) * (y2 - y1 + 1) > MaxCellsPerItem;
+}
+
+void GraphSpatialIndex::insert(int id, const QRectF &rect)
+{
+	m_rects.insert(id, rect);
+
+	if(isOversized(rect))
+	{
+		m_oversized.append(id);
+		return;
+	}
+
+	int x1, y1, x2, y2;
+	cellRange(rect, x1, y1, x2, y2);
+
+	for(int x = x1; x <= x2; ++x)
+		for(int y = y1; y <= y2; ++y)
+			m_cells[cellKey(x, y)].append(id);
+}
+
+void GraphSpatialIndex::remove(int id)
+{
+	if(!m_rects.contains(id))
+		return;
+
+	QRectF rect = m_rects.take(id);
+
+	if(isOversized(rect))
+	{
+		m_oversized.removeOne(id);
+		return;
+	}
+
+	int x1, y1, x2, y2;
+	cellRange(rect, x1, y1, x2, y2);
+
+	for(int x = x1; x <= x2; ++x)
+		for(int y = y1; y <= y2; ++y)
+		{
+			quint64 key = cellKey(x, y);
+			QHash<quint64, QList<int> >::iterator it = m_cells.find(key);
+
+			if(it == m_cells.end())
+				continue;
+
+			it.value().removeOne(id);
+
+			if(it.value().isEmpty())
+				m_cells.erase(it);
+		}
+}
+
+void GraphSpatialIndex::update(int id, const QRectF &rect)
+{
+	if(m_rects.contains(id))
+	{
+		int ox1, oy1, ox2, oy2, x1, y1, x2, y2;
+
+		QRectF oldRect = m_rects.value(id);
+		cellRange(oldRect, ox1, oy1, ox2, oy2);
+		cellRange(rect, x1, y1, x2, y2);
+
+		// moving inside the same cells happens on every drag step
+		if(ox1 == x1 && oy1 == y1 && ox2 == x2 && oy2 == y2)
+		{
+			m_rects.insert(id, rect);
+			return;
+		}
+	}
+
+	remove(id);
+	insert(id, rect);
+}
+
+QList<int> GraphSpatialIndex::query(const QRectF &rect) const
+{
+	QSet<int> found;
+
+	int x1, y1, x2, y2;
+	cellRange(rect, x1, y1, x2, y2);
+
+	if((qint64)(x2 - x1 + 1) * (y2 - y1 + 1) > m_cells.size())
+	{
+		/* The query covers more cells than are populated,
+		   walking the populated ones is cheaper. */
+		QHash<quint64, QList<int> >::const_iterator it;
+
+		for(it = m_cells.constBegin(); it != m_cells.constEnd(); ++it)
+		{
+			int x = (int)(qint32)(it.key() >> 32);
+			int y = (int)(qint32)(it.key() & 0xFFFFFFFF);
+
+			if(x >= x1 && x <= x2 && y >= y1 && y <= y2)
+				foreach(int id, it.value())
+					found.insert(id);
+		}
+	}
+	else
+	{
+		for(int x = x1; x <= x2; ++x)
+			for(int y = y1; y <= y2; ++y)
+			{
+				QHash<quint64, QList<int> >::const_iterator it = m_cells.constFind(cellKey(x, y));
+
+				if(it != m_cells.constEnd())
+					foreach(int id, it.value())
+						found.insert(id);
+			}
+	}
+
+	foreach(int id, m_oversized)
+		found.insert(id);
+
+	QList<int> result;
+
+	foreach(int id, found)
+	{
+		if(m_rects.value(id).intersects(rect))
+			result.append(id);
+	}
+
+	return result;
+}
+
+QRectF GraphSpatialIndex::boundingRect() const
+{
+	QRectF rect;
+
+	foreach(const QRectF &itemRect, m_rects)
+		rect |= itemRect;
+
+	return rect;
+}
+
+void GraphSpatialIndex::clear()
+{
+	m_cells.clear();
+	m_rects.clear();
+	m_oversized.clear();
+}
@@ -0,0 +1,42 @@
+#ifndef GRAPHSPATIALINDEX_H
+#define GRAPHSPATIALINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QRectF>
+
+/* Uniform grid over the scene. Every id is stored in each cell its rectangle
+   touches, rectangles spanning too many cells go to a separate list which
+   is always scanned (this keeps long edges from flooding the grid).
+*/
+class GraphSpatialIndex
+{
+	public:
+		GraphSpatialIndex(qreal cellSize = 256.0);
+
+		void insert(int id, const QRectF &rect);
+		void remove(int id);
+		void update(int id, const QRectF &rect);
+
+		QList<int> query(const QRectF &rect) const;
+		QRectF rect(int id) const { return m_rects.value(id); }
+		QRectF boundingRect() const;
+
+		bool isEmpty() const { return m_rects.isEmpty(); }
+		void clear();
+
+	private:
+		qreal m_cellSize;
+
+		QHash<quint64, QList<int> > m_cells;
+		QHash<int, QRectF> m_rects;
+		QList<int> m_oversized;
+
+		static const int MaxCellsPerItem = 64;
+
+		void cellRange(const QRectF &rect, int &x1, int &y1, int &x2, int &y2) const;
+		static quint64 cellKey(int x, int y);
+		bool isOversized(const QRectF &rect) const;
+};
+
+#endif // GRAPHSPATIALINDEX_H
@@ -0,0 +1,30 @@
+#include "graphview.h"
+
+#include "graphscene.h"
+
+GraphView::GraphView(QWidget *parent)
+	: QGraphicsView(parent)
+{
+}
+
+void GraphView::updateVisibleRect()
+{
+	GraphScene *graphScene = qobject_cast<GraphScene*>(scene());
+
+	if(graphScene == 0)
+		return;
+
+	graphScene->setVisibleRect(mapToScene(viewport()->rect()).boundingRect());
+}
+
+void GraphView::scrollContentsBy(int dx, int dy)
+{
+	QGraphicsView::scrollContentsBy(dx, dy);
+	updateVisibleRect();
+}
+
+void GraphView::resizeEvent(QResizeEvent *event)
+{
+	QGraphicsView::resizeEvent(event);
+	updateVisibleRect();
+}
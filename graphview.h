@@ -0,0 +1,26 @@
+#ifndef GRAPHVIEW_H
+#define GRAPHVIEW_H
+
+#include <QGraphicsView>
+#include <QResizeEvent>
+#include <QWidget>
+
+/* Tells the GraphScene which part of it is visible, so that it only keeps
+   graphics items for that part of the graph.
+*/
+class GraphView : public QGraphicsView
+{
+	Q_OBJECT
+
+	public:
+		GraphView(QWidget *parent = 0);
+
+	public slots:
+		void updateVisibleRect();
+
+	protected:
+		void scrollContentsBy(int dx, int dy);
+		void resizeEvent(QResizeEvent *event);
+};
+
+#endif // GRAPHVIEW_H
@@ -5,10 +5,13 @@
 #include <QDebug>
 #include <QStringList>
 #include "mainwindow.h"
+#include "commandline.h"
 
 int main(int argc, char *argv[])
 {
-    QApplication a(argc, argv);
+    bool batch = CommandLine::isRequested(argc, argv);
+
+    QApplication a(argc, argv, !batch);
 
     QCoreApplication::setApplicationName("QCoverage");
     QCoreApplication::setOrganizationName("Filip Sobalski");
@@ -28,6 +31,12 @@ int main(int argc, char *argv[])
     settings.setValue("viewModeBcgColor", "#ffeeee");
     settings.setValue("defaultSceneSize", QSize(1500, 1500));
 
+    if(batch)
+    {
+	    CommandLine commandLine(qApp->arguments());
+	    return commandLine.exec();
+    }
+
     MainWindow w;
     w.show();
 
@@ -35,6 +44,8 @@ int main(int argc, char *argv[])
 
     if(args.size() > 1)
 	    w.loadFromFile(args.last());
+    else
+	    w.startJournal();
 
     return a.exec();
 }
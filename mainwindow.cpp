@@ -17,19 +17,31 @@
 #include <QFile>
 #include <QDataStream>
 #include <QGraphicsDropShadowEffect>
+#include <QMenuBar>
+#include <QInputDialog>
+#include <QActionGroup>
+#include <QPair>
 
 #include "graphnode.h"
 #include "graphscenememento.h"
+#include "graphexporter.h"
+#include "requirementcounter.h"
 
-#define QCV_MAGIC 0x3fac9e3d
+// milliseconds the requirements are counted before a run
+#define QUICK_COUNT_BUDGET 500
+// runs with more requirements have to be confirmed
+#define LARGE_REQUIREMENT_COUNT 100000
 
 MainWindow::MainWindow(QWidget *parent)
 	: QMainWindow(parent), ui(new Ui::MainWindow),
 	m_zoom(100), m_changed(false), m_saved(false), m_inViewMode(false),
-	m_currentFilename(tr("Untitled.qcv"))
+	m_graphLoader(0), m_currentFilename(tr("Untitled.qcv"))
 {
 	ui->setupUi(this);
 
+	m_undoStack = new QUndoStack(this);
+	m_journal = new GraphJournal(this);
+
 	move(QApplication::desktop()->availableGeometry(this).center() - rect().center());
 
 	setupActions();
@@ -40,10 +52,12 @@ MainWindow::MainWindow(QWidget *parent)
 
 	m_graphScene = new GraphScene(m_nodeMenu, this);
 	m_graphScene->setSceneRect(QRectF(QPoint(), QSizeF(m_maxSceneSize)));
+	m_graphScene->setUndoStack(m_undoStack);
 
 	m_graphProxy = new GraphProxy(m_graphScene, ui->requirementsList, ui->coverageList);
 
 	ui->graphicsView->setScene(m_graphScene);
+	ui->graphicsView->updateVisibleRect();
 	ui->graphicsView->setInteractive(true);
 	ui->graphicsView->setViewportUpdateMode(QGraphicsView::BoundingRectViewportUpdate);
 	ui->graphicsView->setBackgroundBrush(QBrush(Qt::white));
@@ -54,6 +68,56 @@ MainWindow::MainWindow(QWidget *parent)
 	updateWindowName();
 
 	connect(m_graphScene, SIGNAL(changed()), this, SLOT(graphSceneChanged()));
+	connect(m_graphScene, SIGNAL(graphEdited(GraphModelTypes::GraphChange)),
+		m_journal, SLOT(record(GraphModelTypes::GraphChange)));
+	connect(m_undoStack, SIGNAL(indexChanged(int)), this, SLOT(undoStackIndexChanged()));
+	connect(m_undoStack, SIGNAL(cleanChanged(bool)), this, SLOT(undoStackCleanChanged(bool)));
+}
+
+void MainWindow::startJournal(bool offerRecovery)
+{
+	QString graphFilename(m_saved ? m_currentFilename : QString());
+
+	GraphJournal::Recovery recovery;
+
+	if(offerRecovery && GraphJournal::readRecovery(graphFilename, recovery) && !recovery.changes.isEmpty())
+	{
+		int result = QMessageBox::question(this, tr("Recovery"),
+						   tr("Unsaved changes to <i>%1</i> were found. Do you want to recover them?")
+						   .arg(QFileInfo(m_currentFilename).fileName()),
+						   QMessageBox::Yes | QMessageBox::No);
+
+		if(result == QMessageBox::Yes)
+		{
+			// the recovered edits go into the new journal as they are replayed
+			m_journal->start(graphFilename, m_graphScene->model());
+			GraphJournal::replay(recovery, m_graphScene);
+			m_journal->sync();
+
+			m_changed = true;
+			updateWindowName();
+
+			return;
+		}
+	}
+
+	if(!m_journal->start(graphFilename, m_graphScene->model()))
+		ui->statusBar->showMessage(tr("Could not start the edit journal: ") + m_journal->errorString(), 3000);
+}
+
+void MainWindow::undoStackIndexChanged()
+{
+	// the results shown would no longer match the graph
+	if(m_inViewMode)
+		backToEditMode();
+
+	graphSceneChanged();
+}
+
+void MainWindow::undoStackCleanChanged(bool clean)
+{
+	m_changed = !clean;
+	updateWindowName();
 }
 
 void MainWindow::graphSceneChanged()
@@ -106,7 +170,8 @@ void MainWindow::setupDialogs()
 
 	m_exportImageDialog->setDefaultSuffix("png");
 	m_exportImageDialog->setAcceptMode(QFileDialog::AcceptSave);
-	m_exportImageDialog->setNameFilter(tr("Images (*.png *.jpg *.jpeg)"));
+	m_exportImageDialog->setNameFilters(QStringList() << tr("Images (*.png *.jpg *.jpeg)")
+					     << tr("Vector graphics (*.svg *.pdf)"));
 
 
 	m_saveDialog = new QFileDialog(this, tr("Save graph"));
@@ -137,6 +202,38 @@ void MainWindow::antialiasingActionTriggered(bool checked)
 	ui->graphicsView->repaint();
 }
 
+void MainWindow::touringActionTriggered(QAction *action)
+{
+	m_settings.setValue("touring", action->data().toString());
+}
+
+void MainWindow::objectiveActionTriggered(QAction *action)
+{
+	m_settings.setValue("objective", action->data().toString());
+}
+
+void MainWindow::optimizationTimeActionTriggered()
+{
+	bool ok;
+
+	int seconds = QInputDialog::getInt(this, tr("Improve test paths"),
+					   tr("Seconds spent improving the test paths after they are generated "
+					      "(0 for none):"),
+					   m_settings.value("optimizationTimeLimit", 0).toInt() / 1000, 0, 3600, 1, &ok);
+	if(ok)
+		m_settings.setValue("optimizationTimeLimit", seconds * 1000);
+}
+
+void MainWindow::perRequirementActionTriggered(bool checked)
+{
+	m_settings.setValue("perRequirement", checked);
+}
+
+void MainWindow::portfolioActionTriggered(bool checked)
+{
+	m_settings.setValue("portfolio", checked);
+}
+
 void MainWindow::drawGridActionTriggered(bool checked)
 {
 	if(m_inViewMode)
@@ -248,6 +345,8 @@ void MainWindow::openGraphDialog()
 	if(m_inViewMode)
 		backToEditMode();
 
+	cancelLoading();
+
 	delete m_graphProxy;
 	m_graphProxy = new GraphProxy(m_graphScene, ui->requirementsList, ui->coverageList);
 
@@ -259,7 +358,7 @@ void MainWindow::openGraphDialog()
 
 void MainWindow::exportSceneToImageDialog()
 {
-	if(m_graphScene->items().isEmpty())
+	if(m_graphScene->model().isEmpty())
 	{
 		QMessageBox::warning(this, tr("Aborting..."),
 				     tr("The graph is empty!"),
@@ -267,12 +366,44 @@ void MainWindow::exportSceneToImageDialog()
 		return;
 	}
 
-	m_exportImageDialog->exec();
+	QRectF sourceRect(m_graphScene->model().boundingRect());
 
-	if(m_exportImageDialog->result() != QDialog::Accepted)
+	/* Add some padding. */
+	qreal padding = (m_maxSceneSize.width() + m_maxSceneSize.height()) / 20.0;
+	sourceRect.adjust(-padding, -padding, padding, padding);
+
+	exportRegionToImage(sourceRect, false);
+}
+
+void MainWindow::exportVisibleToImageDialog()
+{
+	exportRegionToImage(m_graphScene->visibleRect(), false);
+}
+
+void MainWindow::exportHighlightedPathDialog()
+{
+	QRectF sourceRect(m_graphScene->model().highlightedRect());
+
+	if(sourceRect.isEmpty())
+	{
+		QMessageBox::warning(this, tr("Aborting..."),
+				     tr("No path is highlighted, pick a requirement or a test path first."),
+				     QMessageBox::Abort);
 		return;
+	}
 
-	m_graphScene->updateEdgesPositions();
+	qreal padding = (m_maxSceneSize.width() + m_maxSceneSize.height()) / 40.0;
+	sourceRect.adjust(-padding, -padding, padding, padding);
+
+	exportRegionToImage(sourceRect, true);
+}
+
+bool MainWindow::exportRegionToImage(const QRectF &sourceRect, bool onlyHighlighted)
+{
+	m_exportImageDialog->exec();
+
+	if(m_exportImageDialog->result() != QDialog::Accepted)
+		return false;
 
 	QStringList filenames = m_exportImageDialog->selectedFiles();
 	QString filename = filenames.first();
@@ -280,7 +411,7 @@ void MainWindow::exportSceneToImageDialog()
 
 	bool transparent = false;
 
-	if(ext == "png")
+	if(ext == "png" || ext == "svg")
 	{
 		QMessageBox msgBox(QMessageBox::Question, tr("Transparency"),
 				   tr("Do you want transparent background?"),
@@ -292,67 +423,45 @@ void MainWindow::exportSceneToImageDialog()
 			transparent = true;
 	}
 
-	QRectF sourceRect(m_graphScene->itemsBoundingRect());
-
-	/* Add some padding. */
-	qreal padding = (m_maxSceneSize.width() + m_maxSceneSize.height()) / 20.0;
-	sourceRect.adjust(-padding, -padding, padding, padding);
-
-	QRectF targetRect(QPointF(), sourceRect.size());
-
-	QImage image(targetRect.size().toSize(), QImage::Format_ARGB32_Premultiplied);
-	image.fill(qRgba(0, 0, 0, 0));
+	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
-	QPainter painter(&image);
+	GraphExporter exporter(m_graphScene->model());
 
-	painter.initFrom(ui->graphicsView);
-	painter.setRenderHint(QPainter::Antialiasing);
-	painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+	exporter.setSourceRect(sourceRect);
+	exporter.setOnlyHighlighted(onlyHighlighted);
+	exporter.setTransparent(transparent);
+	exporter.setTitle(m_currentFilename);
 
-	if(!transparent)
-		painter.eraseRect(image.rect());
+	bool ok;
 
-	painter.drawText(QRectF(1, 1, targetRect.size().width(), padding), m_currentFilename);
+	if(ext == "svg")
+		ok = exporter.exportSvg(filename);
+	else if(ext == "pdf")
+		ok = exporter.exportPdf(filename);
+	else if(ext == "jpg" || ext == "jpeg")
+		ok = exporter.exportImage(filename, "JPG", 100);
+	else
+		ok = exporter.exportPng(filename);
 
-	painter.setBackgroundMode(Qt::TransparentMode);
+	QApplication::restoreOverrideCursor();
 
-	m_graphScene->clearSelection();
-	m_graphScene->render(&painter, targetRect, sourceRect.toRect());
+	if(!ok)
+	{
+		QMessageBox::critical(this, tr("Error"),
+				      tr("Could not export to <i>") + filename +
+				      tr("</i>: <b>") + exporter.errorString() + "</b>");
+		return false;
+	}
 
-	if(ext == "jpg" || ext == "jpeg")
-		image.save(filename, "JPG", 100);
-	else
-		image.save(filename);
+	ui->statusBar->showMessage(tr("Succesfully exported to ") + filename, 3);
 
-	painter.end();
+	return true;
 }
 
 
 void MainWindow::deleteNode()
 {
-	int deletedCount = 0;
-
-	foreach(QGraphicsItem *item, m_graphScene->selectedItems())
-	{
-		if(item->type() == GraphNode::Type)
-		{
-			qgraphicsitem_cast<GraphNode*>(item)->removeAllEdges();
-			m_graphScene->removeItem(item);
-			delete item;
-
-			deletedCount++;
-		}
-		else if(item->type() == GraphEdge::Type)
-		{
-			GraphEdge *edge = qgraphicsitem_cast<GraphEdge*>(item);
-			edge->fromNode()->removeEdge(edge);
-			edge->toNode()->removeEdge(edge);
-			m_graphScene->removeItem(item);
-			delete item;
-
-			deletedCount++;
-		}
-	}
+	int deletedCount = m_graphScene->deleteSelected();
 
 	if(deletedCount != 0)
 		graphSceneChanged();
@@ -362,16 +471,7 @@ void MainWindow::deleteNode()
 
 void MainWindow::setSelectedNodesType(GraphNode::NodeType type)
 {
-	int changedCount = 0;
-
-	foreach(QGraphicsItem *item, m_graphScene->selectedItems())
-	{
-		if(item->type() == GraphNode::Type)
-		{
-			qgraphicsitem_cast<GraphNode*>(item)->setNodeType(type);
-			changedCount++;
-		}
-	}
+	int changedCount = m_graphScene->setSelectedNodesType(type);
 
 	if(changedCount != 0)
 		graphSceneChanged();
@@ -397,6 +497,112 @@ void MainWindow::setStartEndNode()
 	setSelectedNodesType(GraphNode::StartEndNode);
 }
 
+void MainWindow::editNodeDataFlow()
+{
+	QList<int> nodeIds = m_graphScene->model().selectedNodeIds();
+
+	if(nodeIds.size() != 1)
+		return;
+
+	const GraphModelTypes::ModelNode &node = m_graphScene->model().node(nodeIds.first());
+	bool ok;
+
+	QString defs = QInputDialog::getText(this, tr("Definitions and uses"),
+					     tr("Variables defined in <b>%1</b> (comma separated):").arg(node.label),
+					     QLineEdit::Normal, node.defs.join(", "), &ok);
+	if(!ok)
+		return;
+
+	QString uses = QInputDialog::getText(this, tr("Definitions and uses"),
+					     tr("Variables used in <b>%1</b> (comma separated):").arg(node.label),
+					     QLineEdit::Normal, node.uses.join(", "), &ok);
+	if(!ok)
+		return;
+
+	QStringList defList, useList;
+
+	foreach(const QString &name, defs.split(',', QString::SkipEmptyParts))
+		if(!name.trimmed().isEmpty() && !defList.contains(name.trimmed()))
+			defList << name.trimmed();
+
+	foreach(const QString &name, uses.split(',', QString::SkipEmptyParts))
+		if(!name.trimmed().isEmpty() && !useList.contains(name.trimmed()))
+			useList << name.trimmed();
+
+	m_graphScene->setSelectedNodeDataFlow(defList, useList);
+	graphSceneChanged();
+}
+
+void MainWindow::editNodeCallee()
+{
+	QList<int> nodeIds = m_graphScene->model().selectedNodeIds();
+
+	if(nodeIds.size() != 1)
+		return;
+
+	const GraphModelTypes::ModelNode &node = m_graphScene->model().node(nodeIds.first());
+	bool ok;
+
+	QString callee = QInputDialog::getText(this, tr("Called function"),
+					       tr("Graph file of the function <b>%1</b> calls, relative to this graph "
+						  "(empty for none):").arg(node.label),
+					       QLineEdit::Normal, node.callee, &ok).trimmed();
+	if(!ok || callee == node.callee)
+		return;
+
+	m_graphScene->setSelectedNodeCallee(callee);
+	graphSceneChanged();
+}
+
+void MainWindow::editEdgeCost()
+{
+	QList<int> edgeIds = m_graphScene->model().selectedEdgeIds();
+
+	if(edgeIds.isEmpty())
+	{
+		QMessageBox::warning(this, tr("Edge cost"), tr("Select the edges first."));
+		return;
+	}
+
+	bool ok;
+
+	double cost = QInputDialog::getDouble(this, tr("Edge cost"),
+					      tr("Cost of executing the %n selected edge(s):", "", edgeIds.size()),
+					      m_graphScene->model().edge(edgeIds.first()).cost, 0, 1e9, 2, &ok);
+	if(!ok)
+		return;
+
+	m_graphScene->setSelectedEdgesCost(cost);
+	graphSceneChanged();
+}
+
+void MainWindow::forbidSelectedPath()
+{
+	if(!m_graphScene->forbidSelectedPath())
+	{
+		QMessageBox::warning(this, tr("Forbid path"), tr("Select the edges of one path."));
+		return;
+	}
+
+	graphSceneChanged();
+}
+
+void MainWindow::makeSelectedEdgesExclusive()
+{
+	if(!m_graphScene->makeSelectedEdgesExclusive())
+	{
+		QMessageBox::warning(this, tr("Exclusive edges"), tr("Select exactly two edges."));
+		return;
+	}
+
+	graphSceneChanged();
+}
+
+void MainWindow::removeSelectedConstraints()
+{
+	if(m_graphScene->removeSelectedConstraints() != 0)
+		graphSceneChanged();
+}
 
 void MainWindow::zoomInTriggered()
 {
@@ -429,11 +635,13 @@ void MainWindow::updateZoom()
 	ui->graphicsView->resetMatrix();
 	ui->graphicsView->translate(oldMatrix.dx(), oldMatrix.dy());
 	ui->graphicsView->scale(newScale, newScale);
+	ui->graphicsView->updateVisibleRect();
 }
 
 
 MainWindow::~MainWindow()
 {
+	cancelLoading();
 	delete m_graphProxy;
 	delete ui;
 }
@@ -454,8 +662,29 @@ void MainWindow::changeEvent(QEvent *e)
 
 void MainWindow::validateGraphActionTriggered()
 {
-	if(validateGraph())
-		QMessageBox::information(this, tr("Graph validation"), tr("Graph is ok."));
+	if(!validateGraph())
+		return;
+
+	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+
+	Algorithm::RequirementCounter counter(m_graphProxy->nodes());
+	counter.count(QUICK_COUNT_BUDGET);
+
+	QApplication::restoreOverrideCursor();
+
+	QString text = tr("Graph is ok.<br/><br/>Edge pair requirements: <b>%1</b>").arg(counter.edgePairCount());
+
+	if(counter.isExact())
+	{
+		text += tr("<br/>Simple path requirements: <b>%1</b><br/>Prime path requirements: <b>%2</b>")
+			.arg(counter.simplePathCount()).arg(counter.primePathCount());
+	}
+	else
+	{
+		text += tr("<br/>Simple and prime path requirements: <b>at most %1</b>").arg(counter.upperBound());
+	}
+
+	QMessageBox::information(this, tr("Graph validation"), text);
 }
 
 bool MainWindow::validateGraph()
@@ -514,6 +743,9 @@ void MainWindow::computeButtonGroupClicked(QAbstractButton *button)
 	if(!validateGraph())
 		return;
 
+	if(!confirmRequirementCount(button))
+		return;
+
 	if(!m_inViewMode)
 		m_oldBackgroundBrush = ui->graphicsView->backgroundBrush();
 
@@ -546,11 +778,68 @@ void MainWindow::computeButtonGroupClicked(QAbstractButton *button)
 	{
 		m_graphProxy->runAlgorithm(GraphProxy::PrimePathsAlg);
 	}
+	else if(button == ui->allDefsButton)
+	{
+		m_graphProxy->runAlgorithm(GraphProxy::AllDefsAlg);
+	}
+	else if(button == ui->allUsesButton)
+	{
+		m_graphProxy->runAlgorithm(GraphProxy::AllUsesAlg);
+	}
+	else if(button == ui->allDuPathsButton)
+	{
+		m_graphProxy->runAlgorithm(GraphProxy::AllDuPathsAlg);
+	}
+	else if(button == ui->basisPathsButton)
+	{
+		m_graphProxy->runAlgorithm(GraphProxy::BasisPathsAlg);
+	}
+	else if(button == ui->simpleRoundTripButton)
+	{
+		m_graphProxy->runAlgorithm(GraphProxy::SimpleRoundTripAlg);
+	}
+	else if(button == ui->completeRoundTripButton)
+	{
+		m_graphProxy->runAlgorithm(GraphProxy::CompleteRoundTripAlg);
+	}
 
 	QApplication::restoreOverrideCursor();
 
         ui->requirementsCountLabel->setText(tr("Count: <b>%1</b>").arg(ui->requirementsList->count()));
-        ui->coverageCountLabel->setText(tr("Count: <b>%1</b>").arg(ui->coverageList->count()));
+
+        if(m_graphProxy->truncation() != Algorithm::ResourceBudget::NoLimit)
+        {
+                ui->requirementsCountLabel->setText(tr("Count: <b>%1</b> (stopped by the %2)")
+                                                    .arg(ui->requirementsList->count())
+                                                    .arg(Algorithm::ResourceBudget::limitText(m_graphProxy->truncation())));
+        }
+        ui->coverageCountLabel->setText(tr("Count: <b>%1</b> (at least %2)")
+                                        .arg(ui->coverageList->count())
+                                        .arg(m_graphProxy->coverageLowerBound()));
+
+	if(m_graphProxy->infeasibleCount() != 0)
+	{
+		ui->coverageCountLabel->setText(tr("Count: <b>%1</b> (at least %2, %3 requirement(s) infeasible)")
+						.arg(ui->coverageList->count())
+						.arg(m_graphProxy->coverageLowerBound())
+						.arg(m_graphProxy->infeasibleCount()));
+	}
+
+	if(m_graphProxy->constraintsIgnored())
+		ui->coverageCountLabel->setText(ui->coverageCountLabel->text()
+						+ tr(", constraints not enforced"));
+
+	if(m_graphProxy->objective() == Algorithm::LowestCost)
+		ui->coverageCountLabel->setText(ui->coverageCountLabel->text()
+						+ tr(", cost <b>%1</b>").arg(m_graphProxy->suiteCost()));
+
+	if(!m_graphProxy->portfolioWinner().isEmpty())
+	{
+		ui->coverageCountLabel->setText(ui->coverageCountLabel->text()
+						+ tr(", by %1").arg(m_graphProxy->portfolioWinner()));
+
+		m_graphProxy->recordPortfolio(m_currentFilename);
+	}
 
 	ui->backToEditButton->setEnabled(true);
 }
@@ -617,7 +906,21 @@ void MainWindow::setupActions()
 	m_graphToolBar->addWidget(m_addNodeButton);
 	m_graphToolBar->addWidget(m_addEdgeButton);
 
+	m_exportPathAction = new QAction(tr("Export highlighted path to image"), this);
+
+	m_undoAction = m_undoStack->createUndoAction(this, tr("Undo"));
+	m_undoAction->setShortcut(QKeySequence::Undo);
+
+	m_redoAction = m_undoStack->createRedoAction(this, tr("Redo"));
+	m_redoAction->setShortcut(QKeySequence::Redo);
+
+	m_graphToolBar->addSeparator();
+	m_graphToolBar->addAction(m_undoAction);
+	m_graphToolBar->addAction(m_redoAction);
+
 	connect(ui->exportGraphImageAction, SIGNAL(triggered()), this, SLOT(exportSceneToImageDialog()));
+	connect(ui->saveVisibleImageAction, SIGNAL(triggered()), this, SLOT(exportVisibleToImageDialog()));
+	connect(m_exportPathAction, SIGNAL(triggered()), this, SLOT(exportHighlightedPathDialog()));
 	connect(ui->actionAboutQt, SIGNAL(triggered()), qApp, SLOT(aboutQt()));
 	connect(ui->actionAbout, SIGNAL(triggered()), this, SLOT(about()));
 
@@ -633,16 +936,127 @@ void MainWindow::setupActions()
 	connect(ui->endNodeAction, SIGNAL(triggered()), this, SLOT(setEndNode()));
 	connect(ui->normalNodeAction, SIGNAL(triggered()), this, SLOT(setNormalNode()));
 	connect(ui->startEndNodeAction, SIGNAL(triggered()), this, SLOT(setStartEndNode()));
+	connect(ui->dataFlowAction, SIGNAL(triggered()), this, SLOT(editNodeDataFlow()));
+	connect(ui->calleeAction, SIGNAL(triggered()), this, SLOT(editNodeCallee()));
+	connect(ui->edgeCostAction, SIGNAL(triggered()), this, SLOT(editEdgeCost()));
+	connect(ui->forbidPathAction, SIGNAL(triggered()), this, SLOT(forbidSelectedPath()));
+	connect(ui->exclusiveEdgesAction, SIGNAL(triggered()), this, SLOT(makeSelectedEdgesExclusive()));
+	connect(ui->removeConstraintsAction, SIGNAL(triggered()), this, SLOT(removeSelectedConstraints()));
 	connect(ui->validateGraphAction, SIGNAL(triggered()), this, SLOT(validateGraphActionTriggered()));
 	connect(ui->computeButtonGroup, SIGNAL(buttonClicked(QAbstractButton*)), this, SLOT(computeButtonGroupClicked(QAbstractButton*)));
 	connect(ui->backToEditButton, SIGNAL(clicked()), this, SLOT(backToEditMode()));
 	connect(ui->newAction, SIGNAL(triggered()), this, SLOT(newActionTriggered()));
 }
 
+bool MainWindow::confirmRequirementCount(QAbstractButton *button)
+{
+	if(button != ui->edgePairButton && button != ui->simplePathsButton && button != ui->primePathsButton)
+		return true;
+
+	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+
+	Algorithm::RequirementCounter counter(m_graphProxy->nodes());
+	counter.count(QUICK_COUNT_BUDGET);
+
+	QApplication::restoreOverrideCursor();
+
+	quint64 count = counter.edgePairCount();
+	bool exact = true;
+
+	if(button == ui->simplePathsButton)
+		count = counter.simplePathCount();
+	else if(button == ui->primePathsButton)
+		count = counter.primePathCount();
+
+	if(button != ui->edgePairButton && !counter.isExact())
+	{
+		count = counter.upperBound();
+		exact = false;
+	}
+
+	QString countText = exact ? QString::number(count) : tr("at most %1").arg(count);
+
+	ui->statusBar->showMessage(tr("Computing %1 requirements").arg(countText), 3000);
+
+	if(count <= LARGE_REQUIREMENT_COUNT)
+		return true;
+
+	return QMessageBox::question(this, tr("Large computation"),
+				     tr("The graph has <b>%1</b> requirements of this criterion, "
+					"computing them may take long and use a lot of memory.<br/>Continue?").arg(countText),
+				     QMessageBox::Yes | QMessageBox::No, QMessageBox::No) == QMessageBox::Yes;
+}
+
 void MainWindow::setupMenus()
 {
 	m_nodeMenu = ui->nodeMenu;
 
+	m_editMenu = new QMenu(tr("&Edit"), this);
+	m_editMenu->addAction(m_undoAction);
+	m_editMenu->addAction(m_redoAction);
+
+	menuBar()->insertMenu(ui->nodeMenu->menuAction(), m_editMenu);
+
+	QList<QAction*> toolsActions = ui->toolsMenu->actions();
+	QAction *afterExportAction = toolsActions.value(toolsActions.indexOf(ui->exportGraphImageAction) + 1);
+
+	ui->toolsMenu->insertAction(afterExportAction, ui->saveVisibleImageAction);
+	ui->toolsMenu->insertAction(afterExportAction, m_exportPathAction);
+
+	// read by GraphProxy on every run
+	QMenu *touringMenu = ui->optionsMenu->addMenu(tr("Touring"));
+	QActionGroup *touringGroup = new QActionGroup(this);
+	QString touring = m_settings.value("touring", "direct").toString();
+
+	QList<QPair<QString, Algorithm::TouringMode> > touringModes;
+	touringModes << qMakePair(tr("Direct"), Algorithm::DirectTouring)
+		     << qMakePair(tr("With sidetrips"), Algorithm::SidetripTouring)
+		     << qMakePair(tr("With detours"), Algorithm::DetourTouring);
+
+	for(int i = 0; i < touringModes.size(); ++i)
+	{
+		QAction *action = touringMenu->addAction(touringModes.at(i).first);
+		action->setCheckable(true);
+		action->setData(Algorithm::touringModeText(touringModes.at(i).second));
+		action->setChecked(action->data().toString() == touring);
+		touringGroup->addAction(action);
+	}
+
+	connect(touringGroup, SIGNAL(triggered(QAction*)), this, SLOT(touringActionTriggered(QAction*)));
+
+	QMenu *objectiveMenu = ui->optionsMenu->addMenu(tr("Test paths"));
+	QActionGroup *objectiveGroup = new QActionGroup(this);
+	QString objective = m_settings.value("objective", "fewest").toString();
+
+	QList<QPair<QString, Algorithm::Objective> > objectives;
+	objectives << qMakePair(tr("Fewest paths"), Algorithm::FewestPaths)
+		   << qMakePair(tr("Lowest total cost"), Algorithm::LowestCost);
+
+	for(int i = 0; i < objectives.size(); ++i)
+	{
+		QAction *action = objectiveMenu->addAction(objectives.at(i).first);
+		action->setCheckable(true);
+		action->setData(Algorithm::objectiveText(objectives.at(i).second));
+		action->setChecked(action->data().toString() == objective);
+		objectiveGroup->addAction(action);
+	}
+
+	connect(objectiveGroup, SIGNAL(triggered(QAction*)), this, SLOT(objectiveActionTriggered(QAction*)));
+
+	objectiveMenu->addSeparator();
+	QAction *optimizationTimeAction = objectiveMenu->addAction(tr("Improve for..."));
+	connect(optimizationTimeAction, SIGNAL(triggered()), this, SLOT(optimizationTimeActionTriggered()));
+
+	QAction *perRequirementAction = objectiveMenu->addAction(tr("One path per requirement"));
+	perRequirementAction->setCheckable(true);
+	perRequirementAction->setChecked(m_settings.value("perRequirement", false).toBool());
+	connect(perRequirementAction, SIGNAL(triggered(bool)), this, SLOT(perRequirementActionTriggered(bool)));
+
+	QAction *portfolioAction = objectiveMenu->addAction(tr("Race strategies"));
+	portfolioAction->setCheckable(true);
+	portfolioAction->setChecked(m_settings.value("portfolio", false).toBool());
+	connect(portfolioAction, SIGNAL(triggered(bool)), this, SLOT(portfolioActionTriggered(bool)));
+
 	ui->viewMenu->addAction(m_zoomInAction);
 	ui->viewMenu->addAction(m_zoomOutAction);
 	ui->viewMenu->addSeparator();
@@ -662,6 +1076,13 @@ void MainWindow::setupMenus()
 	ui->statusBar->addPermanentWidget(zoomOutToolButton);
 	ui->statusBar->addPermanentWidget(zoomResetToolButton);
 	ui->statusBar->addPermanentWidget(m_zoomLabel);
+
+	m_loadProgressBar = new QProgressBar();
+	m_loadProgressBar->setRange(0, 100);
+	m_loadProgressBar->setMaximumWidth(150);
+	m_loadProgressBar->hide();
+
+	ui->statusBar->addWidget(m_loadProgressBar);
 }
 
 void MainWindow::closeEvent(QCloseEvent *event)
@@ -672,6 +1093,8 @@ void MainWindow::closeEvent(QCloseEvent *event)
 		return;
 	}
 
+	m_journal->stop(true);
+
 	QMainWindow::closeEvent(event);
 }
 
@@ -714,15 +1137,19 @@ bool MainWindow::saveToFile(const QString &filename)
 
 	memento.write(out);
 
-	file.flush();
+	// the journal is thrown away below, so the file has to be on disk first
+	GraphJournal::syncFile(file);
 	file.close();
 
 	ui->statusBar->showMessage(tr("Succesfully saved file ") + filename, 3);
 
 	m_saved = true;
 	m_changed = false;
+	m_undoStack->setClean();
 	updateWindowName();
 
+	m_journal->start(filename, m_graphScene->model());
+
 	QApplication::restoreOverrideCursor();
 
 	return true;
@@ -730,59 +1157,112 @@ bool MainWindow::saveToFile(const QString &filename)
 
 bool MainWindow::loadFromFile(const QString &filename)
 {
-	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+	cancelLoading();
 
-	QFile file(filename);
+	m_journal->stop(true);
+	m_undoStack->clear();
+	m_graphScene->clearGraph();
+	ui->graphicsView->repaint();
 
-	if(!file.open(QIODevice::ReadOnly))
-	{
-		QMessageBox::critical(this, tr("Error"),
-				      tr("Could not open file <i>") + filename +
-				      tr("</i> with error: <b>") +
-				      file.errorString() + "</b>");
+	m_graphLoader = new GraphLoader(filename, this);
 
-		QApplication::restoreOverrideCursor();
+	connect(m_graphLoader, SIGNAL(chunkReady()), this, SLOT(graphLoaderChunkReady()));
+	connect(m_graphLoader, SIGNAL(progress(int)), m_loadProgressBar, SLOT(setValue(int)));
+	connect(m_graphLoader, SIGNAL(finished()), this, SLOT(graphLoaderFinished()));
 
-		return false;
-	}
+	setLoading(true);
 
+	m_graphLoader->start(QThread::LowPriority);
 
-	QDataStream in(&file);
-	in.setVersion(QDataStream::Qt_4_0);
+	return true;
+}
 
-	quint32 magic;
+void MainWindow::graphLoaderChunkReady()
+{
+	if(m_graphLoader == 0)
+		return;
 
-	in >> magic;
+	QList<GraphSceneMementoTypes::StoredNode> nodes;
+	QList<GraphSceneMementoTypes::StoredEdge> edges;
+	GraphSceneMementoTypes::StoredSections sections;
 
-	if(magic != (quint32)QCV_MAGIC)
-	{
-		QMessageBox::critical(this, tr("Error"),
-				      tr("File %1 is either corrupted or is not %2 graph!").
-				      arg(filename, QCoreApplication::applicationName()));
-		file.close();
+	if(m_graphLoader->takeChunks(nodes, edges, sections))
+		m_graphScene->appendStoredItems(nodes, edges, sections);
+}
 
-		QApplication::restoreOverrideCursor();
+void MainWindow::graphLoaderFinished()
+{
+	GraphLoader *loader = qobject_cast<GraphLoader*>(sender());
 
-		return false;
-	}
+	// a cancelled loader reports in after a new one was started
+	if(loader == 0 || loader != m_graphLoader)
+		return;
 
-	GraphSceneMemento memento;
-	memento.read(in);
+	graphLoaderChunkReady();
 
-	file.close();
+	m_graphLoader = 0;
+	setLoading(false);
+
+	if(loader->hasFailed())
+	{
+		m_undoStack->clear();
+		m_graphScene->clearGraph();
+		QMessageBox::critical(this, tr("Error"), loader->errorString());
+		loader->deleteLater();
 
-	m_graphScene->restoreFromMemento(memento);
+		return;
+	}
 
 	ui->graphicsView->repaint();
-	ui->statusBar->showMessage(tr("Succesfully loaded file ") + filename, 3);
+	ui->statusBar->showMessage(tr("Succesfully loaded file ") + loader->filename(), 3);
 
 	m_saved = true;
 	m_changed = false;
+	m_undoStack->setClean();
 	updateWindowName();
 
-	QApplication::restoreOverrideCursor();
+	startJournal();
 
-	return true;
+	loader->deleteLater();
+}
+
+void MainWindow::cancelLoading()
+{
+	if(m_graphLoader == 0)
+		return;
+
+	GraphLoader *loader = m_graphLoader;
+	m_graphLoader = 0;
+
+	/* Signals it has already sent may still be queued,
+	   so the loader has to stay around until they're delivered. */
+	loader->cancel();
+	loader->wait();
+	loader->deleteLater();
+
+	setLoading(false);
+}
+
+void MainWindow::setLoading(bool loading)
+{
+	/* The graph can be looked at and scrolled while it loads,
+	   but not edited, computed or saved. */
+	ui->graphicsView->setInteractive(!loading && !m_inViewMode);
+
+	m_graphToolBar->setEnabled(!loading);
+	ui->nodeMenu->setEnabled(!loading);
+	ui->saveAction->setEnabled(!loading);
+	ui->saveAsAction->setEnabled(!loading);
+	ui->exportGraphImageAction->setEnabled(!loading);
+	ui->saveVisibleImageAction->setEnabled(!loading);
+	ui->validateGraphAction->setEnabled(!loading);
+	m_editMenu->setEnabled(!loading);
+
+	foreach(QAbstractButton *button, ui->computeButtonGroup->buttons())
+		button->setEnabled(!loading);
+
+	m_loadProgressBar->setValue(0);
+	m_loadProgressBar->setVisible(loading);
 }
 
 void MainWindow::newActionTriggered()
@@ -793,6 +1273,8 @@ void MainWindow::newActionTriggered()
 	if(m_inViewMode)
 		backToEditMode();
 
+	cancelLoading();
+
 	m_saved = false;
 	m_changed = false;
 	m_currentFilename = tr("Untitled.qcv");
@@ -801,7 +1283,11 @@ void MainWindow::newActionTriggered()
 	delete m_graphProxy;
 	m_graphProxy = new GraphProxy(m_graphScene, ui->requirementsList, ui->coverageList);
 
-	m_graphScene->clear();
+	m_journal->stop(true);
+	m_undoStack->clear();
+	m_graphScene->clearGraph();
 	m_graphScene->setCurrentID(0);
 	ui->graphicsView->repaint();
+
+	startJournal(false);
 }
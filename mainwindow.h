@@ -15,10 +15,14 @@
 #include <QAbstractButton>
 #include <QBrush>
 #include <QGraphicsDropShadowEffect>
+#include <QProgressBar>
+#include <QUndoStack>
 
 #include "graphscene.h"
 #include "graphnode.h"
 #include "graphproxy.h"
+#include "graphloader.h"
+#include "graphjournal.h"
 
 namespace Ui
 {
@@ -34,6 +38,7 @@ class MainWindow : public QMainWindow
 		~MainWindow();
 
 		bool loadFromFile(const QString &filename);
+		void startJournal(bool offerRecovery = true);
 
 	protected:
 		void changeEvent(QEvent *e);
@@ -44,6 +49,12 @@ class MainWindow : public QMainWindow
 		void setStartNode();
 		void setNormalNode();
 		void setStartEndNode();
+		void editNodeDataFlow();
+		void editNodeCallee();
+		void editEdgeCost();
+		void forbidSelectedPath();
+		void makeSelectedEdgesExclusive();
+		void removeSelectedConstraints();
 
 		void graphButtonGroupClicked(int id);
 
@@ -52,8 +63,15 @@ class MainWindow : public QMainWindow
 		void zoomResetTriggered();
 
 		void antialiasingActionTriggered(bool checked);
+		void touringActionTriggered(QAction *action);
+		void objectiveActionTriggered(QAction *action);
+		void optimizationTimeActionTriggered();
+		void perRequirementActionTriggered(bool checked);
+		void portfolioActionTriggered(bool checked);
 		void drawGridActionTriggered(bool checked);
 		void exportSceneToImageDialog();
+		void exportVisibleToImageDialog();
+		void exportHighlightedPathDialog();
 
 		void newActionTriggered();
 		void saveActionTriggered();
@@ -61,10 +79,17 @@ class MainWindow : public QMainWindow
 
 		void openGraphDialog();
 
+		void graphLoaderChunkReady();
+		void graphLoaderFinished();
+
 		void updateWindowName();
 		void graphSceneChanged();
 
+		void undoStackIndexChanged();
+		void undoStackCleanChanged(bool clean);
+
 		bool validateGraph();
+		bool confirmRequirementCount(QAbstractButton *button);
 		void validateGraphActionTriggered();
 		void computeButtonGroupClicked(QAbstractButton *button);
 		void backToEditMode();
@@ -83,6 +108,9 @@ class MainWindow : public QMainWindow
 		bool m_inViewMode;
 
 		GraphProxy *m_graphProxy;
+		GraphLoader *m_graphLoader;
+		QUndoStack *m_undoStack;
+		GraphJournal *m_journal;
 
 		QString m_currentFilename;
 		QSize m_maxSceneSize;
@@ -91,7 +119,9 @@ class MainWindow : public QMainWindow
 		QColor m_viewModeBcgColor;
 
 		QMenu *m_nodeMenu;
+		QMenu *m_editMenu;
 		QLabel *m_zoomLabel;
+		QProgressBar *m_loadProgressBar;
 
 		QToolButton *m_addNodeButton;
 		QToolButton *m_manipulateButton;
@@ -101,6 +131,9 @@ class MainWindow : public QMainWindow
 		QAction *m_zoomInAction;
 		QAction *m_zoomOutAction;
 		QAction *m_zoomResetAction;
+		QAction *m_exportPathAction;
+		QAction *m_undoAction;
+		QAction *m_redoAction;
 
 		QToolBar *m_fileToolBar;
 		QToolBar *m_graphToolBar;
@@ -117,6 +150,7 @@ class MainWindow : public QMainWindow
 		QGraphicsDropShadowEffect *m_dropShadowEffect;
 
 		bool saveToFile(const QString &filename);
+		bool exportRegionToImage(const QRectF &sourceRect, bool onlyHighlighted);
 
 		void setSelectedNodesType(GraphNode::NodeType type);
 		void updateZoom();
@@ -125,6 +159,9 @@ class MainWindow : public QMainWindow
 
 		bool proceedIfUnsaved();
 
+		void setLoading(bool loading);
+		void cancelLoading();
+
 		void initSettings();
 
 		void setupActions();
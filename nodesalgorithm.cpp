@@ -6,6 +6,9 @@ void NodesAlgorithm::onCompute()
 {
 	foreach(Node *node, nodes())
 	{
+		if(isOverBudget())
+			return;
+
 		addReqResult(new Path(node));
 	}
 }
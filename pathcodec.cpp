@@ -0,0 +1,182 @@
+#include "pathcodec.h"
+
+using namespace Algorithm;
+
+void PathCodec::writeVarint(QByteArray &out, quint32 value)
+{
+	while(value >= 0x80)
+	{
+		out.append((char)((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+
+	out.append((char)value);
+}
+
+bool PathCodec::readVarint(const char *&data, const char *end, quint32 &value)
+{
+	value = 0;
+
+	for(int shift = 0; shift < 35 && data < end; shift += 7)
+	{
+		quint8 byte = (quint8)*data++;
+		value |= (quint32)(byte & 0x7F) << shift;
+
+		if(!(byte & 0x80))
+			return true;
+	}
+
+	return false;
+}
+
+bool PathCodec::readVarint(QIODevice *device, quint32 &value)
+{
+	value = 0;
+
+	for(int shift = 0; shift < 35; shift += 7)
+	{
+		char byte;
+
+		if(!device->getChar(&byte))
+			return false;
+
+		value |= (quint32)((quint8)byte & 0x7F) << shift;
+
+		if(!((quint8)byte & 0x80))
+			return true;
+	}
+
+	return false;
+}
+
+void PathCodec::encode(QByteArray &out, const QVector<int> &previous, const QVector<int> &path)
+{
+	int prefix = 0;
+	int limit = qMin(previous.size(), path.size());
+
+	while(prefix < limit && previous.at(prefix) == path.at(prefix))
+		prefix++;
+
+	writeVarint(out, prefix);
+	writeVarint(out, path.size() - prefix);
+
+	for(int i = prefix; i < path.size(); ++i)
+		writeVarint(out, path.at(i));
+}
+
+bool PathCodec::decode(const char *&data, const char *end, QVector<int> &path)
+{
+	quint32 prefix, rest, node;
+
+	if(!readVarint(data, end, prefix) || !readVarint(data, end, rest) || prefix > (quint32)path.size())
+		return false;
+
+	path.resize(prefix + rest);
+
+	for(quint32 i = 0; i < rest; ++i)
+	{
+		if(!readVarint(data, end, node))
+			return false;
+
+		path[prefix + i] = node;
+	}
+
+	return true;
+}
+
+bool PathCodec::decode(QIODevice *device, QVector<int> &path)
+{
+	quint32 prefix, rest, node;
+
+	if(!readVarint(device, prefix) || !readVarint(device, rest) || prefix > (quint32)path.size())
+		return false;
+
+	path.resize(prefix + rest);
+
+	for(quint32 i = 0; i < rest; ++i)
+	{
+		if(!readVarint(device, node))
+			return false;
+
+		path[prefix + i] = node;
+	}
+
+	return true;
+}
+
+CompressedPaths::CompressedPaths()
+	: m_count(0)
+{
+}
+
+void CompressedPaths::append(const QVector<int> &path)
+{
+	// a block starts with a path which doesn't refer to the one before
+	if(m_count % BlockSize == 0)
+	{
+		m_blockOffsets.append(m_bytes.size());
+		m_last.clear();
+	}
+
+	PathCodec::encode(m_bytes, m_last, path);
+
+	m_last = path;
+	m_count++;
+}
+
+QVector<int> CompressedPaths::at(int index) const
+{
+	QVector<int> path;
+
+	if(index < 0 || index >= m_count)
+		return path;
+
+	const char *data = m_bytes.constData() + m_blockOffsets.at(index / BlockSize);
+	const char *end = m_bytes.constData() + m_bytes.size();
+
+	for(int i = 0; i <= index % BlockSize; ++i)
+		PathCodec::decode(data, end, path);
+
+	return path;
+}
+
+void CompressedPaths::clear()
+{
+	m_bytes.clear();
+	m_blockOffsets.clear();
+	m_last.clear();
+	m_count = 0;
+}
+
+void CompressedPaths::write(QDataStream &stream) const
+{
+	stream << (qint32)m_count << m_bytes << m_blockOffsets;
+}
+
+bool CompressedPaths::read(QDataStream &stream)
+{
+	clear();
+
+	qint32 count;
+	stream >> count >> m_bytes >> m_blockOffsets;
+
+	bool ok = stream.status() == QDataStream::Ok && count >= 0 &&
+		  m_blockOffsets.size() == (count + BlockSize - 1) / BlockSize;
+
+	for(int i = 0; ok && i < m_blockOffsets.size(); ++i)
+		ok = m_blockOffsets.at(i) < (quint32)m_bytes.size();
+
+	if(!ok)
+	{
+		clear();
+		return false;
+	}
+
+	m_count = count;
+
+	// only the last path is needed to append more
+	if(m_count > 0)
+		m_last = at(m_count - 1);
+
+	return true;
+}
@@ -0,0 +1,62 @@
+#ifndef PATHCODEC_H
+#define PATHCODEC_H
+
+#include <QByteArray>
+#include <QVector>
+#include <QDataStream>
+#include <QIODevice>
+
+namespace Algorithm
+{
+	/* Compact encoding of paths given as node indexes. A path is stored as
+	   the length of the prefix it shares with the previous one, the length
+	   of the rest and the rest itself, every number as a varint (7 bits a
+	   byte, the high bit set when more bytes follow). Paths enumerated depth
+	   first or sorted share long prefixes and most indexes take one byte.
+	*/
+	namespace PathCodec
+	{
+		void writeVarint(QByteArray &out, quint32 value);
+		bool readVarint(const char *&data, const char *end, quint32 &value);
+		bool readVarint(QIODevice *device, quint32 &value);
+
+		void encode(QByteArray &out, const QVector<int> &previous, const QVector<int> &path);
+
+		// path has to hold the previous path and is replaced by the decoded one
+		bool decode(const char *&data, const char *end, QVector<int> &path);
+		bool decode(QIODevice *device, QVector<int> &path);
+	}
+
+	/* Encoded paths in memory. Every BlockSize-th path is encoded on its
+	   own and its offset kept in the block index, so a path is reached by
+	   decoding at most BlockSize paths. */
+	class CompressedPaths
+	{
+		public:
+			CompressedPaths();
+
+			void append(const QVector<int> &path);
+
+			int size() const { return m_count; }
+			bool isEmpty() const { return m_count == 0; }
+			QVector<int> at(int index) const;
+
+			qint64 byteSize() const { return m_bytes.size() + m_blockOffsets.size() * sizeof(quint32); }
+			const QByteArray &bytes() const { return m_bytes; }
+
+			void clear();
+
+			void write(QDataStream &stream) const;
+			bool read(QDataStream &stream);
+
+			static const int BlockSize = 64;
+
+		private:
+			QByteArray m_bytes;
+			QVector<quint32> m_blockOffsets;
+			QVector<int> m_last;
+			int m_count;
+	};
+}
+
+#endif // PATHCODEC_H
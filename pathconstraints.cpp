@@ -0,0 +1,35 @@
+#include "pathconstraints.h"
+
+#include <QHash>
+
+#include "graphmodel.h"
+
+using namespace Algorithm;
+using namespace GraphModelTypes;
+
+PathConstraints Algorithm::constraintsFromModel(const GraphModel &model, const QList<Node*> &nodes)
+{
+	PathConstraints constraints;
+	QHash<int, Node*> nodesById;
+
+	foreach(Node *node, nodes)
+		nodesById.insert(node->id(), node);
+
+	foreach(const ModelConstraint &constraint, model.constraints())
+	{
+		if(!model.isConstraintValid(constraint))
+			continue;
+
+		QList<Node*> constraintNodes;
+
+		foreach(int id, constraint.nodeIds)
+			constraintNodes.append(nodesById.value(id));
+
+		if(constraint.type == ModelConstraint::ExclusiveEdges)
+			constraints.addExclusiveEdges(constraintNodes);
+		else
+			constraints.addForbiddenPath(constraintNodes);
+	}
+
+	return constraints;
+}
@@ -0,0 +1,37 @@
+#ifndef PATHCONSTRAINTS_H
+#define PATHCONSTRAINTS_H
+
+#include <QList>
+
+#include "algorithmnode.h"
+
+class GraphModel;
+
+namespace Algorithm
+{
+	/* Paths no execution of the program takes, so no test path may either.
+	   A forbidden path may not appear anywhere in a test path, an exclusive
+	   pair is two edges (from, to, from, to) of which a test path takes one
+	   at most. */
+	class PathConstraints
+	{
+		public:
+			void addForbiddenPath(const QList<Node*> &path) { m_forbiddenPaths.append(path); }
+			void addExclusiveEdges(const QList<Node*> &edges) { m_exclusiveEdges.append(edges); }
+
+			const QList<QList<Node*> > &forbiddenPaths() const { return m_forbiddenPaths; }
+			const QList<QList<Node*> > &exclusiveEdges() const { return m_exclusiveEdges; }
+
+			bool isEmpty() const { return m_forbiddenPaths.isEmpty() && m_exclusiveEdges.isEmpty(); }
+			void clear() { m_forbiddenPaths.clear(); m_exclusiveEdges.clear(); }
+
+		private:
+			QList<QList<Node*> > m_forbiddenPaths;
+			QList<QList<Node*> > m_exclusiveEdges;
+	};
+
+	// the valid constraints of the model over nodes made by nodesFromModel()
+	PathConstraints constraintsFromModel(const GraphModel &model, const QList<Node*> &nodes);
+}
+
+#endif // PATHCONSTRAINTS_H
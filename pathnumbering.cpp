@@ -0,0 +1,282 @@
+#include "pathnumbering.h"
+
+#include <QPair>
+
+using namespace Algorithm;
+
+PathNumbering::PathNumbering(const GraphSnapshot &snapshot)
+	: m_snapshot(snapshot), m_totalPaths(0), m_overflow(false)
+{
+	int nodeCount = snapshot.nodeCount();
+
+	m_backEdge.fill(false, snapshot.edgeCount());
+	m_entry.fill(false, nodeCount);
+	m_exit.fill(false, nodeCount);
+
+	QVector<int> postOrder;
+	findBackEdges(postOrder);
+
+	for(int v = 0; v < nodeCount; ++v)
+	{
+		if(snapshot.isStart(v))
+			m_entry[v] = true;
+
+		if(snapshot.isEnd(v))
+			m_exit[v] = true;
+	}
+
+	for(int e = 0; e < snapshot.edgeCount(); ++e)
+	{
+		if(m_backEdge.at(e))
+		{
+			m_entry[snapshot.edgeTarget(e)] = true;
+			m_exit[snapshot.edgeSource(e)] = true;
+		}
+	}
+
+	computeIncrements(postOrder);
+}
+
+quint64 PathNumbering::add(quint64 a, quint64 b)
+{
+	if(a > ~(quint64)0 - b)
+	{
+		m_overflow = true;
+		return ~(quint64)0;
+	}
+
+	return a + b;
+}
+
+void PathNumbering::findBackEdges(QVector<int> &postOrder)
+{
+	enum { White, Grey, Black };
+
+	int nodeCount = m_snapshot.nodeCount();
+	QVector<char> color(nodeCount, White);
+
+	// (node, next edge to look at)
+	QVector<QPair<int, int> > stack;
+
+	postOrder.reserve(nodeCount);
+
+	// start nodes go first, so that loops are cut where they are entered
+	QVector<int> roots;
+
+	for(int v = 0; v < nodeCount; ++v)
+		if(m_snapshot.isStart(v))
+			roots.append(v);
+
+	for(int v = 0; v < nodeCount; ++v)
+		if(!m_snapshot.isStart(v))
+			roots.append(v);
+
+	foreach(int root, roots)
+	{
+		if(color.at(root) != White)
+			continue;
+
+		color[root] = Grey;
+		stack.append(qMakePair(root, m_snapshot.edgeBegin(root)));
+
+		while(!stack.isEmpty())
+		{
+			int v = stack.last().first;
+			int &e = stack.last().second;
+
+			if(e == m_snapshot.edgeEnd(v))
+			{
+				color[v] = Black;
+				postOrder.append(v);
+				stack.removeLast();
+				continue;
+			}
+
+			int w = m_snapshot.edgeTarget(e++);
+
+			if(color.at(w) == Grey)
+			{
+				m_backEdge[e - 1] = true;
+			}
+			else if(color.at(w) == White)
+			{
+				color[w] = Grey;
+				stack.append(qMakePair(w, m_snapshot.edgeBegin(w)));
+			}
+		}
+	}
+}
+
+void PathNumbering::computeIncrements(const QVector<int> &postOrder)
+{
+	int nodeCount = m_snapshot.nodeCount();
+
+	m_numPaths.fill(0, nodeCount);
+	m_increments.fill(0, m_snapshot.edgeCount());
+	m_entryIncrements.fill(0, nodeCount);
+
+	/* Post order visits successors first. Ending at an exit counts as
+	   the first way out of a node, then come its edges in order. */
+	foreach(int v, postOrder)
+	{
+		quint64 paths = m_exit.at(v) ? 1 : 0;
+
+		for(int e = m_snapshot.edgeBegin(v); e < m_snapshot.edgeEnd(v); ++e)
+		{
+			if(m_backEdge.at(e))
+				continue;
+
+			m_increments[e] = paths;
+			paths = add(paths, m_numPaths.at(m_snapshot.edgeTarget(e)));
+		}
+
+		m_numPaths[v] = paths;
+	}
+
+	m_totalPaths = 0;
+
+	for(int v = 0; v < nodeCount; ++v)
+	{
+		if(!m_entry.at(v))
+			continue;
+
+		m_entryIncrements[v] = m_totalPaths;
+		m_totalPaths = add(m_totalPaths, m_numPaths.at(v));
+	}
+}
+
+QList<int> PathNumbering::backEdges() const
+{
+	QList<int> edges;
+
+	for(int e = 0; e < m_backEdge.size(); ++e)
+		if(m_backEdge.at(e))
+			edges.append(e);
+
+	return edges;
+}
+
+QList<int> PathNumbering::entries() const
+{
+	QList<int> nodes;
+
+	for(int v = 0; v < m_entry.size(); ++v)
+		if(m_entry.at(v))
+			nodes.append(v);
+
+	return nodes;
+}
+
+quint64 PathNumbering::pathCount(int entry) const
+{
+	if(!m_entry.at(entry))
+		return 0;
+
+	return m_numPaths.at(entry);
+}
+
+bool PathNumbering::encode(const QVector<int> &path, quint64 &id) const
+{
+	if(path.isEmpty() || !m_entry.at(path.first()) || !m_exit.at(path.last()))
+		return false;
+
+	id = m_entryIncrements.at(path.first());
+
+	for(int i = 0; i + 1 < path.size(); ++i)
+	{
+		int e = m_snapshot.findEdge(path.at(i), path.at(i + 1));
+
+		if(e == -1 || m_backEdge.at(e))
+			return false;
+
+		id += m_increments.at(e);
+	}
+
+	return true;
+}
+
+bool PathNumbering::encode(const Path *path, quint64 &id) const
+{
+	QVector<int> indexes;
+
+	foreach(Node *node, path->nodes())
+	{
+		int v = m_snapshot.indexOf(node);
+
+		if(v == -1)
+			return false;
+
+		indexes.append(v);
+	}
+
+	return encode(indexes, id);
+}
+
+QVector<int> PathNumbering::decode(quint64 id) const
+{
+	QVector<int> path;
+
+	if(m_overflow || id >= m_totalPaths)
+		return path;
+
+	int v = -1;
+
+	for(int u = 0; u < m_entry.size(); ++u)
+	{
+		if(m_entry.at(u) && id >= m_entryIncrements.at(u) &&
+		   id - m_entryIncrements.at(u) < m_numPaths.at(u))
+		{
+			v = u;
+			break;
+		}
+	}
+
+	if(v == -1)
+		return path;
+
+	id -= m_entryIncrements.at(v);
+	path.append(v);
+
+	while(!(m_exit.at(v) && id == 0))
+	{
+		int next = -1;
+
+		for(int e = m_snapshot.edgeBegin(v); e < m_snapshot.edgeEnd(v); ++e)
+		{
+			if(m_backEdge.at(e))
+				continue;
+
+			int w = m_snapshot.edgeTarget(e);
+
+			if(id >= m_increments.at(e) && id - m_increments.at(e) < m_numPaths.at(w))
+			{
+				id -= m_increments.at(e);
+				next = w;
+				break;
+			}
+		}
+
+		if(next == -1)
+			return QVector<int>();
+
+		v = next;
+		path.append(v);
+	}
+
+	return path;
+}
+
+Path *PathNumbering::decodePath(quint64 id) const
+{
+	QVector<int> indexes = decode(id);
+
+	if(indexes.isEmpty())
+		return 0;
+
+	Path *path = new Path();
+
+	foreach(int v, indexes)
+		path->appendNode(m_snapshot.node(v));
+
+	return path;
+}
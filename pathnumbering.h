@@ -0,0 +1,68 @@
+#ifndef PATHNUMBERING_H
+#define PATHNUMBERING_H
+
+#include <QVector>
+#include <QList>
+
+#include "graphsnapshot.h"
+#include "algorithmpath.h"
+
+namespace Algorithm
+{
+	/* Ball-Larus path numbering. Back edges found by a depth first search
+	   (started from the start nodes) are cut, their targets become entries
+	   and their sources exits of the remaining acyclic graph, next to the
+	   start and end nodes. Every entry-to-exit path then gets a unique id
+	   in 0..pathCount()-1, which is the sum of the increments of its edges.
+
+	   Counts and ids saturate at 2^64-1, hasOverflowed() tells when that
+	   happened and the ids are not usable.
+	*/
+	class PathNumbering
+	{
+		public:
+			PathNumbering(const GraphSnapshot &snapshot);
+
+			const GraphSnapshot &snapshot() const { return m_snapshot; }
+
+			bool isBackEdge(int e) const { return m_backEdge.at(e); }
+			bool isEntry(int v) const { return m_entry.at(v); }
+			bool isExit(int v) const { return m_exit.at(v); }
+
+			QList<int> backEdges() const;
+			QList<int> entries() const;
+
+			// paths from the given entry, or from all of them
+			quint64 pathCount(int entry) const;
+			quint64 pathCount() const { return m_totalPaths; }
+			bool hasOverflowed() const { return m_overflow; }
+
+			quint64 increment(int e) const { return m_increments.at(e); }
+
+			bool encode(const QVector<int> &path, quint64 &id) const;
+			bool encode(const Path *path, quint64 &id) const;
+
+			QVector<int> decode(quint64 id) const;
+			Path *decodePath(quint64 id) const;
+
+		private:
+			const GraphSnapshot &m_snapshot;
+
+			QVector<bool> m_backEdge;
+			QVector<bool> m_entry;
+			QVector<bool> m_exit;
+
+			QVector<quint64> m_numPaths;
+			QVector<quint64> m_increments;
+			QVector<quint64> m_entryIncrements;
+			quint64 m_totalPaths;
+			bool m_overflow;
+
+			quint64 add(quint64 a, quint64 b);
+
+			void findBackEdges(QVector<int> &postOrder);
+			void computeIncrements(const QVector<int> &postOrder);
+	};
+}
+
+#endif // PATHNUMBERING_H
@@ -0,0 +1,381 @@
+#include "pathstore.h"
+
+#include <QDir>
+#include <QHash>
+#include <QPair>
+#include <QtAlgorithms>
+#include <QDebug>
+#include <QObject>
+
+#include <algorithm>
+#include <queue>
+
+using namespace Algorithm;
+
+// heap bytes of a buffered path besides its nodes
+#define BUFFERED_PATH_OVERHEAD 32
+
+PathStore::PathStore(qint64 bufferBytes)
+	: m_bufferBytes(bufferBytes), m_bufferedBytes(0), m_count(0), m_finished(false)
+{
+}
+
+PathStore::~PathStore()
+{
+	qDeleteAll(m_runs);
+}
+
+bool PathStore::lessThan(const QVector<int> &a, const QVector<int> &b)
+{
+	return std::lexicographical_compare(a.constBegin(), a.constEnd(), b.constBegin(), b.constEnd());
+}
+
+QTemporaryFile *PathStore::createRun()
+{
+	QTemporaryFile *run = new QTemporaryFile(QDir::tempPath() + "/qcoverage-paths-XXXXXX");
+
+	if(!run->open())
+	{
+		m_errorString = run->errorString();
+		delete run;
+		return 0;
+	}
+
+	return run;
+}
+
+bool PathStore::append(const QVector<int> &path)
+{
+	if(m_finished)
+		return false;
+
+	m_buffer.append(path);
+	m_bufferedBytes += path.size() * sizeof(int) + BUFFERED_PATH_OVERHEAD;
+
+	if(m_bufferedBytes >= m_bufferBytes)
+		return spill();
+
+	return true;
+}
+
+bool PathStore::spill()
+{
+	qSort(m_buffer.begin(), m_buffer.end(), lessThan);
+
+	QTemporaryFile *run = createRun();
+
+	if(run == 0)
+		return false;
+
+	QByteArray encoded;
+	QVector<int> previous;
+
+	// duplicates inside a run are dropped right away
+	for(int i = 0; i < m_buffer.size(); ++i)
+	{
+		if(i != 0 && m_buffer.at(i) == previous)
+			continue;
+
+		PathCodec::encode(encoded, previous, m_buffer.at(i));
+		previous = m_buffer.at(i);
+	}
+
+	if(run->write(encoded) != encoded.size() || !run->flush())
+	{
+		m_errorString = run->errorString();
+		delete run;
+		return false;
+	}
+
+	m_runs.append(run);
+	m_buffer.clear();
+	m_bufferedBytes = 0;
+
+	return true;
+}
+
+namespace
+{
+	typedef struct
+	{
+		QVector<int> path;
+		int run;
+	} MergeHead;
+
+	struct MergeHeadGreater
+	{
+		bool operator()(const MergeHead &a, const MergeHead &b) const
+		{
+			return std::lexicographical_compare(b.path.constBegin(), b.path.constEnd(),
+							    a.path.constBegin(), a.path.constEnd());
+		}
+	};
+}
+
+QTemporaryFile *PathStore::mergeRuns(const QList<QTemporaryFile*> &runs)
+{
+	QTemporaryFile *merged = createRun();
+
+	if(merged == 0)
+		return 0;
+
+	std::priority_queue<MergeHead, std::vector<MergeHead>, MergeHeadGreater> heads;
+
+	// every run is decoded against its own previous path
+	QVector<QVector<int> > previous(runs.size());
+
+	for(int i = 0; i < runs.size(); ++i)
+	{
+		runs.at(i)->seek(0);
+
+		MergeHead head;
+		head.run = i;
+
+		if(PathCodec::decode(runs.at(i), previous[i]))
+		{
+			head.path = previous.at(i);
+			heads.push(head);
+		}
+	}
+
+	QByteArray encoded;
+	QVector<int> last;
+	bool first = true;
+	bool ok = true;
+	m_count = 0;
+
+	while(!heads.empty() && ok)
+	{
+		MergeHead head = heads.top();
+		heads.pop();
+
+		if(first || head.path != last)
+		{
+			PathCodec::encode(encoded, last, head.path);
+			last = head.path;
+			first = false;
+			m_count++;
+
+			if(encoded.size() >= MergeWriteBytes)
+			{
+				ok = merged->write(encoded) == encoded.size();
+				encoded.clear();
+			}
+		}
+
+		QIODevice *run = runs.at(head.run);
+
+		if(PathCodec::decode(run, previous[head.run]))
+		{
+			head.path = previous.at(head.run);
+			heads.push(head);
+		}
+		else if(!run->atEnd())
+		{
+			ok = false;
+		}
+	}
+
+	ok = ok && merged->write(encoded) == encoded.size() && merged->flush();
+
+	if(!ok)
+	{
+		m_errorString = QObject::tr("Could not merge the path runs");
+		delete merged;
+		return 0;
+	}
+
+	return merged;
+}
+
+bool PathStore::finish()
+{
+	if(m_finished)
+		return true;
+
+	m_finished = true;
+
+	if(m_runs.isEmpty())
+	{
+		qSort(m_buffer.begin(), m_buffer.end(), lessThan);
+
+		for(int i = 0; i < m_buffer.size(); ++i)
+			if(i == 0 || m_buffer.at(i) != m_buffer.at(i - 1))
+				m_paths.append(m_buffer.at(i));
+
+		m_buffer.clear();
+		m_bufferedBytes = 0;
+		m_count = m_paths.size();
+
+		return true;
+	}
+
+	if(!m_buffer.isEmpty() && !spill())
+		return false;
+
+	// merged in passes, so that only so many files are open at once
+	do
+	{
+		QList<QTemporaryFile*> group;
+
+		while(!m_runs.isEmpty() && group.size() < MergeFanIn)
+			group.append(m_runs.takeFirst());
+
+		QTemporaryFile *merged = mergeRuns(group);
+		qDeleteAll(group);
+
+		if(merged == 0)
+			return false;
+
+		m_runs.append(merged);
+	}
+	while(m_runs.size() > 1);
+
+	return true;
+}
+
+quint64 PathStore::countCovered(const QList<QVector<int> > &walks, PathStore *uncovered)
+{
+	// where every node occurs in the walks
+	QHash<int, QList<QPair<int, int> > > occurrences;
+
+	for(int w = 0; w < walks.size(); ++w)
+		for(int i = 0; i < walks.at(w).size(); ++i)
+			occurrences[walks.at(w).at(i)].append(qMakePair(w, i));
+
+	Reader reader(*this);
+	QVector<int> path;
+	quint64 covered = 0;
+
+	while(reader.next(path))
+	{
+		bool found = false;
+
+		if(!path.isEmpty())
+		{
+			foreach(const QPair<int, int> &occurrence, occurrences.value(path.first()))
+			{
+				const QVector<int> &walk = walks.at(occurrence.first);
+
+				if(occurrence.second + path.size() > walk.size())
+					continue;
+
+				found = std::equal(path.constBegin(), path.constEnd(), walk.constBegin() + occurrence.second);
+
+				if(found)
+					break;
+			}
+		}
+
+		if(found)
+			covered++;
+		else if(uncovered != 0)
+			uncovered->append(path);
+	}
+
+	return covered;
+}
+
+bool PathStore::writeCompressed(QDataStream &stream)
+{
+	if(!hasSpilled())
+	{
+		m_paths.write(stream);
+		return stream.status() == QDataStream::Ok;
+	}
+
+	// the block index is all that is kept from the first pass
+	QVector<quint32> blockOffsets;
+	QByteArray encoded;
+	QVector<int> path;
+	QVector<int> last;
+	qint64 byteCount = 0;
+	quint64 index = 0;
+
+	Reader sizes(*this);
+
+	while(sizes.next(path))
+	{
+		if(index % CompressedPaths::BlockSize == 0)
+		{
+			blockOffsets.append((quint32)byteCount);
+			last.clear();
+		}
+
+		encoded.clear();
+		PathCodec::encode(encoded, last, path);
+		byteCount += encoded.size();
+		last = path;
+		index++;
+
+		if(byteCount > MaxCompressedBytes || index > 0x7FFFFFFF)
+		{
+			m_errorString = QObject::tr("Too many paths for the binary format");
+			return false;
+		}
+	}
+
+	// as QDataStream writes a QByteArray, then the rest of it
+	stream << (qint32)index << (quint32)byteCount;
+
+	Reader paths(*this);
+	encoded.clear();
+	index = 0;
+
+	while(paths.next(path))
+	{
+		if(index % CompressedPaths::BlockSize == 0)
+			last.clear();
+
+		PathCodec::encode(encoded, last, path);
+		last = path;
+		index++;
+
+		if(encoded.size() >= MergeWriteBytes)
+		{
+			stream.writeRawData(encoded.constData(), encoded.size());
+			encoded.clear();
+		}
+	}
+
+	stream.writeRawData(encoded.constData(), encoded.size());
+	stream << blockOffsets;
+
+	if(stream.status() != QDataStream::Ok)
+	{
+		m_errorString = QObject::tr("Could not write the paths");
+		return false;
+	}
+
+	return true;
+}
+
+PathStore::Reader::Reader(const PathStore &store)
+	: m_store(store), m_data(store.m_paths.bytes().constData()),
+	  m_end(store.m_paths.bytes().constData() + store.m_paths.bytes().size())
+{
+	if(store.m_runs.isEmpty())
+		return;
+
+	m_file.setFileName(store.m_runs.first()->fileName());
+
+	if(!m_file.open(QIODevice::ReadOnly))
+	{
+#ifdef DEBUG
+		qWarning() << "PathStore::Reader: can't open run" << m_file.fileName();
+#endif
+		return;
+	}
+}
+
+bool PathStore::Reader::next(QVector<int> &path)
+{
+	// path has to be the one returned before, the next one is decoded against it
+	if(m_store.m_runs.isEmpty())
+		return m_data < m_end && PathCodec::decode(m_data, m_end, path);
+
+	if(!m_file.isOpen() || m_file.atEnd())
+		return false;
+
+	return PathCodec::decode(&m_file, path);
+}
@@ -0,0 +1,96 @@
+#ifndef PATHSTORE_H
+#define PATHSTORE_H
+
+#include <QList>
+#include <QVector>
+#include <QString>
+#include <QFile>
+#include <QTemporaryFile>
+
+#include "pathcodec.h"
+
+namespace Algorithm
+{
+	/* Collection of paths (node index sequences) too large for memory.
+	   Paths are buffered up to a byte limit, a full buffer is sorted and
+	   written to a temporary file as a run. finish() merges the runs into
+	   one sorted run without duplicates, which can then be read back one
+	   path at a time. A store that never filled its buffer keeps its paths
+	   in memory. Either way they are kept encoded by PathCodec, sorted
+	   paths share long prefixes.
+	*/
+	class PathStore
+	{
+		public:
+			PathStore(qint64 bufferBytes = DefaultBufferBytes);
+			~PathStore();
+
+			bool append(const QVector<int> &path);
+			bool finish();
+
+			// unique paths, known after finish()
+			quint64 count() const { return m_count; }
+			bool hasSpilled() const { return !m_runs.isEmpty(); }
+
+			// the paths of a store which didn't spill, after finish()
+			const CompressedPaths &paths() const { return m_paths; }
+			const QString &errorString() const { return m_errorString; }
+
+			/* Writes the paths after finish() the way CompressedPaths::write()
+			   does, the spilled ones a piece at a time. The byte size comes
+			   first, so they are encoded twice; false when they are too many
+			   for the format. */
+			bool writeCompressed(QDataStream &stream);
+
+			/* Streams the stored paths and counts those which are a part of
+			   one of the walks, the others can be collected in a store. */
+			quint64 countCovered(const QList<QVector<int> > &walks, PathStore *uncovered = 0);
+
+			class Reader
+			{
+				public:
+					Reader(const PathStore &store);
+
+					// give it the same vector every time, paths are front coded
+					bool next(QVector<int> &path);
+
+				private:
+					const PathStore &m_store;
+					QFile m_file;
+					const char *m_data;
+					const char *m_end;
+			};
+
+			static const qint64 DefaultBufferBytes = 64 * 1024 * 1024;
+
+			// runs merged at once, each one keeps an open file
+			static const int MergeFanIn = 32;
+
+			// the merged run is written in pieces of this size
+			static const int MergeWriteBytes = 1024 * 1024;
+
+			// what the 32 bit sizes and offsets of CompressedPaths can address
+			static const qint64 MaxCompressedBytes = 0x7FFFFFFF;
+
+		private:
+			qint64 m_bufferBytes;
+			qint64 m_bufferedBytes;
+			QList<QVector<int> > m_buffer;
+			CompressedPaths m_paths;
+
+			QList<QTemporaryFile*> m_runs;
+			quint64 m_count;
+			bool m_finished;
+			QString m_errorString;
+
+			bool spill();
+			QTemporaryFile *mergeRuns(const QList<QTemporaryFile*> &runs);
+			QTemporaryFile *createRun();
+
+			static bool lessThan(const QVector<int> &a, const QVector<int> &b);
+
+			friend class Reader;
+	};
+}
+
+#endif // PATHSTORE_H
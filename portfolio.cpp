@@ -0,0 +1,311 @@
+#include "portfolio.h"
+
+#include <QFile>
+#include <QFuture>
+#include <QtConcurrentRun>
+#include <QTextStream>
+#include <QDateTime>
+#include <QDebug>
+
+#include "graphsnapshot.h"
+#include "suiteoptimizer.h"
+
+using namespace Algorithm;
+
+// costs closer than this are the same
+#define COST_EPSILON 1e-9
+
+namespace
+{
+	// an algorithm whose requirements were found by another one
+	class GivenRequirements : public AbstractAlgorithm
+	{
+		public:
+			GivenRequirements(const QList<Path*> &requirements) : m_requirements(requirements) {}
+
+		protected:
+			void onCompute()
+			{
+				foreach(Path *path, m_requirements)
+					addReqResult(new Path(path));
+			}
+
+		private:
+			const QList<Path*> &m_requirements;
+	};
+
+	QString csvField(const QString &text)
+	{
+		QString field(text);
+
+		if(!field.contains(',') && !field.contains('"') && !field.contains('\n'))
+			return field;
+
+		return "\"" + field.replace("\"", "\"\"") + "\"";
+	}
+}
+
+Portfolio::Portfolio(const QList<Node*> &nodes, const QList<Path*> &requirements)
+	: m_nodes(nodes), m_requirements(requirements), m_strategies(allStrategies()),
+	  m_touring(DirectTouring), m_objective(FewestPaths), m_searchTime(DefaultSearchTime),
+	  m_winner(-1), m_lowerBound(0), m_cancel(0)
+{
+}
+
+Portfolio::~Portfolio()
+{
+	qDeleteAll(m_covResults);
+}
+
+QString Portfolio::strategyText(Strategy strategy)
+{
+	switch(strategy)
+	{
+		case CostStrategy:
+			return "cost";
+
+		case SearchStrategy:
+			return "search";
+
+		case ShortestStrategy:
+			return "shortest";
+
+		default: ;
+	}
+
+	return "merge";
+}
+
+Portfolio::Strategy Portfolio::strategyFromText(const QString &text, bool *ok)
+{
+	foreach(Strategy strategy, allStrategies())
+	{
+		if(strategyText(strategy) == text)
+		{
+			if(ok != 0)
+				*ok = true;
+
+			return strategy;
+		}
+	}
+
+	if(ok != 0)
+		*ok = false;
+
+	return MergeStrategy;
+}
+
+QList<Portfolio::Strategy> Portfolio::allStrategies()
+{
+	return QList<Strategy>() << MergeStrategy << CostStrategy << SearchStrategy << ShortestStrategy;
+}
+
+void Portfolio::computeLowerBound()
+{
+	m_lowerBound = 0;
+
+	// requirements the constraints make infeasible would count too
+	if(!m_constraints.isEmpty() || m_requirements.isEmpty())
+		return;
+
+	GraphSnapshot snapshot(m_nodes);
+	QList<QVector<int> > sequences;
+
+	foreach(Path *path, m_requirements)
+	{
+		QVector<int> sequence;
+
+		foreach(Node *node, path->nodes())
+			sequence.append(snapshot.indexOf(node));
+
+		sequences.append(sequence);
+	}
+
+	SuiteOptimizer optimizer(snapshot, sequences, m_touring);
+	m_lowerBound = optimizer.estimateLowerBound(m_budget.timeLimit > 0 ? m_budget.timeLimit : 0x7FFFFFFF);
+}
+
+void Portfolio::run()
+{
+	qDeleteAll(m_covResults);
+	m_covResults.clear();
+	m_entries.clear();
+	m_winner = -1;
+	m_cancel = 0;
+	m_timer.start();
+
+	computeLowerBound();
+
+	QList<QFuture<Entry> > futures;
+
+	foreach(Strategy strategy, m_strategies)
+		futures.append(QtConcurrent::run(this, &Portfolio::runStrategy, strategy));
+
+	for(int i = 0; i < futures.size(); ++i)
+	{
+		m_entries.append(futures[i].result());
+
+		const Entry &entry = m_entries.last();
+
+		if(!entry.skipped && (m_winner == -1 || isBetter(entry, m_entries.at(m_winner))))
+			m_winner = i;
+	}
+
+	if(m_winner == -1)
+		return;
+
+	foreach(const QList<Node*> &pathNodes, m_entries.at(m_winner).paths)
+		m_covResults.append(new Path(pathNodes));
+
+#ifdef DEBUG
+	qWarning() << "Portfolio::run:" << strategyText(m_entries.at(m_winner).strategy) << "won with"
+		   << m_entries.at(m_winner).pathCount << "paths in" << m_timer.elapsed() << "ms";
+#endif
+}
+
+Portfolio::Entry Portfolio::runStrategy(Strategy strategy)
+{
+	Entry entry;
+	entry.strategy = strategy;
+	entry.pathCount = 0;
+	entry.length = 0;
+	entry.cost = 0;
+	entry.elapsed = 0;
+	entry.truncation = ResourceBudget::NoLimit;
+	entry.constraintsIgnored = false;
+	entry.cancelled = false;
+
+	// neither the optimizer nor the shortest paths know of the constraints
+	entry.skipped = (strategy == SearchStrategy || strategy == ShortestStrategy) && !m_constraints.isEmpty();
+
+	if(entry.skipped)
+		return entry;
+
+	QTime timer;
+	timer.start();
+
+	// strategies queued behind others get what is left of the deadline
+	ResourceBudget budget(m_budget);
+
+	if(budget.timeLimit > 0)
+		budget.timeLimit -= m_timer.elapsed();
+
+	if(m_cancel != 0 || (m_budget.timeLimit > 0 && budget.timeLimit <= 0))
+	{
+		entry.truncation = ResourceBudget::TimeLimit;
+		entry.cancelled = m_cancel != 0;
+		entry.skipped = true;
+		return entry;
+	}
+
+	GivenRequirements algorithm(m_requirements);
+
+	algorithm.setBudget(budget);
+	algorithm.setTouring(m_touring);
+	algorithm.setConstraints(m_constraints);
+	algorithm.setObjective(strategy == SearchStrategy ? m_objective
+				: strategy == CostStrategy ? LowestCost : FewestPaths);
+	algorithm.setOptimizationTime(strategy == SearchStrategy ? m_searchTime : 0);
+	algorithm.setOnePathPerRequirement(strategy == ShortestStrategy);
+	algorithm.setCancelFlag(&m_cancel);
+	algorithm.compute(m_nodes);
+
+	foreach(Path *path, algorithm.coverageResults())
+	{
+		entry.paths.append(path->nodes());
+		entry.length += path->edgeCount();
+	}
+
+	foreach(Path *path, algorithm.infeasibleResults())
+		entry.infeasible.append(algorithm.requirementsResults().indexOf(path));
+
+	entry.pathCount = entry.paths.size();
+	entry.cost = algorithm.suiteCost();
+	entry.truncation = algorithm.truncation();
+	entry.constraintsIgnored = algorithm.constraintsIgnored();
+	entry.cancelled = m_cancel != 0 && entry.truncation == ResourceBudget::TimeLimit;
+	entry.elapsed = timer.elapsed();
+
+	// nothing has fewer paths than the bound
+	if(m_objective == FewestPaths && entry.truncation == ResourceBudget::NoLimit
+	   && m_lowerBound > 0 && entry.pathCount <= m_lowerBound)
+		m_cancel.testAndSetRelaxed(0, 1);
+
+	return entry;
+}
+
+bool Portfolio::isBetter(const Entry &entry, const Entry &than) const
+{
+	bool complete = entry.truncation == ResourceBudget::NoLimit;
+	bool thanComplete = than.truncation == ResourceBudget::NoLimit;
+
+	if(complete != thanComplete)
+		return complete;
+
+	if(m_objective == LowestCost)
+	{
+		if(entry.cost < than.cost - COST_EPSILON)
+			return true;
+
+		if(entry.cost > than.cost + COST_EPSILON)
+			return false;
+
+		if(entry.pathCount != than.pathCount)
+			return entry.pathCount < than.pathCount;
+	}
+	else
+	{
+		if(entry.pathCount != than.pathCount)
+			return entry.pathCount < than.pathCount;
+
+		if(entry.length != than.length)
+			return entry.length < than.length;
+	}
+
+	return entry.elapsed < than.elapsed;
+}
+
+bool Portfolio::appendRecord(const QString &filename, const QString &graph, const QString &criterion) const
+{
+	QFile file(filename);
+	bool isNew = !file.exists() || file.size() == 0;
+
+	if(!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+	{
+#ifdef DEBUG
+		qWarning() << "Portfolio::appendRecord: can't open" << filename;
+#endif
+		return false;
+	}
+
+	QTextStream out(&file);
+
+	if(isNew)
+		out << "time,graph,criterion,touring,objective,lower bound,winner,strategies" << endl;
+
+	QStringList fields;
+
+	fields << QDateTime::currentDateTime().toString(Qt::ISODate) << csvField(graph) << csvField(criterion)
+	       << touringModeText(m_touring) << objectiveText(m_objective) << QString::number(m_lowerBound)
+	       << (m_winner == -1 ? QString() : strategyText(m_entries.at(m_winner).strategy));
+
+	// strategy:paths:cost:milliseconds, with how it ended when it did not finish
+	foreach(const Entry &entry, m_entries)
+	{
+		QString field = QString("%1:%2:%3:%4").arg(strategyText(entry.strategy)).arg(entry.pathCount)
+				.arg(entry.cost).arg(entry.elapsed);
+
+		if(entry.cancelled)
+			field += ":cancelled";
+		else if(entry.skipped)
+			field += ":skipped";
+		else if(entry.truncation != ResourceBudget::NoLimit)
+			field += ":truncated";
+
+		fields << field;
+	}
+
+	out << fields.join(",") << endl;
+
+	return out.status() == QTextStream::Ok;
+}
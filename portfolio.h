@@ -0,0 +1,115 @@
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QTime>
+#include <QAtomicInt>
+
+#include "algorithmnode.h"
+#include "algorithmpath.h"
+#include "abstractalgorithm.h"
+
+namespace Algorithm
+{
+	/* Builds test paths for the same requirements with several strategies
+	   at once, on the global thread pool, and keeps the best suite. All of
+	   them share the deadline of the budget. Suites are ranked complete
+	   first, then by fewest paths and shortest, or with LowestCost by
+	   cheapest and fewest, then by the time taken. Once a strategy reaches
+	   the lower bound of the number of paths the others are cancelled,
+	   nothing can beat it with FewestPaths.
+
+	   merge    the greedy merging of AbstractAlgorithm
+	   cost     the same, joining requirements by the cheapest edges
+	   search   the greedy suite improved by SuiteOptimizer for the search
+	            time, skipped under constraints
+	   shortest a shortest test path for every requirement, skipped under
+	            constraints
+	*/
+	class Portfolio
+	{
+		public:
+			enum Strategy { MergeStrategy, CostStrategy, SearchStrategy, ShortestStrategy };
+
+			typedef struct
+			{
+				Strategy strategy;
+				QList<QList<Node*> > paths;
+
+				// indexes into the requirements
+				QList<int> infeasible;
+
+				int pathCount;
+				int length;
+				double cost;
+				int elapsed;
+				ResourceBudget::Limit truncation;
+
+				// the test paths may break the constraints
+				bool constraintsIgnored;
+
+				bool cancelled;
+				bool skipped;
+			} Entry;
+
+			// requirements are over the nodes, neither is owned
+			Portfolio(const QList<Node*> &nodes, const QList<Path*> &requirements);
+			~Portfolio();
+
+			static QString strategyText(Strategy strategy);
+			static Strategy strategyFromText(const QString &text, bool *ok = 0);
+			static QList<Strategy> allStrategies();
+
+			void setStrategies(const QList<Strategy> &strategies) { m_strategies = strategies; }
+			void setBudget(const ResourceBudget &budget) { m_budget = budget; }
+			void setTouring(TouringMode touring) { m_touring = touring; }
+			void setObjective(Objective objective) { m_objective = objective; }
+			void setConstraints(const PathConstraints &constraints) { m_constraints = constraints; }
+
+			// milliseconds, the deadline of the budget comes first
+			void setSearchTime(int milliseconds) { m_searchTime = milliseconds; }
+
+			void run();
+
+			// index into entries(), -1 when no strategy gave a suite
+			int winner() const { return m_winner; }
+			const QList<Entry> &entries() const { return m_entries; }
+
+			// of the winner, owned by the portfolio
+			const QList<Path*> &coverageResults() const { return m_covResults; }
+			int lowerBound() const { return m_lowerBound; }
+
+			/* One line of comma separated values per run, a header first
+			   when the file is new. */
+			bool appendRecord(const QString &filename, const QString &graph, const QString &criterion) const;
+
+			static const int DefaultSearchTime = 2000;
+
+		private:
+			const QList<Node*> &m_nodes;
+			const QList<Path*> &m_requirements;
+
+			QList<Strategy> m_strategies;
+			ResourceBudget m_budget;
+			TouringMode m_touring;
+			Objective m_objective;
+			PathConstraints m_constraints;
+			int m_searchTime;
+
+			QList<Entry> m_entries;
+			QList<Path*> m_covResults;
+			int m_winner;
+			int m_lowerBound;
+
+			QTime m_timer;
+			QAtomicInt m_cancel;
+
+			Entry runStrategy(Strategy strategy);
+			bool isBetter(const Entry &entry, const Entry &than) const;
+			void computeLowerBound();
+	};
+}
+
+#endif // PORTFOLIO_H
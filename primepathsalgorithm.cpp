@@ -1,30 +1,289 @@
 #include "primepathsalgorithm.h"
 #include <QDebug>
+#include <QVector>
+
+#include "chainreduction.h"
+#include "graphsnapshot.h"
+#include "strongcomponents.h"
+#include "componentpaths.h"
 
 using namespace Algorithm;
 
+namespace
+{
+	// the order in which depth first search along Node::links() finds the paths
+	struct SearchOrder
+	{
+		const GraphSnapshot *snapshot;
+
+		bool operator()(const QVector<int> &a, const QVector<int> &b) const
+		{
+			if(a.first() != b.first())
+				return a.first() < b.first();
+
+			for(int i = 1; i < a.size() && i < b.size(); ++i)
+			{
+				if(a.at(i) == b.at(i))
+					continue;
+
+				return snapshot->findEdge(a.at(i - 1), a.at(i)) < snapshot->findEdge(b.at(i - 1), b.at(i));
+			}
+
+			return a.size() < b.size();
+		}
+	};
+}
+
 void PrimePathsAlgorithm::onCompute()
 {
-	simplePathsAlgorithm.compute(nodes(), false);
+	// the prime paths don't change when chains are collapsed, see addExpandedPaths()
+	ChainReduction reduction(nodes());
+	const QList<Node*> &graph = reduction.isReduced() ? reduction.reducedNodes() : nodes();
+
+	GraphSnapshot snapshot(graph);
+	StrongComponents components(snapshot);
+
+	ComponentPaths summaries(snapshot, components);
+	summaries.compute(budget(), elapsed());
+
+	// whatever is composed from partial summaries is still prime
+	if(summaries.truncation() != ResourceBudget::NoLimit)
+		truncate(summaries.truncation());
+
+	QList<QVector<int> > primes;
+
+	for(int v = 0; v < snapshot.nodeCount(); ++v)
+		primes += summaries.cyclesFrom(v);
 
-	QList<Path*> paths = simplePathsAlgorithm.requirementsResults();
+	composeOpenPaths(snapshot, components, summaries, primes);
 
-	foreach(Path *patha, paths)
+	SearchOrder order;
+	order.snapshot = &snapshot;
+	qSort(primes.begin(), primes.end(), order);
+
+	QList<Path*> paths;
+
+	foreach(const QVector<int> &prime, primes)
 	{
-		bool prime = true;
+		QList<Node*> pathNodes;
+
+		foreach(int v, prime)
+			pathNodes.append(snapshot.node(v));
+
+		paths.append(new Path(pathNodes));
+	}
 
-		foreach(Path *pathb, paths)
+	if(reduction.isReduced())
+	{
+		addExpandedPaths(reduction, paths);
+		qDeleteAll(paths);
+	}
+	else
+	{
+		for(int i = 0; i < paths.size(); ++i)
 		{
-			if(patha != pathb && pathb->containsPath(patha))
+			// the nodes are not reduced, the paths are taken as they are
+			if(isOverSizeBudget())
 			{
-				prime = false;
+				qDeleteAll(paths.mid(i));
 				break;
 			}
 
+			addReqResult(paths.at(i));
+		}
+	}
+}
+
+void PrimePathsAlgorithm::composeOpenPaths(const GraphSnapshot &snapshot, const StrongComponents &components,
+					   const ComponentPaths &summaries, QList<QVector<int> > &primes)
+{
+	/* An open prime path can't be extended at the start, so every edge into
+	   the start comes from its first component and from the path. Nor at
+	   the end, the edges out of the end go to the last component's part
+	   of the path (not to the start, that would close a cycle). Between
+	   them the path takes any summary path of every component it enters. */
+	int nodeCount = snapshot.nodeCount();
+
+	QVector<bool> onPath(nodeCount, false);
+	QVector<int> path;
+
+	// per component on the path: where it starts in path, next edge and next summary path
+	QVector<int> base;
+	QVector<int> nextEdge;
+	QVector<int> nextOption;
+
+	bool stopped = false;
+
+	for(int start = 0; start < nodeCount; ++start)
+	{
+		bool enteredFromOutside = false;
+
+		for(int i = snapshot.inEdgeBegin(start); i < snapshot.inEdgeEnd(start) && !enteredFromOutside; ++i)
+			enteredFromOutside = components.component(snapshot.edgeSource(snapshot.inEdge(i))) != components.component(start);
+
+		if(enteredFromOutside)
+			continue;
+
+		foreach(const QVector<int> &first, summaries.pathsFrom(start))
+		{
+			foreach(int v, first)
+				onPath[v] = true;
+
+			bool startMaximal = true;
+
+			for(int i = snapshot.inEdgeBegin(start); i < snapshot.inEdgeEnd(start) && startMaximal; ++i)
+				startMaximal = onPath.at(snapshot.edgeSource(snapshot.inEdge(i)));
+
+			if(!startMaximal)
+			{
+				foreach(int v, first)
+					onPath[v] = false;
+
+				continue;
+			}
 
+			path = first;
+			base.append(0);
+			nextEdge.append(snapshot.edgeBegin(path.last()));
+			nextOption.append(0);
+
+			bool entered = true;
+
+			while(!base.isEmpty())
+			{
+				int end = path.last();
+
+				if(entered)
+				{
+					entered = false;
+
+					if(isOutOfTime())
+					{
+						stopped = true;
+						break;
+					}
+
+					// cycles are in already, so this is never less than without the composition
+					if(budget().maxRequirements > 0 && primes.size() >= budget().maxRequirements)
+					{
+						truncate(ResourceBudget::RequirementLimit);
+						stopped = true;
+						break;
+					}
+
+					bool endMaximal = true;
+
+					for(int e = snapshot.edgeBegin(end); e < snapshot.edgeEnd(end) && endMaximal; ++e)
+						endMaximal = onPath.at(snapshot.edgeTarget(e)) && snapshot.edgeTarget(e) != start;
+
+					if(endMaximal)
+						primes.append(path);
+				}
+
+				if(nextEdge.last() == snapshot.edgeEnd(end))
+				{
+					for(int i = base.last(); i < path.size(); ++i)
+						onPath[path.at(i)] = false;
+
+					path.resize(base.last());
+					base.pop_back();
+					nextEdge.pop_back();
+					nextOption.pop_back();
+					continue;
+				}
+
+				int target = snapshot.edgeTarget(nextEdge.last());
+				const QList<QVector<int> > &options = summaries.pathsFrom(target);
+
+				if(components.component(target) == components.component(end) || nextOption.last() == options.size())
+				{
+					nextEdge.last()++;
+					nextOption.last() = 0;
+					continue;
+				}
+
+				const QVector<int> &next = options.at(nextOption.last()++);
+
+				base.append(path.size());
+				nextEdge.append(snapshot.edgeBegin(next.last()));
+				nextOption.append(0);
+
+				foreach(int v, next)
+					onPath[v] = true;
+
+				path += next;
+				entered = true;
+			}
+
+			// left over when a limit stopped the search
+			foreach(int v, path)
+				onPath[v] = false;
+
+			path.clear();
+			base.clear();
+			nextEdge.clear();
+			nextOption.clear();
+
+			if(stopped)
+				return;
 		}
+	}
+}
 
-		if(prime)
-			addReqResult(new Path(patha));
+void PrimePathsAlgorithm::addExpandedPaths(const ChainReduction &reduction, const QList<Path*> &primes)
+{
+	/* A prime path which is not a cycle never starts or ends inside a
+	   chain, it could be extended to the rest of it. A cycle through a
+	   chain holds all of it and starts at each of its nodes once. The
+	   paths are added in the order the unreduced graph gives them, so
+	   the test paths come out the same too. */
+	int chainCount = reduction.reducedNodes().size();
+
+	QVector<QList<Path*> > byStart(chainCount);
+	QVector<QList<Path*> > cyclesByStart(chainCount);
+
+	foreach(Path *path, primes)
+	{
+		int c = reduction.reducedIndex(path->firstNode());
+		byStart[c].append(path);
+
+		if(path->nodeCount() > 1 && path->firstNode() == path->lastNode())
+			cyclesByStart[c].append(path);
+	}
+
+	for(int v = 0; v < nodes().size(); ++v)
+	{
+		int c = reduction.chainOf(v);
+		int position = reduction.positionInChain(v);
+
+		foreach(Path *path, position == 0 ? byStart.at(c) : cyclesByStart.at(c))
+		{
+			if(isOverSizeBudget())
+				return;
+
+			QList<Node*> expanded = reduction.expand(path->nodes());
+
+			if(position > 0)
+			{
+				expanded.removeLast();
+				expanded = expanded.mid(position) + expanded.mid(0, position);
+				expanded.append(expanded.first());
+			}
+
+			addReqResult(new Path(expanded));
+		}
 	}
 }
+
+bool PrimePathsAlgorithm::enumerate(const QList<Node*> &nodeList, PathStore &store)
+{
+	beginRun(nodeList);
+
+	simplePathsAlgorithm.setBudget(budget());
+	bool ok = simplePathsAlgorithm.enumerate(nodeList, store, true);
+
+	if(simplePathsAlgorithm.isTruncated())
+		truncate(simplePathsAlgorithm.truncation());
+
+	return ok;
+}
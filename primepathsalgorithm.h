@@ -1,15 +1,35 @@
 #ifndef PRIMEPATHSALGORITHM_H
 #define PRIMEPATHSALGORITHM_H
 
+#include <QVector>
+
 #include "abstractalgorithm.h"
 #include "simplepathsalgorithm.h"
 
 namespace Algorithm
 {
+	class ChainReduction;
+	class GraphSnapshot;
+	class StrongComponents;
+	class ComponentPaths;
+
+	/* Prime paths are composed from the simple paths inside every strong
+	   component, see ComponentPaths, on the graph with its straight line
+	   chains collapsed. They come out in the order a depth first search
+	   of the whole graph would find them.
+	*/
 	class PrimePathsAlgorithm : public AbstractAlgorithm
 	{
 		private:
 			SimplePathsAlgorithm simplePathsAlgorithm;
+
+			void composeOpenPaths(const GraphSnapshot &snapshot, const StrongComponents &components,
+					      const ComponentPaths &summaries, QList<QVector<int> > &primes);
+			void addExpandedPaths(const ChainReduction &reduction, const QList<Path*> &primes);
+		public:
+			// prime paths into the store, see SimplePathsAlgorithm::enumerate()
+			bool enumerate(const QList<Node*> &nodes, PathStore &store);
+
 		protected:
 			void onCompute();
 	};
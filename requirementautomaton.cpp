@@ -0,0 +1,172 @@
+#include "requirementautomaton.h"
+
+#include <QSet>
+
+using namespace Algorithm;
+
+RequirementAutomaton::RequirementAutomaton()
+	: m_transitionMask(0), m_transitionShift(0)
+{
+	m_fail.append(0);
+	m_bfsOrder.append(0);
+	m_outputOffsets.fill(0, 2);
+	m_outputLink.append(-1);
+}
+
+void RequirementAutomaton::addTransition(int state, int symbol, int target)
+{
+	quint64 key = ((quint64)state << 32) | (quint32)symbol;
+	quint32 slot = (quint32)((key * Q_UINT64_C(0x9E3779B97F4A7C15)) >> m_transitionShift) & m_transitionMask;
+
+	while(m_transitionKeys[slot] != REQUIREMENT_AUTOMATON_EMPTY_KEY)
+		slot = (slot + 1) & m_transitionMask;
+
+	m_transitionKeys[slot] = key;
+	m_transitionTargets[slot] = target;
+}
+
+void RequirementAutomaton::build(const QList<QVector<int> > &sequences, int symbolCount)
+{
+	int symbolTotal = 0;
+
+	foreach(const QVector<int> &sequence, sequences)
+		symbolTotal += sequence.size();
+
+	// kept at most half full
+	quint32 capacity = 16;
+	m_transitionShift = 60;
+
+	while(capacity < (quint32)symbolTotal * 2)
+	{
+		capacity <<= 1;
+		m_transitionShift--;
+	}
+
+	m_transitionKeys.fill(REQUIREMENT_AUTOMATON_EMPTY_KEY, capacity);
+	m_transitionTargets.fill(-1, capacity);
+	m_transitionMask = capacity - 1;
+
+	m_rootNext.fill(0, symbolCount);
+	m_terminalStates.clear();
+
+	// trie of all the sequences, children are remembered for the walk below
+	QVector<int> firstChild(1, -1);
+	QVector<int> nextSibling(1, -1);
+	QVector<int> stateSymbols(1, -1);
+
+	foreach(const QVector<int> &sequence, sequences)
+	{
+		int state = 0;
+
+		foreach(int symbol, sequence)
+		{
+			int next = (state == 0) ? m_rootNext[symbol] : transition(state, symbol);
+
+			if(next <= 0)
+			{
+				next = firstChild.size();
+
+				firstChild.append(-1);
+				nextSibling.append(firstChild[state]);
+				stateSymbols.append(symbol);
+				firstChild[state] = next;
+
+				if(state == 0)
+					m_rootNext[symbol] = next;
+				else
+					addTransition(state, symbol, next);
+			}
+
+			state = next;
+		}
+
+		m_terminalStates.append(state);
+	}
+
+	int stateCount = firstChild.size();
+
+	m_fail.fill(0, stateCount);
+	m_bfsOrder.clear();
+	m_bfsOrder.reserve(stateCount);
+	m_bfsOrder.append(0);
+
+	for(int i = 0; i < m_bfsOrder.size(); ++i)
+	{
+		int state = m_bfsOrder.at(i);
+
+		for(int child = firstChild[state]; child != -1; child = nextSibling[child])
+		{
+			if(state != 0)
+				m_fail[child] = step(m_fail[state], stateSymbols[child]);
+
+			m_bfsOrder.append(child);
+		}
+	}
+
+	// sequences bucketed by their final state
+	m_outputOffsets.fill(0, stateCount + 1);
+
+	foreach(int state, m_terminalStates)
+		m_outputOffsets[state + 1]++;
+
+	for(int state = 0; state < stateCount; ++state)
+		m_outputOffsets[state + 1] += m_outputOffsets[state];
+
+	m_outputs.resize(m_terminalStates.size());
+	QVector<int> fill(m_outputOffsets);
+
+	for(int i = 0; i < m_terminalStates.size(); ++i)
+		m_outputs[fill[m_terminalStates.at(i)]++] = i;
+
+	m_outputLink.fill(-1, stateCount);
+
+	for(int i = 1; i < m_bfsOrder.size(); ++i)
+	{
+		int state = m_bfsOrder.at(i);
+		int fail = m_fail.at(state);
+
+		if(fail != 0 && m_outputOffsets.at(fail) != m_outputOffsets.at(fail + 1))
+			m_outputLink[state] = fail;
+		else
+			m_outputLink[state] = m_outputLink.at(fail);
+	}
+}
+
+void RequirementAutomaton::propagateVisited(QVector<quint8> &visited) const
+{
+	// going backwards through the BFS order pushes it down the failure chains
+	for(int i = m_bfsOrder.size() - 1; i > 0; --i)
+	{
+		int state = m_bfsOrder.at(i);
+
+		if(visited[state])
+			visited[m_fail[state]] = 1;
+	}
+}
+
+QVector<int> RequirementAutomaton::matches(const QVector<int> &walk) const
+{
+	QVector<int> result;
+	QSet<int> seenStates;
+
+	int state = 0;
+
+	foreach(int symbol, walk)
+	{
+		state = step(state, symbol);
+
+		for(int output = state; output > 0; output = m_outputLink.at(output))
+		{
+			// a state already reported has reported its whole chain too
+			if(seenStates.contains(output))
+				break;
+
+			seenStates.insert(output);
+
+			for(int i = m_outputOffsets.at(output); i < m_outputOffsets.at(output + 1); ++i)
+				result.append(m_outputs.at(i));
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,91 @@
+#ifndef REQUIREMENTAUTOMATON_H
+#define REQUIREMENTAUTOMATON_H
+
+#include <QList>
+#include <QVector>
+
+namespace Algorithm
+{
+	/* Aho-Corasick automaton over requirement sequences of small integer
+	   symbols (0..symbolCount-1). Feeding it a walk through the graph tells
+	   which requirements the walk tours. State 0 is the root, transitions
+	   out of it are kept dense, the others in an open addressing table.
+	*/
+	class RequirementAutomaton
+	{
+		public:
+			RequirementAutomaton();
+
+			void build(const QList<QVector<int> > &sequences, int symbolCount);
+
+			int stateCount() const { return m_fail.size(); }
+			int sequenceCount() const { return m_terminalStates.size(); }
+			int terminalState(int sequence) const { return m_terminalStates.at(sequence); }
+
+			inline int step(int state, int symbol) const;
+
+			// whether a walk reaching the state has just toured some sequence
+			bool hasMatch(int state) const
+			{ return m_outputOffsets.at(state) != m_outputOffsets.at(state + 1) || m_outputLink.at(state) != -1; }
+
+			// marks every state toured through the failure links of the visited ones
+			void propagateVisited(QVector<quint8> &visited) const;
+
+			// indexes of the sequences toured by the walk, each one once
+			QVector<int> matches(const QVector<int> &walk) const;
+
+		private:
+			QVector<int> m_rootNext;
+			QVector<quint64> m_transitionKeys;
+			QVector<int> m_transitionTargets;
+			quint32 m_transitionMask;
+			int m_transitionShift;
+
+			QVector<int> m_fail;
+			QVector<int> m_bfsOrder;
+			QVector<int> m_terminalStates;
+
+			// sequences ending in a state and the nearest state on the failure chain which has some
+			QVector<int> m_outputOffsets;
+			QVector<int> m_outputs;
+			QVector<int> m_outputLink;
+
+			inline int transition(int state, int symbol) const;
+			void addTransition(int state, int symbol, int target);
+	};
+
+	#define REQUIREMENT_AUTOMATON_EMPTY_KEY (~(quint64)0)
+
+	inline int RequirementAutomaton::transition(int state, int symbol) const
+	{
+		quint64 key = ((quint64)state << 32) | (quint32)symbol;
+		quint32 slot = (quint32)((key * Q_UINT64_C(0x9E3779B97F4A7C15)) >> m_transitionShift) & m_transitionMask;
+
+		while(m_transitionKeys[slot] != REQUIREMENT_AUTOMATON_EMPTY_KEY)
+		{
+			if(m_transitionKeys[slot] == key)
+				return m_transitionTargets[slot];
+
+			slot = (slot + 1) & m_transitionMask;
+		}
+
+		return -1;
+	}
+
+	inline int RequirementAutomaton::step(int state, int symbol) const
+	{
+		while(state != 0)
+		{
+			int next = transition(state, symbol);
+
+			if(next != -1)
+				return next;
+
+			state = m_fail[state];
+		}
+
+		return m_rootNext[symbol];
+	}
+}
+
+#endif // REQUIREMENTAUTOMATON_H
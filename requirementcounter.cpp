@@ -0,0 +1,307 @@
+#include "requirementcounter.h"
+
+#include <QtAlgorithms>
+
+using namespace Algorithm;
+
+#define COUNT_MAX Q_UINT64_C(0xFFFFFFFFFFFFFFFF)
+
+RequirementCounter::RequirementCounter(const QList<Node*> &nodes)
+	: m_snapshot(nodes), m_edgePairs(0), m_simplePaths(0), m_primePaths(0),
+	  m_upperBound(0), m_overflow(false), m_timeBudget(0), m_steps(0), m_timedOut(false)
+{
+}
+
+quint64 RequirementCounter::add(quint64 a, quint64 b)
+{
+	if(a > COUNT_MAX - b)
+	{
+		m_overflow = true;
+		return COUNT_MAX;
+	}
+
+	return a + b;
+}
+
+quint64 RequirementCounter::mul(quint64 a, quint64 b)
+{
+	if(a != 0 && b > COUNT_MAX / a)
+	{
+		m_overflow = true;
+		return COUNT_MAX;
+	}
+
+	return a * b;
+}
+
+bool RequirementCounter::isOutOfTime()
+{
+	// the clock is only read once in a while
+	if((++m_steps & 0xFFF) == 0 && m_timer.elapsed() > m_timeBudget)
+		m_timedOut = true;
+
+	return m_timedOut;
+}
+
+void RequirementCounter::count(int timeBudget)
+{
+	m_edgePairs = m_simplePaths = m_primePaths = m_upperBound = 0;
+	m_overflow = false;
+	m_timedOut = false;
+	m_steps = 0;
+	m_timeBudget = timeBudget;
+	m_timer.start();
+
+	countEdgePairs();
+
+	if(m_snapshot.nodeCount() <= SubsetLimit)
+		countBySubsets();
+	else
+		countByComponents();
+
+	if(m_timedOut)
+		computeUpperBound();
+	else
+		m_upperBound = qMax(m_simplePaths, m_primePaths);
+}
+
+void RequirementCounter::countEdgePairs()
+{
+	// every edge coming into a node pairs with every edge going out
+	for(int v = 0; v < m_snapshot.nodeCount(); ++v)
+		m_edgePairs = add(m_edgePairs, mul(m_snapshot.inDegree(v), m_snapshot.outDegree(v)));
+}
+
+void RequirementCounter::countBySubsets()
+{
+	int n = m_snapshot.nodeCount();
+
+	if(n == 0)
+		return;
+
+	QVector<quint32> inMask(n, 0);
+	QVector<quint32> outMask(n, 0);
+
+	// edges from a node back to the start, which close a cycle
+	QVector<int> edgesTo(n * n, 0);
+
+	for(int e = 0; e < m_snapshot.edgeCount(); ++e)
+	{
+		int from = m_snapshot.edgeSource(e);
+		int to = m_snapshot.edgeTarget(e);
+
+		outMask[from] |= 1 << to;
+		inMask[to] |= 1 << from;
+		edgesTo[from * n + to]++;
+	}
+
+	/* paths[mask * n + u] is the number of paths from the start through
+	   the nodes of mask ending in u */
+	int maskCount = 1 << n;
+	QVector<quint64> paths(maskCount * n);
+
+	for(int start = 0; start < n; ++start)
+	{
+		paths.fill(0);
+		paths[(1 << start) * n + start] = 1;
+
+		quint32 startBit = 1 << start;
+
+		for(int mask = startBit; mask < maskCount; ++mask)
+		{
+			if(!(mask & startBit))
+				continue;
+
+			if(isOutOfTime())
+				return;
+
+			bool startMaximal = (inMask.at(start) & ~mask) == 0;
+
+			for(int u = 0; u < n; ++u)
+			{
+				quint64 count = paths.at(mask * n + u);
+
+				if(count == 0)
+					continue;
+
+				int closing = edgesTo.at(u * n + start);
+				bool endMaximal = (outMask.at(u) & ~mask) == 0;
+
+				m_simplePaths = add(m_simplePaths, count);
+
+				// a cycle can't be a part of any other simple path
+				if(closing != 0)
+				{
+					m_simplePaths = add(m_simplePaths, mul(count, closing));
+					m_primePaths = add(m_primePaths, mul(count, closing));
+				}
+				else if(startMaximal && endMaximal)
+				{
+					m_primePaths = add(m_primePaths, count);
+				}
+
+				for(int e = m_snapshot.edgeBegin(u); e < m_snapshot.edgeEnd(u); ++e)
+				{
+					int t = m_snapshot.edgeTarget(e);
+
+					if(mask & (1 << t))
+						continue;
+
+					quint64 &next = paths[(mask | (1 << t)) * n + t];
+					next = add(next, count);
+				}
+			}
+		}
+	}
+}
+
+void RequirementCounter::countByComponents()
+{
+	int n = m_snapshot.nodeCount();
+
+	StrongComponents components(m_snapshot);
+
+	/* For a path which enters the component of a node in it:
+	   open - all the paths continuing from the node,
+	   closed - those of them which can't be extended at their end. */
+	QVector<quint64> open(n, 0);
+	QVector<quint64> closed(n, 0);
+
+	QVector<bool> onPath(n, false);
+	QVector<int> edgesToStart(n, 0);
+	QVector<int> path;
+	QVector<int> nextEdge;
+
+	// sinks come first, so the nodes outside are always counted already
+	for(int c = 0; c < components.componentCount(); ++c)
+	{
+		for(int i = components.memberBegin(c); i < components.memberEnd(c); ++i)
+		{
+			int start = components.member(i);
+
+			for(int k = m_snapshot.inEdgeBegin(start); k < m_snapshot.inEdgeEnd(start); ++k)
+				edgesToStart[m_snapshot.edgeSource(m_snapshot.inEdge(k))]++;
+
+			// all the edges into the start come from the nodes on the path
+			int startInDegree = m_snapshot.inDegree(start);
+			int startInOnPath = 0;
+
+			quint64 startOpen = 0, startClosed = 0, cycles = 0, primeOpen = 0;
+
+			path.append(start);
+			nextEdge.append(m_snapshot.edgeBegin(start));
+			onPath[start] = true;
+			startInOnPath += edgesToStart.at(start);
+
+			bool entered = true;
+
+			while(!path.isEmpty())
+			{
+				int u = path.last();
+
+				if(entered)
+				{
+					entered = false;
+
+					if(isOutOfTime())
+						break;
+
+					bool endMaximal = true;
+
+					for(int e = m_snapshot.edgeBegin(u); e < m_snapshot.edgeEnd(u) && endMaximal; ++e)
+						endMaximal = onPath.at(m_snapshot.edgeTarget(e));
+
+					int closing = edgesToStart.at(u);
+
+					startOpen = add(startOpen, 1);
+					cycles = add(cycles, closing);
+
+					if(endMaximal)
+						startClosed = add(startClosed, 1);
+
+					if(endMaximal && closing == 0 && startInOnPath == startInDegree)
+						primeOpen = add(primeOpen, 1);
+				}
+
+				if(nextEdge.last() == m_snapshot.edgeEnd(u))
+				{
+					onPath[u] = false;
+					startInOnPath -= edgesToStart.at(u);
+					path.pop_back();
+					nextEdge.pop_back();
+					continue;
+				}
+
+				int t = m_snapshot.edgeTarget(nextEdge.last()++);
+
+				if(components.component(t) != c)
+				{
+					startOpen = add(startOpen, open.at(t));
+					startClosed = add(startClosed, closed.at(t));
+
+					if(startInOnPath == startInDegree)
+						primeOpen = add(primeOpen, closed.at(t));
+
+					continue;
+				}
+
+				if(onPath.at(t))
+					continue;
+
+				onPath[t] = true;
+				startInOnPath += edgesToStart.at(t);
+				path.append(t);
+				nextEdge.append(m_snapshot.edgeBegin(t));
+				entered = true;
+			}
+
+			// left over when the time ran out
+			foreach(int v, path)
+				onPath[v] = false;
+
+			path.clear();
+			nextEdge.clear();
+
+			for(int k = m_snapshot.inEdgeBegin(start); k < m_snapshot.inEdgeEnd(start); ++k)
+				edgesToStart[m_snapshot.edgeSource(m_snapshot.inEdge(k))] = 0;
+
+			open[start] = startOpen;
+			closed[start] = startClosed;
+
+			m_simplePaths = add(m_simplePaths, add(startOpen, cycles));
+			m_primePaths = add(m_primePaths, add(primeOpen, cycles));
+
+			if(m_timedOut)
+				return;
+		}
+	}
+}
+
+void RequirementCounter::computeUpperBound()
+{
+	/* A path with k edges from any node goes through k different nodes,
+	   so there are no more of them than the product of the k largest
+	   out degrees. */
+	int n = m_snapshot.nodeCount();
+	QVector<int> degrees(n);
+
+	// a saturated bound says nothing about the counts
+	bool overflow = m_overflow;
+
+	for(int v = 0; v < n; ++v)
+		degrees[v] = m_snapshot.outDegree(v);
+
+	qSort(degrees.begin(), degrees.end(), qGreater<int>());
+
+	quint64 fromOneNode = 1;
+	quint64 product = 1;
+
+	for(int k = 0; k < n && product != 0 && product != COUNT_MAX; ++k)
+	{
+		product = mul(product, degrees.at(k));
+		fromOneNode = add(fromOneNode, product);
+	}
+
+	m_upperBound = qMax(mul(fromOneNode, n), qMax(m_simplePaths, m_primePaths));
+	m_overflow = overflow;
+}
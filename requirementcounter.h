@@ -0,0 +1,74 @@
+#ifndef REQUIREMENTCOUNTER_H
+#define REQUIREMENTCOUNTER_H
+
+#include <QList>
+#include <QVector>
+#include <QTime>
+
+#include "algorithmnode.h"
+#include "graphsnapshot.h"
+#include "strongcomponents.h"
+
+namespace Algorithm
+{
+	/* Counts the requirements of the edge pair, simple paths and prime
+	   paths criteria without building them, so the size of a run is known
+	   before it starts. The counts are the numbers of paths the algorithms
+	   would produce.
+
+	   Small graphs are counted by dynamic programming over node subsets.
+	   Larger ones by depth first search inside the strongly connected
+	   components, what can be done after the search leaves a component
+	   doesn't depend on the way there and is counted once per node.
+
+	   When the time budget runs out the counts are only the paths found
+	   so far and upperBound() is a bound of both path counts derived from
+	   the out degrees. Counts saturate at 2^64-1.
+	*/
+	class RequirementCounter
+	{
+		public:
+			RequirementCounter(const QList<Node*> &nodes);
+
+			void count(int timeBudget = DefaultTimeBudget);
+
+			quint64 edgePairCount() const { return m_edgePairs; }
+			quint64 simplePathCount() const { return m_simplePaths; }
+			quint64 primePathCount() const { return m_primePaths; }
+
+			bool isExact() const { return !m_timedOut; }
+			quint64 upperBound() const { return m_upperBound; }
+			bool hasOverflowed() const { return m_overflow; }
+
+			// milliseconds
+			static const int DefaultTimeBudget = 2000;
+
+			// largest graph counted over node subsets
+			static const int SubsetLimit = 16;
+
+		private:
+			GraphSnapshot m_snapshot;
+
+			quint64 m_edgePairs;
+			quint64 m_simplePaths;
+			quint64 m_primePaths;
+			quint64 m_upperBound;
+			bool m_overflow;
+
+			QTime m_timer;
+			int m_timeBudget;
+			int m_steps;
+			bool m_timedOut;
+
+			quint64 add(quint64 a, quint64 b);
+			quint64 mul(quint64 a, quint64 b);
+			bool isOutOfTime();
+
+			void countEdgePairs();
+			void countBySubsets();
+			void countByComponents();
+			void computeUpperBound();
+	};
+}
+
+#endif // REQUIREMENTCOUNTER_H
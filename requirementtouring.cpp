@@ -0,0 +1,25 @@
+#include "requirementtouring.h"
+
+using namespace Algorithm;
+
+RequirementTouring::RequirementTouring(const QList<QVector<int> > &sequences, int symbolCount, TouringMode mode)
+	: m_mode(mode)
+{
+	if(mode == DirectTouring)
+	{
+		m_automaton.build(sequences, symbolCount);
+	}
+	else
+	{
+		m_matcher.build(sequences, mode);
+		m_matcher.initProgress(m_progress);
+	}
+}
+
+QVector<int> RequirementTouring::matches(const QVector<int> &walk)
+{
+	if(m_mode == DirectTouring)
+		return m_automaton.matches(walk);
+
+	return m_matcher.matches(m_progress, walk);
+}
@@ -0,0 +1,31 @@
+#ifndef REQUIREMENTTOURING_H
+#define REQUIREMENTTOURING_H
+
+#include <QList>
+#include <QVector>
+
+#include "requirementautomaton.h"
+#include "subsequenceautomaton.h"
+
+namespace Algorithm
+{
+	/* The requirements a walk tours in a touring mode, the automaton for
+	   direct touring and the matcher for the others. Walks are checked one
+	   at a time and independently of each other. */
+	class RequirementTouring
+	{
+		public:
+			RequirementTouring(const QList<QVector<int> > &sequences, int symbolCount, TouringMode mode);
+
+			// indexes of the sequences toured by the walk, each one once
+			QVector<int> matches(const QVector<int> &walk);
+
+		private:
+			TouringMode m_mode;
+			RequirementAutomaton m_automaton;
+			SubsequenceMatcher m_matcher;
+			SubsequenceMatcher::Progress m_progress;
+	};
+}
+
+#endif // REQUIREMENTTOURING_H
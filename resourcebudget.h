@@ -0,0 +1,44 @@
+#ifndef RESOURCEBUDGET_H
+#define RESOURCEBUDGET_H
+
+#include <QString>
+#include <QObject>
+
+namespace Algorithm
+{
+	/* Limits of a single algorithm run, zero means no limit. The memory
+	   is an estimate of what the requirements take, not a measurement. */
+	class ResourceBudget
+	{
+		public:
+			enum Limit { NoLimit, RequirementLimit, MemoryLimit, TimeLimit };
+
+			ResourceBudget() : maxRequirements(0), maxBytes(0), timeLimit(0) {}
+
+			int maxRequirements;
+			qint64 maxBytes;
+			// milliseconds
+			int timeLimit;
+
+			static QString limitText(Limit limit)
+			{
+				switch(limit)
+				{
+					case RequirementLimit:
+						return QObject::tr("requirement count limit");
+
+					case MemoryLimit:
+						return QObject::tr("memory limit");
+
+					case TimeLimit:
+						return QObject::tr("time limit");
+
+					default: ;
+				}
+
+				return QString();
+			}
+	};
+}
+
+#endif // RESOURCEBUDGET_H
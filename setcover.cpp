@@ -0,0 +1,327 @@
+#include "setcover.h"
+
+#include <QtAlgorithms>
+#include <QPair>
+
+#include <queue>
+#include <utility>
+
+using namespace Algorithm;
+
+// a free set still has to be ranked by its gain
+#define MIN_COST 1e-9
+
+SetCover::SetCover(int elementCount)
+	: m_elementCount(elementCount), m_wordCount((elementCount + 63) / 64),
+	  m_weighted(false), m_lowerBound(0), m_optimal(false)
+{
+}
+
+void SetCover::addSet(const QVector<int> &elements, double cost)
+{
+	m_sets.append(elements);
+	m_costs.append(qMax(cost, 0.0));
+
+	if(cost != 1.0)
+		m_weighted = true;
+}
+
+double SetCover::selectedCost() const
+{
+	double cost = 0;
+
+	foreach(int index, m_selected)
+		cost += m_costs.at(index);
+
+	return cost;
+}
+
+int SetCover::popCount(quint64 word)
+{
+	int count = 0;
+
+	while(word != 0)
+	{
+		word &= word - 1;
+		count++;
+	}
+
+	return count;
+}
+
+void SetCover::solve()
+{
+	m_selected.clear();
+	m_optimal = false;
+
+	computeLowerBound();
+
+	if(m_sets.size() <= ExactLimit)
+	{
+		solveExact();
+		return;
+	}
+
+	lazyGreedy();
+	removeRedundant();
+}
+
+void SetCover::lazyGreedy()
+{
+	QVector<quint64> covered(m_wordCount, 0);
+
+	// (gain per cost, -index), so that equal gains keep the original order
+	std::priority_queue<std::pair<double, int> > queue;
+
+	for(int i = 0; i < m_sets.size(); ++i)
+		if(!m_sets.at(i).isEmpty())
+			queue.push(std::make_pair(m_sets.at(i).size() / qMax(m_costs.at(i), MIN_COST), -i));
+
+	while(!queue.empty())
+	{
+		int index = -queue.top().second;
+		queue.pop();
+
+		int gain = 0;
+
+		foreach(int element, m_sets.at(index))
+			if(!testBit(covered, element))
+				gain++;
+
+		if(gain == 0)
+			continue;
+
+		double ratio = gain / qMax(m_costs.at(index), MIN_COST);
+
+		if(!queue.empty() && ratio < queue.top().first)
+		{
+			queue.push(std::make_pair(ratio, -index));
+			continue;
+		}
+
+		foreach(int element, m_sets.at(index))
+			setBit(covered, element);
+
+		m_selected.append(index);
+	}
+}
+
+void SetCover::removeRedundant()
+{
+	QVector<int> multiplicity(m_elementCount, 0);
+
+	foreach(int index, m_selected)
+		foreach(int element, m_sets.at(index))
+			multiplicity[element]++;
+
+	// the sets picked last contributed least, with costs the dearest go first
+	QList<QPair<double, int> > order;
+
+	for(int i = m_selected.size() - 1; i >= 0; --i)
+		order.append(qMakePair(m_weighted ? -m_costs.at(m_selected.at(i)) : 0.0, i));
+
+	qStableSort(order);
+
+	QVector<bool> removed(m_selected.size(), false);
+
+	for(int k = 0; k < order.size(); ++k)
+	{
+		int i = order.at(k).second;
+		const QVector<int> &set = m_sets.at(m_selected.at(i));
+		bool redundant = true;
+
+		foreach(int element, set)
+		{
+			if(multiplicity.at(element) < 2)
+			{
+				redundant = false;
+				break;
+			}
+		}
+
+		if(!redundant)
+			continue;
+
+		foreach(int element, set)
+			multiplicity[element]--;
+
+		removed[i] = true;
+	}
+
+	for(int i = m_selected.size() - 1; i >= 0; --i)
+		if(removed.at(i))
+			m_selected.removeAt(i);
+}
+
+void SetCover::computeLowerBound()
+{
+	QVector<int> owner(m_elementCount, -1);
+	QVector<int> ownerCount(m_elementCount, 0);
+
+	for(int i = 0; i < m_sets.size(); ++i)
+	{
+		foreach(int element, m_sets.at(i))
+		{
+			owner[element] = i;
+			ownerCount[element]++;
+		}
+	}
+
+	QVector<bool> essential(m_sets.size(), false);
+	int essentialCount = 0;
+
+	for(int element = 0; element < m_elementCount; ++element)
+	{
+		if(ownerCount.at(element) == 1 && !essential.at(owner.at(element)))
+		{
+			essential[owner.at(element)] = true;
+			essentialCount++;
+		}
+	}
+
+	/* Elements covered by the fewest sets are packed first, each one
+	   rules out every set it is in. */
+	QVector<QList<int> > byCount(m_sets.size() + 1);
+
+	for(int element = 0; element < m_elementCount; ++element)
+		if(ownerCount.at(element) > 0)
+			byCount[ownerCount.at(element)].append(element);
+
+	QVector<QList<int> > setsOfElement(m_elementCount);
+
+	for(int i = 0; i < m_sets.size(); ++i)
+		foreach(int element, m_sets.at(i))
+			setsOfElement[element].append(i);
+
+	QVector<bool> used(m_sets.size(), false);
+	int packed = 0;
+
+	for(int count = 1; count < byCount.size(); ++count)
+	{
+		foreach(int element, byCount.at(count))
+		{
+			bool free = true;
+
+			foreach(int set, setsOfElement.at(element))
+			{
+				if(used.at(set))
+				{
+					free = false;
+					break;
+				}
+			}
+
+			if(!free)
+				continue;
+
+			foreach(int set, setsOfElement.at(element))
+				used[set] = true;
+
+			packed++;
+		}
+	}
+
+	m_lowerBound = qMax(essentialCount, packed);
+}
+
+void SetCover::solveExact()
+{
+	QVector<QVector<quint64> > setBits;
+	QVector<quint64> universe(m_wordCount, 0);
+
+	foreach(const QVector<int> &set, m_sets)
+	{
+		QVector<quint64> bits(m_wordCount, 0);
+
+		foreach(int element, set)
+		{
+			setBit(bits, element);
+			setBit(universe, element);
+		}
+
+		setBits.append(bits);
+	}
+
+	// greedy gives the bound to beat
+	lazyGreedy();
+	removeRedundant();
+
+	QList<int> best = m_selected;
+	double bestCost = selectedCost();
+	QList<int> chosen;
+	QVector<quint64> covered(m_wordCount, 0);
+
+	if(m_weighted || best.size() > m_lowerBound)
+		branch(setBits, universe, covered, chosen, 0, best, bestCost);
+
+	m_selected = best;
+	m_optimal = true;
+}
+
+void SetCover::branch(const QVector<QVector<quint64> > &setBits, const QVector<quint64> &universe,
+		      QVector<quint64> &covered, QList<int> &chosen, double chosenCost,
+		      QList<int> &best, double &bestCost)
+{
+	if(!m_weighted && chosen.size() + 1 >= best.size())
+		return;
+
+	int uncovered = -1;
+
+	for(int w = 0; w < m_wordCount && uncovered == -1; ++w)
+	{
+		quint64 missing = universe.at(w) & ~covered.at(w);
+
+		if(missing != 0)
+			uncovered = w * 64 + popCount((missing & (0 - missing)) - 1);
+	}
+
+	if(uncovered == -1)
+		return;
+
+	// every cover contains one of the sets with the first uncovered element
+	for(int i = 0; i < setBits.size(); ++i)
+	{
+		if(!testBit(setBits.at(i), uncovered))
+			continue;
+
+		// without costs the check above already bounds the count
+		double cost = chosenCost + m_costs.at(i);
+
+		if(m_weighted && cost >= bestCost)
+			continue;
+
+		QVector<quint64> saved(covered);
+
+		for(int w = 0; w < m_wordCount; ++w)
+			covered[w] |= setBits.at(i).at(w);
+
+		chosen.append(i);
+
+		bool complete = true;
+
+		for(int w = 0; w < m_wordCount; ++w)
+		{
+			if((universe.at(w) & ~covered.at(w)) != 0)
+			{
+				complete = false;
+				break;
+			}
+		}
+
+		if(complete)
+		{
+			best = chosen;
+			bestCost = cost;
+		}
+		else
+		{
+			branch(setBits, universe, covered, chosen, cost, best, bestCost);
+		}
+
+		chosen.removeLast();
+		covered = saved;
+
+		if(!m_weighted && best.size() == m_lowerBound)
+			return;
+	}
+}
@@ -0,0 +1,71 @@
+#ifndef SETCOVER_H
+#define SETCOVER_H
+
+#include <QVector>
+#include <QList>
+
+namespace Algorithm
+{
+	/* Picks a small subfamily of sets covering everything the whole family
+	   covers. Few sets are solved exactly by branch and bound over bitsets,
+	   otherwise lazy greedy (CELF) is used: gains only ever shrink, so a set
+	   popped from the queue with an up to date gain is the best one. Sets
+	   which turn out redundant afterwards are dropped.
+
+	   lowerBound() is the larger of the essential sets (the only ones
+	   covering some element) and a packing of elements no two of which
+	   share a set.
+
+	   Sets given a cost are picked by gain per cost and the cover of the
+	   lowest total cost is searched for, the bound still counts sets.
+	*/
+	class SetCover
+	{
+		public:
+			SetCover(int elementCount);
+
+			// elements must be in 0..elementCount-1
+			void addSet(const QVector<int> &elements, double cost = 1.0);
+
+			void solve();
+
+			int setCount() const { return m_sets.size(); }
+			const QList<int> &selected() const { return m_selected; }
+			int lowerBound() const { return m_lowerBound; }
+			bool isOptimal() const { return m_optimal || (!m_weighted && m_selected.size() == m_lowerBound); }
+
+			double selectedCost() const;
+
+		private:
+			int m_elementCount;
+			int m_wordCount;
+			QVector<QVector<int> > m_sets;
+			QVector<double> m_costs;
+			bool m_weighted;
+
+			QList<int> m_selected;
+			int m_lowerBound;
+			bool m_optimal;
+
+			static const int ExactLimit = 24;
+
+			static inline bool testBit(const QVector<quint64> &bits, int i)
+			{ return (bits[i >> 6] >> (i & 63)) & 1; }
+
+			static inline void setBit(QVector<quint64> &bits, int i)
+			{ bits[i >> 6] |= (quint64)1 << (i & 63); }
+
+			static int popCount(quint64 word);
+
+			void lazyGreedy();
+			void removeRedundant();
+			void computeLowerBound();
+
+			void solveExact();
+			void branch(const QVector<QVector<quint64> > &setBits, const QVector<quint64> &universe,
+				    QVector<quint64> &covered, QList<int> &chosen, double chosenCost,
+				    QList<int> &best, double &bestCost);
+	};
+}
+
+#endif // SETCOVER_H
@@ -0,0 +1,129 @@
+#include "shortesttestpaths.h"
+
+#include <QHash>
+#include <QByteArray>
+#include <QFuture>
+#include <QtConcurrentRun>
+
+using namespace Algorithm;
+
+ShortestTestPaths::ShortestTestPaths(const GraphSnapshot &snapshot)
+	: m_snapshot(snapshot)
+{
+	buildTree(m_towardsStart, false);
+	buildTree(m_towardsEnd, true);
+}
+
+void ShortestTestPaths::buildTree(QVector<int> &parent, bool reverse)
+{
+	int nodeCount = m_snapshot.nodeCount();
+
+	parent.fill(Unreached, nodeCount);
+
+	QVector<int> queue;
+
+	for(int v = 0; v < nodeCount; ++v)
+	{
+		if(reverse ? m_snapshot.isEnd(v) : m_snapshot.isStart(v))
+		{
+			parent[v] = Root;
+			queue.append(v);
+		}
+	}
+
+	for(int i = 0; i < queue.size(); ++i)
+	{
+		int v = queue.at(i);
+		int begin = reverse ? m_snapshot.inEdgeBegin(v) : m_snapshot.edgeBegin(v);
+		int end = reverse ? m_snapshot.inEdgeEnd(v) : m_snapshot.edgeEnd(v);
+
+		for(int k = begin; k < end; ++k)
+		{
+			int next = reverse ? m_snapshot.edgeSource(m_snapshot.inEdge(k)) : m_snapshot.edgeTarget(k);
+
+			if(parent.at(next) != Unreached)
+				continue;
+
+			parent[next] = v;
+			queue.append(next);
+		}
+	}
+}
+
+QList<QVector<int> > ShortestTestPaths::extend(const QList<QVector<int> > &requirements, int begin, int end) const
+{
+	QList<QVector<int> > result;
+
+	for(int r = begin; r < end; ++r)
+	{
+		const QVector<int> &requirement = requirements.at(r);
+
+		if(requirement.isEmpty() || m_towardsStart.at(requirement.first()) == Unreached
+		   || m_towardsEnd.at(requirement.last()) == Unreached)
+		{
+			result.append(QVector<int>());
+			continue;
+		}
+
+		QVector<int> path;
+
+		// the tree leads back to a start node, so the prefix comes reversed
+		for(int v = m_towardsStart.at(requirement.first()); v != Root; v = m_towardsStart.at(v))
+			path.append(v);
+
+		for(int i = 0; i < path.size() / 2; ++i)
+			qSwap(path[i], path[path.size() - 1 - i]);
+
+		path += requirement;
+
+		for(int v = m_towardsEnd.at(requirement.last()); v != Root; v = m_towardsEnd.at(v))
+			path.append(v);
+
+		result.append(path);
+	}
+
+	return result;
+}
+
+void ShortestTestPaths::build(const QList<QVector<int> > &requirements)
+{
+	m_testPaths.clear();
+	m_pathOf.fill(-1, requirements.size());
+
+	QList<QFuture<QList<QVector<int> > > > futures;
+
+	for(int begin = 0; begin < requirements.size(); begin += ChunkSize)
+	{
+		int end = qMin(begin + (int)ChunkSize, requirements.size());
+		futures.append(QtConcurrent::run(this, &ShortestTestPaths::extend, requirements, begin, end));
+	}
+
+	// the same test path can serve several requirements
+	QHash<QByteArray, int> indexes;
+	int r = 0;
+
+	for(int i = 0; i < futures.size(); ++i)
+	{
+		foreach(const QVector<int> &path, futures[i].result())
+		{
+			if(!path.isEmpty())
+			{
+				QByteArray key((const char*)path.constData(), path.size() * sizeof(int));
+				QHash<QByteArray, int>::const_iterator it = indexes.constFind(key);
+
+				if(it != indexes.constEnd())
+				{
+					m_pathOf[r] = it.value();
+				}
+				else
+				{
+					m_pathOf[r] = m_testPaths.size();
+					indexes.insert(key, m_testPaths.size());
+					m_testPaths.append(path);
+				}
+			}
+
+			r++;
+		}
+	}
+}
@@ -0,0 +1,52 @@
+#ifndef SHORTESTTESTPATHS_H
+#define SHORTESTTESTPATHS_H
+
+#include <QList>
+#include <QVector>
+
+#include "graphsnapshot.h"
+
+namespace Algorithm
+{
+	/* One test path per requirement instead of merged ones: the fewest
+	   edges from a start node to its first node, the requirement, and the
+	   fewest edges on to an end node. Both come from a breadth first tree
+	   built once, from all the start nodes and back from all the end
+	   nodes, so requirements are extended in parallel chunks. Requirements
+	   giving the same test path share it.
+	*/
+	class ShortestTestPaths
+	{
+		public:
+			ShortestTestPaths(const GraphSnapshot &snapshot);
+
+			// requirements as node indexes
+			void build(const QList<QVector<int> > &requirements);
+
+			// in the order of the first requirement each one is for
+			const QList<QVector<int> > &testPaths() const { return m_testPaths; }
+
+			// index into testPaths() for every requirement, -1 when no start or end node is reached
+			const QVector<int> &pathOf() const { return m_pathOf; }
+
+			// requirements extended by one task
+			static const int ChunkSize = 1024;
+
+		private:
+			const GraphSnapshot &m_snapshot;
+
+			// next node towards a start or an end node, Root there, Unreached when there is none
+			QVector<int> m_towardsStart;
+			QVector<int> m_towardsEnd;
+
+			QList<QVector<int> > m_testPaths;
+			QVector<int> m_pathOf;
+
+			enum { Root = -1, Unreached = -2 };
+
+			void buildTree(QVector<int> &parent, bool reverse);
+			QList<QVector<int> > extend(const QList<QVector<int> > &requirements, int begin, int end) const;
+	};
+}
+
+#endif // SHORTESTTESTPATHS_H
@@ -0,0 +1,207 @@
+#include "simplecycles.h"
+
+#include <QFuture>
+#include <QtConcurrentRun>
+
+using namespace Algorithm;
+
+SimpleCycles::SimpleCycles(const GraphSnapshot &snapshot, const StrongComponents &components)
+	: m_snapshot(snapshot), m_components(components), m_everyNode(false), m_timeLimit(0), m_maxNodes(0),
+	  m_storedNodes(0), m_stop(ResourceBudget::NoLimit), m_truncation(ResourceBudget::NoLimit)
+{
+	m_positions.resize(snapshot.nodeCount());
+
+	for(int c = 0; c < components.componentCount(); ++c)
+		for(int i = components.memberBegin(c); i < components.memberEnd(c); ++i)
+			m_positions[components.member(i)] = i - components.memberBegin(c);
+}
+
+QVector<int> SimpleCycles::rotated(const QVector<int> &cycle, int position)
+{
+	QVector<int> result;
+	int length = cycle.size() - 1;
+
+	for(int i = 0; i <= length; ++i)
+		result.append(cycle.at((position + i) % length));
+
+	return result;
+}
+
+void SimpleCycles::compute(const ResourceBudget &budget, int elapsed, bool everyNode)
+{
+	m_cycles.clear();
+	m_everyNode = everyNode;
+
+	// a time limit already used up still has to stop the searches
+	m_timeLimit = budget.timeLimit > 0 ? qMax(budget.timeLimit - elapsed, 1) : 0;
+	m_maxNodes = budget.maxBytes > 0 ? (int)qMin(budget.maxBytes / (qint64)sizeof(int), (qint64)0x7FFFFFFF) : 0;
+	m_storedNodes = 0;
+	m_stop = ResourceBudget::NoLimit;
+	m_timer.start();
+
+	QList<QFuture<QList<QVector<int> > > > futures;
+
+	for(int c = 0; c < m_components.componentCount(); ++c)
+		if(m_components.isCyclic(c))
+			futures.append(QtConcurrent::run(this, &SimpleCycles::searchComponent, c));
+
+	for(int i = 0; i < futures.size(); ++i)
+		m_cycles += futures[i].result();
+
+	m_truncation = (ResourceBudget::Limit)(int)m_stop;
+}
+
+bool SimpleCycles::shouldStop(int &pendingNodes)
+{
+	if(m_stop != ResourceBudget::NoLimit)
+		return true;
+
+	// the shared counter is only touched once in a while
+	if(pendingNodes < 4096)
+		return false;
+
+	int stored = m_storedNodes.fetchAndAddRelaxed(pendingNodes) + pendingNodes;
+	pendingNodes = 0;
+
+	if(m_maxNodes > 0 && stored >= m_maxNodes)
+		m_stop.testAndSetRelaxed(ResourceBudget::NoLimit, ResourceBudget::MemoryLimit);
+	else if(m_timeLimit > 0 && m_timer.elapsed() > m_timeLimit)
+		m_stop.testAndSetRelaxed(ResourceBudget::NoLimit, ResourceBudget::TimeLimit);
+
+	return m_stop != ResourceBudget::NoLimit;
+}
+
+QList<QVector<int> > SimpleCycles::searchComponent(int c)
+{
+	QList<QVector<int> > cycles;
+
+	int size = m_components.size(c);
+	int pendingNodes = 0;
+
+	// by position in the component
+	QVector<bool> blocked(size);
+	QVector<QList<int> > blockedSets(size);
+	QVector<bool> onCycle(size, false);
+	int uncovered = size;
+
+	QVector<int> path;
+	QVector<int> nextEdge;
+	QVector<bool> found;
+	QVector<int> unblocked;
+
+	// cycles through first are found from it, the later searches leave it out
+	for(int first = 0; first < size && !(m_everyNode && uncovered == 0); ++first)
+	{
+		if(shouldStop(pendingNodes))
+			break;
+
+		int start = m_components.member(m_components.memberBegin(c) + first);
+
+		blocked.fill(false);
+
+		for(int i = first; i < size; ++i)
+			blockedSets[i].clear();
+
+		path.append(start);
+		nextEdge.append(m_snapshot.edgeBegin(start));
+		found.append(false);
+		blocked[first] = true;
+
+		while(!path.isEmpty())
+		{
+			int v = path.last();
+
+			if(nextEdge.last() < m_snapshot.edgeEnd(v) && !shouldStop(pendingNodes)
+			   && !(m_everyNode && uncovered == 0))
+			{
+				int w = m_snapshot.edgeTarget(nextEdge.last()++);
+
+				if(m_components.component(w) != c || m_positions.at(w) < first)
+					continue;
+
+				if(w == start)
+				{
+					found.last() = true;
+
+					bool isNew = !m_everyNode;
+
+					if(m_everyNode)
+					{
+						foreach(int u, path)
+						{
+							if(!onCycle.at(m_positions.at(u)))
+							{
+								onCycle[m_positions.at(u)] = true;
+								uncovered--;
+								isNew = true;
+							}
+						}
+					}
+
+					if(isNew)
+					{
+						cycles.append(path);
+						cycles.last().append(start);
+						pendingNodes += path.size() + 1;
+					}
+
+					continue;
+				}
+
+				if(!blocked.at(m_positions.at(w)))
+				{
+					blocked[m_positions.at(w)] = true;
+					path.append(w);
+					nextEdge.append(m_snapshot.edgeBegin(w));
+					found.append(false);
+				}
+
+				continue;
+			}
+
+			if(found.last())
+			{
+				// v and whatever waited on it can lead back to the start again
+				unblocked.append(m_positions.at(v));
+
+				while(!unblocked.isEmpty())
+				{
+					int u = unblocked.last();
+					unblocked.pop_back();
+
+					if(!blocked.at(u))
+						continue;
+
+					blocked[u] = false;
+					unblocked += blockedSets.at(u).toVector();
+					blockedSets[u].clear();
+				}
+			}
+			else
+			{
+				// v stays blocked until one of its successors is unblocked
+				for(int e = m_snapshot.edgeBegin(v); e < m_snapshot.edgeEnd(v); ++e)
+				{
+					int w = m_snapshot.edgeTarget(e);
+
+					if(m_components.component(w) != c || m_positions.at(w) < first)
+						continue;
+
+					if(!blockedSets.at(m_positions.at(w)).contains(m_positions.at(v)))
+						blockedSets[m_positions.at(w)].append(m_positions.at(v));
+				}
+			}
+
+			bool foundThrough = found.last();
+
+			path.pop_back();
+			nextEdge.pop_back();
+			found.pop_back();
+
+			if(foundThrough && !found.isEmpty())
+				found.last() = true;
+		}
+	}
+
+	return cycles;
+}
@@ -0,0 +1,67 @@
+#ifndef SIMPLECYCLES_H
+#define SIMPLECYCLES_H
+
+#include <QList>
+#include <QVector>
+#include <QTime>
+#include <QAtomicInt>
+
+#include "graphsnapshot.h"
+#include "strongcomponents.h"
+#include "resourcebudget.h"
+
+namespace Algorithm
+{
+	/* Every simple cycle of the snapshot once, by Johnson's algorithm: a
+	   node is blocked while it is on the path or can't lead back to the
+	   start, and unblocked along its blocked set once a cycle is found
+	   through it. A cycle never leaves its strong component, so the
+	   components are searched in parallel, each from its members in
+	   order, a cycle starting with its first member.
+
+	   With everyNode only cycles through a node not on any cycle found
+	   before are kept, and the search stops once every node of a cyclic
+	   component is on one.
+	*/
+	class SimpleCycles
+	{
+		public:
+			SimpleCycles(const GraphSnapshot &snapshot, const StrongComponents &components);
+
+			/* elapsed is the time the budget has already spent, the search
+			   stops and keeps what it has when a limit is hit. */
+			void compute(const ResourceBudget &budget, int elapsed, bool everyNode = false);
+
+			ResourceBudget::Limit truncation() const { return m_truncation; }
+
+			// node indexes, the first one repeated at the end
+			const QList<QVector<int> > &cycles() const { return m_cycles; }
+
+			// the same cycle starting and ending with its node at the given position
+			static QVector<int> rotated(const QVector<int> &cycle, int position);
+
+		private:
+			const GraphSnapshot &m_snapshot;
+			const StrongComponents &m_components;
+
+			// of every node within its component
+			QVector<int> m_positions;
+
+			QList<QVector<int> > m_cycles;
+			bool m_everyNode;
+
+			QTime m_timer;
+			int m_timeLimit;
+			int m_maxNodes;
+
+			// nodes stored by all the searches, the limit that stopped them
+			QAtomicInt m_storedNodes;
+			QAtomicInt m_stop;
+			ResourceBudget::Limit m_truncation;
+
+			QList<QVector<int> > searchComponent(int c);
+			bool shouldStop(int &pendingNodes);
+	};
+}
+
+#endif // SIMPLECYCLES_H
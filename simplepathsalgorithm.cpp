@@ -2,12 +2,17 @@
 
 #include <QDebug>
 
+#include "graphsnapshot.h"
+
 using namespace Algorithm;
 
 void SimplePathsAlgorithm::continuePath(Path *path)
 {
 	addReqResult(path);
 
+	if(isOverBudget())
+		return;
+
 	if(path->nodes().first() == path->nodes().last() && path->nodeCount() > 1)
 		return;
 
@@ -20,6 +25,9 @@ void SimplePathsAlgorithm::continuePath(Path *path)
 			Path *newPath = new Path(path);
 			newPath->appendNode(node);
 			continuePath(newPath);
+
+			if(isOverBudget())
+				return;
 		}
 	}
 }
@@ -28,6 +36,91 @@ void SimplePathsAlgorithm::onCompute()
 {
 	foreach(Node *node, nodes())
 	{
+		if(isOverBudget())
+			return;
+
 		continuePath(new Path(node));
 	}
 }
+
+bool SimplePathsAlgorithm::enumerate(const QList<Node*> &nodeList, PathStore &store, bool primeOnly)
+{
+	beginRun(nodeList);
+
+	GraphSnapshot snapshot(nodeList);
+	int nodeCount = snapshot.nodeCount();
+
+	QVector<bool> onPath(nodeCount, false);
+	QVector<int> path;
+	QVector<int> nextEdge;
+
+	for(int start = 0; start < nodeCount; ++start)
+	{
+		path.append(start);
+		nextEdge.append(snapshot.edgeBegin(start));
+		onPath[start] = true;
+
+		bool entered = true;
+
+		while(!path.isEmpty())
+		{
+			int v = path.last();
+
+			if(entered)
+			{
+				entered = false;
+
+				if(isOverBudget())
+				{
+					store.finish();
+					return false;
+				}
+
+				// the same test as filtering out the subpaths of other simple paths
+				bool extendable = false;
+
+				for(int e = snapshot.edgeBegin(v); e < snapshot.edgeEnd(v) && !extendable; ++e)
+					extendable = !onPath.at(snapshot.edgeTarget(e)) || snapshot.edgeTarget(e) == start;
+
+				for(int i = snapshot.inEdgeBegin(start); i < snapshot.inEdgeEnd(start) && !extendable; ++i)
+					extendable = !onPath.at(snapshot.edgeSource(snapshot.inEdge(i)));
+
+				if((!primeOnly || !extendable) && !store.append(path))
+					return false;
+			}
+
+			if(nextEdge.last() == snapshot.edgeEnd(v))
+			{
+				onPath[v] = false;
+				path.pop_back();
+				nextEdge.pop_back();
+				continue;
+			}
+
+			int target = snapshot.edgeTarget(nextEdge.last()++);
+
+			// a cycle back to the start ends the path, it is always prime
+			if(target == start)
+			{
+				path.append(target);
+				bool ok = store.append(path);
+				path.pop_back();
+
+				if(!ok)
+					return false;
+
+				continue;
+			}
+
+			if(onPath.at(target))
+				continue;
+
+			onPath[target] = true;
+			path.append(target);
+			nextEdge.append(snapshot.edgeBegin(target));
+			entered = true;
+		}
+	}
+
+	return store.finish();
+}
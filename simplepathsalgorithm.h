@@ -2,11 +2,19 @@
 #define SIMPLEPATHSALGORITHM_H
 
 #include "abstractalgorithm.h"
+#include "pathstore.h"
 
 namespace Algorithm
 {
 	class SimplePathsAlgorithm : public AbstractAlgorithm
 	{
+		public:
+			/* Writes the paths as node indexes of the list into the store
+			   instead of keeping them as requirements, only the current
+			   path is held in memory. With primeOnly the paths which can
+			   be extended at either end are left out. */
+			bool enumerate(const QList<Node*> &nodes, PathStore &store, bool primeOnly = false);
+
 		protected:
 			void continuePath(Path *path);
 			void onCompute();
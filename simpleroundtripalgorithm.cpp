@@ -0,0 +1,45 @@
+#include "simpleroundtripalgorithm.h"
+
+#include <QVector>
+
+#include "graphsnapshot.h"
+#include "strongcomponents.h"
+#include "simplecycles.h"
+
+using namespace Algorithm;
+
+void SimpleRoundTripAlgorithm::onCompute()
+{
+	GraphSnapshot snapshot(nodes());
+	StrongComponents components(snapshot);
+
+	SimpleCycles cycles(snapshot, components);
+	cycles.compute(budget(), elapsed(), true);
+
+	if(cycles.truncation() != ResourceBudget::NoLimit)
+		truncate(cycles.truncation());
+
+	// the first cycle found through a node is its round trip
+	QVector<QVector<int> > roundTrips(snapshot.nodeCount());
+
+	foreach(const QVector<int> &cycle, cycles.cycles())
+		for(int i = 0; i < cycle.size() - 1; ++i)
+			if(roundTrips.at(cycle.at(i)).isEmpty())
+				roundTrips[cycle.at(i)] = SimpleCycles::rotated(cycle, i);
+
+	for(int v = 0; v < snapshot.nodeCount(); ++v)
+	{
+		if(roundTrips.at(v).isEmpty())
+			continue;
+
+		if(isOverSizeBudget())
+			return;
+
+		QList<Node*> pathNodes;
+
+		foreach(int u, roundTrips.at(v))
+			pathNodes.append(snapshot.node(u));
+
+		addReqResult(new Path(pathNodes));
+	}
+}
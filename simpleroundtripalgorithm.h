@@ -0,0 +1,19 @@
+#ifndef SIMPLEROUNDTRIPALGORITHM_H
+#define SIMPLEROUNDTRIPALGORITHM_H
+
+#include "abstractalgorithm.h"
+
+namespace Algorithm
+{
+	/* A round trip path - a simple cycle starting and ending with the
+	   node - for every node which lies on a cycle. SimpleCycles stops as
+	   soon as every such node is on one of the cycles it found.
+	*/
+	class SimpleRoundTripAlgorithm : public AbstractAlgorithm
+	{
+		protected:
+			void onCompute();
+	};
+}
+
+#endif // SIMPLEROUNDTRIPALGORITHM_H
@@ -0,0 +1,85 @@
+#include "strongcomponents.h"
+
+using namespace Algorithm;
+
+StrongComponents::StrongComponents(const GraphSnapshot &snapshot)
+{
+	int nodeCount = snapshot.nodeCount();
+
+	QVector<int> index(nodeCount, -1);
+	QVector<int> lowLink(nodeCount, 0);
+	QVector<bool> onStack(nodeCount, false);
+	QVector<int> stack;
+
+	// the depth first search, with the next edge to try for every node on it
+	QVector<int> path;
+	QVector<int> nextEdge;
+
+	int nextIndex = 0;
+
+	m_component.fill(-1, nodeCount);
+	m_offsets.append(0);
+
+	for(int root = 0; root < nodeCount; ++root)
+	{
+		if(index.at(root) != -1)
+			continue;
+
+		index[root] = lowLink[root] = nextIndex++;
+		stack.append(root);
+		onStack[root] = true;
+		path.append(root);
+		nextEdge.append(snapshot.edgeBegin(root));
+
+		while(!path.isEmpty())
+		{
+			int v = path.last();
+
+			if(nextEdge.last() < snapshot.edgeEnd(v))
+			{
+				int w = snapshot.edgeTarget(nextEdge.last()++);
+
+				if(index.at(w) == -1)
+				{
+					index[w] = lowLink[w] = nextIndex++;
+					stack.append(w);
+					onStack[w] = true;
+					path.append(w);
+					nextEdge.append(snapshot.edgeBegin(w));
+				}
+				else if(onStack.at(w))
+				{
+					lowLink[v] = qMin(lowLink.at(v), index.at(w));
+				}
+
+				continue;
+			}
+
+			path.pop_back();
+			nextEdge.pop_back();
+
+			if(!path.isEmpty())
+				lowLink[path.last()] = qMin(lowLink.at(path.last()), lowLink.at(v));
+
+			if(lowLink.at(v) != index.at(v))
+				continue;
+
+			int c = m_offsets.size() - 1;
+			int w;
+
+			do
+			{
+				w = stack.last();
+				stack.pop_back();
+				onStack[w] = false;
+
+				m_component[w] = c;
+				m_members.append(w);
+			}
+			while(w != v);
+
+			m_offsets.append(m_members.size());
+			m_cyclic.append(size(c) > 1 || snapshot.findEdge(v, v) != -1);
+		}
+	}
+}
@@ -0,0 +1,39 @@
+#ifndef STRONGCOMPONENTS_H
+#define STRONGCOMPONENTS_H
+
+#include <QVector>
+
+#include "graphsnapshot.h"
+
+namespace Algorithm
+{
+	/* Strongly connected components of the snapshot (Tarjan, without
+	   recursion). Components are numbered in reverse topological order,
+	   every edge leaving a component goes to one with a smaller number.
+	*/
+	class StrongComponents
+	{
+		public:
+			StrongComponents(const GraphSnapshot &snapshot);
+
+			int componentCount() const { return m_offsets.size() - 1; }
+			int component(int v) const { return m_component.at(v); }
+
+			// nodes of the component are member(memberBegin(c))..member(memberEnd(c) - 1)
+			int memberBegin(int c) const { return m_offsets.at(c); }
+			int memberEnd(int c) const { return m_offsets.at(c + 1); }
+			int member(int i) const { return m_members.at(i); }
+			int size(int c) const { return memberEnd(c) - memberBegin(c); }
+
+			// a component with a cycle - more nodes or a node linked to itself
+			bool isCyclic(int c) const { return m_cyclic.at(c); }
+
+		private:
+			QVector<int> m_component;
+			QVector<int> m_offsets;
+			QVector<int> m_members;
+			QVector<bool> m_cyclic;
+	};
+}
+
+#endif // STRONGCOMPONENTS_H
@@ -0,0 +1,222 @@
+#include "subsequenceautomaton.h"
+
+#include <QObject>
+#include <QtAlgorithms>
+
+#include <algorithm>
+
+using namespace Algorithm;
+
+QString Algorithm::touringModeText(TouringMode mode)
+{
+	switch(mode)
+	{
+		case SidetripTouring:
+			return "sidetrips";
+
+		case DetourTouring:
+			return "detours";
+
+		default: ;
+	}
+
+	return "direct";
+}
+
+TouringMode Algorithm::touringModeFromText(const QString &text, bool *ok)
+{
+	if(ok != 0)
+		*ok = true;
+
+	if(text == "sidetrips")
+		return SidetripTouring;
+
+	if(text == "detours")
+		return DetourTouring;
+
+	if(ok != 0 && text != "direct")
+		*ok = false;
+
+	return DirectTouring;
+}
+
+QVector<quint64> Algorithm::touringSymbols(const QVector<int> &path, TouringMode mode)
+{
+	QVector<quint64> symbols;
+
+	if(mode == SidetripTouring && path.size() > 1)
+	{
+		for(int i = 1; i < path.size(); ++i)
+			symbols.append(edgeSymbol(path.at(i - 1), path.at(i)));
+	}
+	else
+	{
+		foreach(int node, path)
+			symbols.append(nodeSymbol(node));
+	}
+
+	return symbols;
+}
+
+SubsequenceAutomaton::SubsequenceAutomaton(const QVector<int> &walk, TouringMode mode)
+	: m_walk(walk), m_mode(mode)
+{
+	if(mode == DirectTouring)
+		return;
+
+	// edge i goes from node i to node i + 1
+	for(int i = 0; i < walk.size(); ++i)
+	{
+		m_positions[nodeSymbol(walk.at(i))].append(i);
+
+		if(mode == SidetripTouring && i > 0)
+			m_positions[edgeSymbol(walk.at(i - 1), walk.at(i))].append(i - 1);
+	}
+}
+
+bool SubsequenceAutomaton::tours(const QVector<int> &path) const
+{
+	if(path.isEmpty())
+		return true;
+
+	if(m_mode == DirectTouring)
+	{
+		for(int i = 0; i + path.size() <= m_walk.size(); ++i)
+			if(m_walk.at(i) == path.first() && std::equal(path.constBegin(), path.constEnd(), m_walk.constBegin() + i))
+				return true;
+
+		return false;
+	}
+
+	int position = 0;
+
+	foreach(quint64 symbol, touringSymbols(path, m_mode))
+	{
+		QHash<quint64, QVector<int> >::const_iterator it = m_positions.constFind(symbol);
+
+		if(it == m_positions.constEnd())
+			return false;
+
+		QVector<int>::const_iterator next = qLowerBound(it.value().constBegin(), it.value().constEnd(), position);
+
+		if(next == it.value().constEnd())
+			return false;
+
+		position = *next + 1;
+	}
+
+	return true;
+}
+
+SubsequenceMatcher::SubsequenceMatcher()
+	: m_mode(DetourTouring)
+{
+}
+
+void SubsequenceMatcher::build(const QList<QVector<int> > &paths, TouringMode mode)
+{
+	m_mode = mode;
+	m_patterns.clear();
+	m_starters.clear();
+
+	foreach(const QVector<int> &path, paths)
+	{
+		QVector<quint64> symbols = touringSymbols(path, mode);
+
+		if(!symbols.isEmpty())
+			m_starters[symbols.first()].append(m_patterns.size());
+
+		m_patterns.append(symbols);
+	}
+}
+
+void SubsequenceMatcher::initProgress(Progress &progress) const
+{
+	progress.toured.fill(0, m_patterns.size());
+	progress.touredNow.clear();
+	progress.positions.fill(0, m_patterns.size());
+	progress.walks.fill(-1, m_patterns.size());
+	progress.waiting.clear();
+	progress.walk = 0;
+	progress.previous = -1;
+}
+
+void SubsequenceMatcher::beginWalk(Progress &progress) const
+{
+	progress.waiting.clear();
+	progress.touredNow.clear();
+	progress.walk++;
+	progress.previous = -1;
+}
+
+void SubsequenceMatcher::advance(Progress &progress, int pattern) const
+{
+	const QVector<quint64> &symbols = m_patterns.at(pattern);
+	int position = ++progress.positions[pattern];
+
+	if(position == symbols.size())
+	{
+		progress.toured[pattern] = 1;
+		progress.touredNow.append(pattern);
+		return;
+	}
+
+	progress.waiting[symbols.at(position)].append(pattern);
+}
+
+void SubsequenceMatcher::stepSymbol(Progress &progress, quint64 symbol) const
+{
+	// taken out first, so that nothing moves twice on one event
+	QHash<quint64, QVector<int> >::iterator waiting = progress.waiting.find(symbol);
+
+	if(waiting != progress.waiting.end())
+	{
+		QVector<int> moving = waiting.value();
+		progress.waiting.erase(waiting);
+
+		foreach(int pattern, moving)
+			advance(progress, pattern);
+	}
+
+	QHash<quint64, QVector<int> >::const_iterator starters = m_starters.constFind(symbol);
+
+	if(starters == m_starters.constEnd())
+		return;
+
+	foreach(int pattern, starters.value())
+	{
+		if(progress.toured.at(pattern) || progress.walks.at(pattern) == progress.walk)
+			continue;
+
+		progress.walks[pattern] = progress.walk;
+		progress.positions[pattern] = 0;
+		advance(progress, pattern);
+	}
+}
+
+void SubsequenceMatcher::step(Progress &progress, int node) const
+{
+	stepSymbol(progress, nodeSymbol(node));
+
+	if(m_mode == SidetripTouring && progress.previous != -1)
+		stepSymbol(progress, edgeSymbol(progress.previous, node));
+
+	progress.previous = node;
+}
+
+QVector<int> SubsequenceMatcher::matches(Progress &progress, const QVector<int> &walk) const
+{
+	beginWalk(progress);
+
+	foreach(int node, walk)
+		step(progress, node);
+
+	QVector<int> result = progress.touredNow;
+
+	foreach(int pattern, result)
+		progress.toured[pattern] = 0;
+
+	progress.touredNow.clear();
+
+	return result;
+}
@@ -0,0 +1,94 @@
+#ifndef SUBSEQUENCEAUTOMATON_H
+#define SUBSEQUENCEAUTOMATON_H
+
+#include <QList>
+#include <QVector>
+#include <QHash>
+#include <QString>
+
+namespace Algorithm
+{
+	/* How a test path may tour a requirement (Ammann & Offutt): directly
+	   as a subpath, with sidetrips when the requirement's edges are taken
+	   in order with anything in between, with detours when only its nodes
+	   are visited in order. */
+	enum TouringMode { DirectTouring, SidetripTouring, DetourTouring };
+
+	QString touringModeText(TouringMode mode);
+	TouringMode touringModeFromText(const QString &text, bool *ok = 0);
+
+	/* The symbols a walk is matched on, nodes and edges are kept apart.
+	   With sidetrips a requirement of one node has no edge to match, its
+	   node is matched instead. */
+	inline quint64 nodeSymbol(int node) { return ((quint64)1 << 63) | (quint32)node; }
+	inline quint64 edgeSymbol(int from, int to) { return ((quint64)(quint32)from << 32) | (quint32)to; }
+
+	QVector<quint64> touringSymbols(const QVector<int> &path, TouringMode mode);
+
+	/* Sparse subsequence automaton of one walk: the positions of every
+	   symbol in it, the next state is the first position after the current
+	   one. Taking the earliest occurrence is never worse, so checking a
+	   requirement is a binary search per symbol and nothing backtracks. */
+	class SubsequenceAutomaton
+	{
+		public:
+			SubsequenceAutomaton(const QVector<int> &walk, TouringMode mode);
+
+			bool tours(const QVector<int> &path) const;
+
+		private:
+			QVector<int> m_walk;
+			TouringMode m_mode;
+			QHash<quint64, QVector<int> > m_positions;
+	};
+
+	/* All the requirements against many walks at once, for the subsequence
+	   modes. A requirement started in the current walk waits in the list of
+	   its next symbol and an event moves on only those waiting for it; one
+	   starts at the earliest occurrence of its first symbol and those toured
+	   already are not started again. */
+	class SubsequenceMatcher
+	{
+		public:
+			typedef struct
+			{
+				QVector<quint8> toured;
+
+				// toured during the current walk, for callers counting per walk
+				QVector<int> touredNow;
+
+				QVector<int> positions;
+				QVector<int> walks;
+				QHash<quint64, QVector<int> > waiting;
+				int walk;
+				int previous;
+			} Progress;
+
+			SubsequenceMatcher();
+
+			void build(const QList<QVector<int> > &paths, TouringMode mode);
+
+			int pathCount() const { return m_patterns.size(); }
+
+			void initProgress(Progress &progress) const;
+
+			void beginWalk(Progress &progress) const;
+			void step(Progress &progress, int node) const;
+
+			// an unknown node, no edge goes over it
+			void breakWalk(Progress &progress) const { progress.previous = -1; }
+
+			// the indexes of the paths the walk tours, the progress is left as it was
+			QVector<int> matches(Progress &progress, const QVector<int> &walk) const;
+
+		private:
+			TouringMode m_mode;
+			QVector<QVector<quint64> > m_patterns;
+			QHash<quint64, QVector<int> > m_starters;
+
+			void stepSymbol(Progress &progress, quint64 symbol) const;
+			void advance(Progress &progress, int pattern) const;
+	};
+}
+
+#endif // SUBSEQUENCEAUTOMATON_H
@@ -0,0 +1,954 @@
+#include "suiteoptimizer.h"
+
+#include <QDebug>
+#include <QtAlgorithms>
+
+#include <queue>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <limits>
+
+#include "strongcomponents.h"
+
+using namespace Algorithm;
+
+// lengths closer than this are the same
+#define LENGTH_EPSILON 1e-9
+
+#define UNLAYERED 0x7FFFFFFF
+
+namespace
+{
+	const double Unreachable = std::numeric_limits<double>::infinity();
+
+	int lowestBit(quint64 bits)
+	{
+		int i = 0;
+
+		while((bits & 1) == 0)
+		{
+			bits >>= 1;
+			i++;
+		}
+
+		return i;
+	}
+
+	// the first set bit of the row from the given one on, -1 when there is none
+	int nextBit(const quint64 *row, int words, int from)
+	{
+		for(int w = from / 64; w < words; ++w)
+		{
+			quint64 bits = row[w];
+
+			if(w == from / 64)
+				bits &= ~(quint64)0 << (from % 64);
+
+			if(bits != 0)
+				return w * 64 + lowestBit(bits);
+		}
+
+		return -1;
+	}
+}
+
+SuiteOptimizer::SuiteOptimizer(const GraphSnapshot &snapshot, const QList<QVector<int> > &requirements,
+			       TouringMode touring, Objective objective)
+	: m_snapshot(snapshot), m_requirements(requirements),
+	  m_touring(requirements, snapshot.nodeCount(), touring), m_objective(objective),
+	  m_totalLength(0), m_bestCount(0), m_bestLength(0), m_lowerBound(0), m_moves(0), m_timeLimit(0), m_cancel(0)
+{
+	m_multiplicity.fill(0, requirements.size());
+	m_required.fill(false, requirements.size());
+	m_mark.fill(false, requirements.size());
+}
+
+void SuiteOptimizer::setSuite(const QList<QVector<int> > &walks)
+{
+	m_walks.clear();
+	m_tours.clear();
+	m_lengths.clear();
+	m_multiplicity.fill(0);
+	m_required.fill(false);
+	m_totalLength = 0;
+
+	foreach(const QVector<int> &walk, walks)
+	{
+		QVector<int> toured = m_touring.matches(walk);
+
+		foreach(int r, toured)
+		{
+			m_multiplicity[r]++;
+			m_required[r] = true;
+		}
+
+		m_walks.append(walk);
+		m_tours.append(toured);
+		m_lengths.append(walkLength(walk));
+		m_totalLength += m_lengths.last();
+	}
+
+	m_best = m_walks;
+	m_bestCount = m_walks.size();
+	m_bestLength = m_totalLength;
+}
+
+bool SuiteOptimizer::isBetter(int count, double length, int thanCount, double thanLength) const
+{
+	if(m_objective == LowestCost)
+	{
+		if(length < thanLength - LENGTH_EPSILON)
+			return true;
+
+		if(length > thanLength + LENGTH_EPSILON)
+			return false;
+
+		return count < thanCount;
+	}
+
+	if(count != thanCount)
+		return count < thanCount;
+
+	return length < thanLength - LENGTH_EPSILON;
+}
+
+double SuiteOptimizer::stepLength(int from, int to) const
+{
+	if(m_objective != LowestCost)
+		return 1;
+
+	double length = Unreachable;
+
+	// parallel edges may cost differently
+	for(int e = m_snapshot.edgeBegin(from); e < m_snapshot.edgeEnd(from); ++e)
+		if(m_snapshot.edgeTarget(e) == to)
+			length = qMin(length, qMax(m_snapshot.edgeCost(e), 0.0));
+
+	return length == Unreachable ? 0 : length;
+}
+
+double SuiteOptimizer::walkLength(const QVector<int> &walk) const
+{
+	double length = 0;
+
+	for(int i = 1; i < walk.size(); ++i)
+		length += stepLength(walk.at(i - 1), walk.at(i));
+
+	return length;
+}
+
+const SuiteOptimizer::Tree &SuiteOptimizer::tree(int root, bool reverse)
+{
+	QHash<int, Tree> &trees = reverse ? m_reverseTrees : m_forwardTrees;
+	QHash<int, Tree>::iterator it = trees.find(root);
+
+	if(it != trees.end())
+		return it.value();
+
+	Tree &result = trees[root];
+	int nodeCount = m_snapshot.nodeCount();
+
+	result.distance.fill(Unreachable, nodeCount);
+	result.parent.fill(-1, nodeCount);
+
+	// Dijkstra with a binary heap, stale entries are skipped
+	typedef std::pair<double, int> Entry;
+	std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > heap;
+
+	for(int v = 0; v < nodeCount; ++v)
+	{
+		bool isRoot = root == -1 ? (reverse ? m_snapshot.isEnd(v) : m_snapshot.isStart(v)) : v == root;
+
+		if(isRoot)
+		{
+			result.distance[v] = 0;
+			heap.push(std::make_pair(0.0, v));
+		}
+	}
+
+	while(!heap.empty())
+	{
+		Entry top = heap.top();
+		heap.pop();
+
+		int v = top.second;
+
+		if(top.first > result.distance.at(v))
+			continue;
+
+		int begin = reverse ? m_snapshot.inEdgeBegin(v) : m_snapshot.edgeBegin(v);
+		int end = reverse ? m_snapshot.inEdgeEnd(v) : m_snapshot.edgeEnd(v);
+
+		for(int i = begin; i < end; ++i)
+		{
+			int e = reverse ? m_snapshot.inEdge(i) : i;
+			int next = reverse ? m_snapshot.edgeSource(e) : m_snapshot.edgeTarget(e);
+			double length = top.first + (m_objective == LowestCost ? qMax(m_snapshot.edgeCost(e), 0.0) : 1.0);
+
+			if(length < result.distance.at(next))
+			{
+				result.distance[next] = length;
+				result.parent[next] = v;
+				heap.push(std::make_pair(length, next));
+			}
+		}
+	}
+
+	return result;
+}
+
+void SuiteOptimizer::limitTrees()
+{
+	qint64 treeBytes = (qint64)m_snapshot.nodeCount() * (sizeof(double) + sizeof(int));
+
+	// trees handed out before must not go away, so this is only called between moves
+	if((m_forwardTrees.size() + m_reverseTrees.size()) * treeBytes > MaxTreeBytes)
+	{
+		m_forwardTrees.clear();
+		m_reverseTrees.clear();
+	}
+}
+
+bool SuiteOptimizer::connect(int from, int to, QVector<int> &walk)
+{
+	if(from == to)
+		return true;
+
+	const Tree &fromTree = tree(from, false);
+
+	if(fromTree.distance.at(to) == Unreachable)
+		return false;
+
+	QVector<int> path;
+
+	for(int v = to; v != from; v = fromTree.parent.at(v))
+		path.append(v);
+
+	for(int i = path.size() - 1; i >= 0; --i)
+		walk.append(path.at(i));
+
+	return true;
+}
+
+bool SuiteOptimizer::connectFromStart(int to, QVector<int> &walk)
+{
+	const Tree &startTree = tree(-1, false);
+
+	if(startTree.distance.at(to) == Unreachable)
+		return false;
+
+	QVector<int> path;
+
+	for(int v = to; v != -1; v = startTree.parent.at(v))
+		path.append(v);
+
+	for(int i = path.size() - 1; i >= 0; --i)
+		walk.append(path.at(i));
+
+	return true;
+}
+
+bool SuiteOptimizer::connectToEnd(int from, QVector<int> &walk)
+{
+	const Tree &endTree = tree(-1, true);
+
+	if(endTree.distance.at(from) == Unreachable)
+		return false;
+
+	for(int v = endTree.parent.at(from); v != -1; v = endTree.parent.at(v))
+		walk.append(v);
+
+	return true;
+}
+
+bool SuiteOptimizer::tours(const QVector<int> &walk, const QVector<int> &requirements)
+{
+	if(requirements.isEmpty())
+		return true;
+
+	QVector<int> toured = m_touring.matches(walk);
+	bool all = true;
+
+	foreach(int r, toured)
+		m_mark[r] = true;
+
+	foreach(int r, requirements)
+		all = all && m_mark.at(r);
+
+	foreach(int r, toured)
+		m_mark[r] = false;
+
+	return all;
+}
+
+int SuiteOptimizer::shortestPrefix(const QVector<int> &walk, const QVector<int> &requirements)
+{
+	// longer prefixes tour more, the last position of the shortest one is searched for
+	int low = 0;
+	int high = walk.size() - 1;
+
+	while(low < high)
+	{
+		int middle = (low + high) / 2;
+
+		if(tours(walk.mid(0, middle + 1), requirements))
+			high = middle;
+		else
+			low = middle + 1;
+	}
+
+	return low;
+}
+
+int SuiteOptimizer::shortestSuffix(const QVector<int> &walk, const QVector<int> &requirements)
+{
+	int low = 0;
+	int high = walk.size() - 1;
+
+	while(low < high)
+	{
+		int middle = (low + high + 1) / 2;
+
+		if(tours(walk.mid(middle), requirements))
+			low = middle;
+		else
+			high = middle - 1;
+	}
+
+	return low;
+}
+
+bool SuiteOptimizer::trimmed(const QVector<int> &walk, const QVector<int> &requirements, QVector<int> &result)
+{
+	if(requirements.isEmpty())
+		return false;
+
+	// the shortest part of the walk touring them, joined to the nearest start and end
+	int end = shortestPrefix(walk, requirements);
+	int begin = shortestSuffix(walk.mid(0, end + 1), requirements);
+
+	result.clear();
+
+	if(!connectFromStart(walk.at(begin), result))
+		return false;
+
+	for(int i = begin + 1; i <= end; ++i)
+		result.append(walk.at(i));
+
+	return connectToEnd(walk.at(end), result);
+}
+
+QVector<int> SuiteOptimizer::neededBy(const QList<int> &walks) const
+{
+	QHash<int, int> counts;
+
+	foreach(int w, walks)
+		foreach(int r, m_tours.at(w))
+			counts[r]++;
+
+	QVector<int> needed;
+
+	for(QHash<int, int>::const_iterator it = counts.constBegin(); it != counts.constEnd(); ++it)
+		if(m_required.at(it.key()) && it.value() == m_multiplicity.at(it.key()))
+			needed.append(it.key());
+
+	qSort(needed);
+
+	return needed;
+}
+
+bool SuiteOptimizer::replace(const QList<int> &replaced, const QList<QVector<int> > &added, bool force)
+{
+	double length = m_totalLength;
+
+	foreach(int w, replaced)
+	{
+		foreach(int r, m_tours.at(w))
+			m_multiplicity[r]--;
+
+		length -= m_lengths.at(w);
+	}
+
+	QList<QVector<int> > addedTours;
+	QList<double> addedLengths;
+
+	foreach(const QVector<int> &walk, added)
+	{
+		addedTours.append(m_touring.matches(walk));
+		addedLengths.append(walkLength(walk));
+		length += addedLengths.last();
+
+		foreach(int r, addedTours.last())
+			m_multiplicity[r]++;
+	}
+
+	bool lost = false;
+
+	foreach(int w, replaced)
+		foreach(int r, m_tours.at(w))
+			lost = lost || (m_required.at(r) && m_multiplicity.at(r) == 0);
+
+	int count = m_walks.size() - replaced.size() + added.size();
+
+	if(lost || (!force && !isBetter(count, length, m_walks.size(), m_totalLength)))
+	{
+		foreach(const QVector<int> &toured, addedTours)
+			foreach(int r, toured)
+				m_multiplicity[r]--;
+
+		foreach(int w, replaced)
+			foreach(int r, m_tours.at(w))
+				m_multiplicity[r]++;
+
+		return false;
+	}
+
+	QList<int> order(replaced);
+	qSort(order.begin(), order.end(), qGreater<int>());
+
+	foreach(int w, order)
+	{
+		m_walks.removeAt(w);
+		m_tours.removeAt(w);
+		m_lengths.removeAt(w);
+	}
+
+	m_walks += added;
+	m_tours += addedTours;
+	m_lengths += addedLengths;
+	m_totalLength = length;
+	m_moves++;
+
+	return true;
+}
+
+void SuiteOptimizer::keepBest()
+{
+	if(!isBetter(m_walks.size(), m_totalLength, m_bestCount, m_bestLength))
+		return;
+
+	m_best = m_walks;
+	m_bestCount = m_walks.size();
+	m_bestLength = m_totalLength;
+}
+
+bool SuiteOptimizer::dropRedundant()
+{
+	for(int w = 0; w < m_walks.size(); ++w)
+		if(neededBy(QList<int>() << w).isEmpty() && replace(QList<int>() << w, QList<QVector<int> >()))
+			return true;
+
+	return false;
+}
+
+bool SuiteOptimizer::mergeWalks()
+{
+	for(int a = 0; a < m_walks.size(); ++a)
+	{
+		for(int b = 0; b < m_walks.size(); ++b)
+		{
+			if(a == b)
+				continue;
+
+			if(isOutOfTime())
+				return false;
+
+			limitTrees();
+
+			QList<int> pair;
+			pair << a << b;
+
+			QVector<int> needed = neededBy(pair);
+			const QVector<int> &first = m_walks.at(a);
+			const QVector<int> &second = m_walks.at(b);
+
+			// what the first one tours is kept at the beginning, the rest comes from the end of the second
+			QVector<int> headNeeds;
+
+			foreach(int r, m_tours.at(a))
+				m_mark[r] = true;
+
+			foreach(int r, needed)
+				if(m_mark.at(r))
+					headNeeds.append(r);
+
+			foreach(int r, m_tours.at(a))
+				m_mark[r] = false;
+
+			int end = headNeeds.isEmpty() ? 0 : shortestPrefix(first, headNeeds);
+			QVector<int> walk = first.mid(0, end + 1);
+			QVector<int> headTours = m_touring.matches(walk);
+			QVector<int> tailNeeds;
+
+			foreach(int r, headTours)
+				m_mark[r] = true;
+
+			foreach(int r, needed)
+				if(!m_mark.at(r))
+					tailNeeds.append(r);
+
+			foreach(int r, headTours)
+				m_mark[r] = false;
+
+			int begin = tailNeeds.isEmpty() ? second.size() - 1 : shortestSuffix(second, tailNeeds);
+
+			if(!connect(walk.last(), second.at(begin), walk))
+				continue;
+
+			walk += second.mid(begin + 1);
+
+			if(replace(pair, QList<QVector<int> >() << walk))
+				return true;
+		}
+	}
+
+	return false;
+}
+
+bool SuiteOptimizer::moveRequirements()
+{
+	if(m_walks.size() < 2)
+		return false;
+
+	for(int a = 0; a < m_walks.size(); ++a)
+	{
+		if(isOutOfTime())
+			return false;
+
+		QVector<int> needed = neededBy(QList<int>() << a);
+
+		if(needed.isEmpty() || needed.size() > MoveLimit)
+			continue;
+
+		limitTrees();
+
+		// every requirement goes on a round trip from the walk which gets there and back the shortest way
+		QHash<int, QVector<int> > changed;
+		bool placed = true;
+
+		foreach(int r, needed)
+		{
+			const QVector<int> &requirement = m_requirements.at(r);
+			const Tree &there = tree(requirement.first(), true);
+			const Tree &back = tree(requirement.last(), false);
+
+			int bestWalk = -1;
+			int bestPosition = -1;
+			double bestLength = Unreachable;
+
+			for(int b = 0; b < m_walks.size(); ++b)
+			{
+				if(b == a)
+					continue;
+
+				QVector<int> walk = changed.value(b, m_walks.at(b));
+
+				for(int k = 0; k < walk.size(); ++k)
+				{
+					double length = there.distance.at(walk.at(k)) + back.distance.at(walk.at(k));
+
+					if(length < bestLength)
+					{
+						bestWalk = b;
+						bestPosition = k;
+						bestLength = length;
+					}
+				}
+			}
+
+			if(bestWalk == -1)
+			{
+				placed = false;
+				break;
+			}
+
+			QVector<int> walk = changed.value(bestWalk, m_walks.at(bestWalk));
+			QVector<int> detour = walk.mid(0, bestPosition + 1);
+
+			connect(walk.at(bestPosition), requirement.first(), detour);
+			detour += requirement.mid(1);
+			connect(requirement.last(), walk.at(bestPosition), detour);
+			detour += walk.mid(bestPosition + 1);
+
+			changed.insert(bestWalk, detour);
+		}
+
+		if(!placed)
+			continue;
+
+		QList<int> replaced;
+		QList<QVector<int> > added;
+
+		replaced << a;
+
+		for(QHash<int, QVector<int> >::const_iterator it = changed.constBegin(); it != changed.constEnd(); ++it)
+		{
+			replaced << it.key();
+			added << it.value();
+		}
+
+		// a detour may split a requirement the walk toured directly, then nothing moves
+		if(replace(replaced, added))
+			return true;
+	}
+
+	return false;
+}
+
+bool SuiteOptimizer::trimWalks()
+{
+	for(int w = 0; w < m_walks.size(); ++w)
+	{
+		if(isOutOfTime())
+			return false;
+
+		limitTrees();
+
+		QVector<int> result;
+
+		if(trimmed(m_walks.at(w), neededBy(QList<int>() << w), result) && result != m_walks.at(w)
+		   && replace(QList<int>() << w, QList<QVector<int> >() << result))
+			return true;
+	}
+
+	return false;
+}
+
+bool SuiteOptimizer::rerouteWalks()
+{
+	for(int w = 0; w < m_walks.size(); ++w)
+	{
+		QVector<int> walk = m_walks.at(w);
+
+		// length up to every position
+		QVector<double> prefix(walk.size(), 0);
+
+		for(int i = 1; i < walk.size(); ++i)
+			prefix[i] = prefix.at(i - 1) + stepLength(walk.at(i - 1), walk.at(i));
+
+		for(int p = 0; p + 2 < walk.size(); ++p)
+		{
+			if(isOutOfTime())
+				return false;
+
+			limitTrees();
+
+			const Tree &fromTree = tree(walk.at(p), false);
+
+			// the longest stretch which can be shortened first
+			for(int q = walk.size() - 1; q >= p + 2; --q)
+			{
+				if(fromTree.distance.at(walk.at(q)) >= prefix.at(q) - prefix.at(p) - LENGTH_EPSILON)
+					continue;
+
+				QVector<int> shorter = walk.mid(0, p + 1);
+				connect(walk.at(p), walk.at(q), shorter);
+				shorter += walk.mid(q + 1);
+
+				if(replace(QList<int>() << w, QList<QVector<int> >() << shorter))
+					return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+bool SuiteOptimizer::splitWalk()
+{
+	QList<int> candidates;
+
+	for(int w = 0; w < m_walks.size(); ++w)
+		if(neededBy(QList<int>() << w).size() >= 2)
+			candidates.append(w);
+
+	if(candidates.isEmpty())
+		return false;
+
+	limitTrees();
+
+	int w = candidates.at(qrand() % candidates.size());
+	QVector<int> walk = m_walks.at(w);
+	QVector<int> needed = neededBy(QList<int>() << w);
+
+	// what the first half of the walk tours goes to one, the rest to the other
+	QVector<int> headTours = m_touring.matches(walk.mid(0, walk.size() / 2 + 1));
+	QVector<int> head, tail;
+
+	foreach(int r, headTours)
+		m_mark[r] = true;
+
+	foreach(int r, needed)
+	{
+		if(m_mark.at(r))
+			head.append(r);
+		else
+			tail.append(r);
+	}
+
+	foreach(int r, headTours)
+		m_mark[r] = false;
+
+	if(head.isEmpty() || tail.isEmpty())
+	{
+		head = needed.mid(0, needed.size() / 2);
+		tail = needed.mid(needed.size() / 2);
+	}
+
+	QVector<int> first, second;
+
+	if(!trimmed(walk, head, first) || !trimmed(walk, tail, second))
+		return false;
+
+	return replace(QList<int>() << w, QList<QVector<int> >() << first << second, true);
+}
+
+void SuiteOptimizer::optimize(int timeLimit)
+{
+	m_timeLimit = timeLimit;
+	m_timer.start();
+	m_moves = 0;
+
+	computeLowerBound();
+
+	while(!isOutOfTime())
+	{
+		bool improved = dropRedundant() || mergeWalks() || moveRequirements() || trimWalks() || rerouteWalks();
+
+		keepBest();
+
+		if(improved)
+			continue;
+
+		// with the fewest walks possible only their length is left, splitting can't help that
+		if(m_objective == FewestPaths && isOptimal())
+			break;
+
+		if(isOutOfTime() || !splitWalk())
+			break;
+	}
+
+#ifdef DEBUG
+	qWarning() << "SuiteOptimizer::optimize:" << m_bestCount << "walks, length" << m_bestLength
+		   << "lower bound" << m_lowerBound << "after" << m_moves << "moves in" << m_timer.elapsed() << "ms";
+#endif
+}
+
+int SuiteOptimizer::estimateLowerBound(int timeLimit)
+{
+	m_timeLimit = timeLimit;
+	m_timer.start();
+
+	const Tree &startTree = tree(-1, false);
+	const Tree &endTree = tree(-1, true);
+
+	for(int r = 0; r < m_requirements.size(); ++r)
+	{
+		const QVector<int> &requirement = m_requirements.at(r);
+
+		m_required[r] = !requirement.isEmpty() && startTree.distance.at(requirement.first()) != Unreachable
+				&& endTree.distance.at(requirement.last()) != Unreachable;
+	}
+
+	computeLowerBound();
+
+	return m_lowerBound;
+}
+
+void SuiteOptimizer::computeLowerBound()
+{
+	m_lowerBound = 0;
+
+	StrongComponents components(m_snapshot);
+	int componentCount = components.componentCount();
+
+	// components holding the first node of a requirement to tour
+	QVector<int> slot(componentCount, -1);
+	QVector<int> slotComponent;
+
+	for(int r = 0; r < m_requirements.size(); ++r)
+	{
+		if(!m_required.at(r) || m_requirements.at(r).isEmpty())
+			continue;
+
+		int c = components.component(m_requirements.at(r).first());
+
+		if(slot.at(c) == -1)
+		{
+			slot[c] = slotComponent.size();
+			slotComponent.append(c);
+		}
+	}
+
+	int count = slotComponent.size();
+
+	if(count == 0)
+		return;
+
+	// one walk at least, whatever else runs out
+	m_lowerBound = 1;
+
+	int words = (count + 63) / 64;
+
+	if((qint64)componentCount * words * sizeof(quint64) > MaxBoundBytes)
+		return;
+
+	QVector<quint64> reach(componentCount * words, 0);
+	quint64 *reachData = reach.data();
+
+	// sinks come first, so the components an edge leads to are done already
+	for(int c = 0; c < componentCount; ++c)
+	{
+		if(isOutOfTime())
+			return;
+
+		quint64 *bits = reachData + c * words;
+
+		for(int i = components.memberBegin(c); i < components.memberEnd(c); ++i)
+		{
+			int v = components.member(i);
+
+			for(int e = m_snapshot.edgeBegin(v); e < m_snapshot.edgeEnd(v); ++e)
+			{
+				int t = components.component(m_snapshot.edgeTarget(e));
+
+				if(t == c)
+					continue;
+
+				const quint64 *next = reachData + t * words;
+
+				for(int w = 0; w < words; ++w)
+					bits[w] |= next[w];
+
+				if(slot.at(t) != -1)
+					bits[slot.at(t) / 64] |= (quint64)1 << (slot.at(t) % 64);
+			}
+		}
+	}
+
+	QVector<quint64> closure(count * words);
+
+	for(int s = 0; s < count; ++s)
+		for(int w = 0; w < words; ++w)
+			closure[s * words + w] = reach.at(slotComponent.at(s) * words + w);
+
+	// the fewest chains covering the components
+	int matching = maximumMatching(closure, count, words);
+
+	if(matching != -1)
+		m_lowerBound = count - matching;
+}
+
+int SuiteOptimizer::maximumMatching(const QVector<quint64> &closure, int count, int words)
+{
+	// Hopcroft-Karp, the edges are the bits of the closure
+	QVector<int> matchLeft(count, -1);
+	QVector<int> matchRight(count, -1);
+	QVector<int> layer(count);
+	QVector<int> queue(count);
+	QVector<int> next(count);
+	QVector<int> stack;
+	int matching = 0;
+
+	for(;;)
+	{
+		if(isOutOfTime())
+			return -1;
+
+		// layers from the free left nodes, over the matched edges back to the left
+		int head = 0;
+		int tail = 0;
+		bool found = false;
+
+		for(int u = 0; u < count; ++u)
+		{
+			if(matchLeft.at(u) == -1)
+			{
+				layer[u] = 0;
+				queue[tail++] = u;
+			}
+			else
+			{
+				layer[u] = UNLAYERED;
+			}
+		}
+
+		while(head < tail)
+		{
+			int u = queue.at(head++);
+			const quint64 *row = closure.constData() + u * words;
+
+			for(int w = 0; w < words; ++w)
+			{
+				for(quint64 bits = row[w]; bits != 0; bits &= bits - 1)
+				{
+					int m = matchRight.at(w * 64 + lowestBit(bits));
+
+					if(m == -1)
+					{
+						found = true;
+					}
+					else if(layer.at(m) == UNLAYERED)
+					{
+						layer[m] = layer.at(u) + 1;
+						queue[tail++] = m;
+					}
+				}
+			}
+		}
+
+		if(!found)
+			return matching;
+
+		// augmenting paths along the layers, next is the edge every left node is at
+		next.fill(0);
+
+		for(int root = 0; root < count; ++root)
+		{
+			if(matchLeft.at(root) != -1)
+				continue;
+
+			stack.clear();
+			stack.append(root);
+
+			while(!stack.isEmpty())
+			{
+				int u = stack.last();
+				int v = nextBit(closure.constData() + u * words, words, next.at(u));
+
+				if(v == -1)
+				{
+					layer[u] = UNLAYERED;
+					stack.pop_back();
+
+					if(!stack.isEmpty())
+						next[stack.last()]++;
+
+					continue;
+				}
+
+				next[u] = v;
+
+				int m = matchRight.at(v);
+
+				if(m == -1)
+				{
+					foreach(int s, stack)
+					{
+						matchLeft[s] = next.at(s);
+						matchRight[next.at(s)] = s;
+					}
+
+					matching++;
+					break;
+				}
+
+				if(layer.at(m) == layer.at(u) + 1)
+					stack.append(m);
+				else
+					next[u] = v + 1;
+			}
+		}
+	}
+}
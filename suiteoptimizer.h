@@ -0,0 +1,140 @@
+#ifndef SUITEOPTIMIZER_H
+#define SUITEOPTIMIZER_H
+
+#include <QList>
+#include <QVector>
+#include <QHash>
+#include <QTime>
+#include <QAtomicInt>
+
+#include "graphsnapshot.h"
+#include "abstractalgorithm.h"
+#include "requirementtouring.h"
+
+namespace Algorithm
+{
+	/* Improves a test suite by local search until the time is up. Walks
+	   are merged, requirements moved into detours of other walks, walks
+	   trimmed to the part only they tour and rerouted over shorter paths;
+	   a move is taken when no requirement toured before is lost and the
+	   suite gets better - fewer walks, then shorter ones, or cheaper and
+	   then fewer with LowestCost. At a local optimum a random walk is
+	   split in two and the search goes on, the best suite is kept.
+
+	   lowerBound() holds for any suite: every walk visits the first nodes
+	   of the requirements it tours in some order, so the components of
+	   those nodes it tours form a chain under reachability, and at least as
+	   many walks are needed as the largest antichain has components
+	   (Dilworth, by a maximum matching over the transitive closure). The
+	   search stops once the number of walks reaches it.
+	*/
+	class SuiteOptimizer
+	{
+		public:
+			SuiteOptimizer(const GraphSnapshot &snapshot, const QList<QVector<int> > &requirements,
+				       TouringMode touring, Objective objective = FewestPaths);
+
+			// test paths as node indexes, the requirements none of them tours are left out
+			void setSuite(const QList<QVector<int> > &walks);
+
+			// milliseconds
+			void optimize(int timeLimit);
+
+			// stops the optimization early once set, not owned
+			void setCancelFlag(const QAtomicInt *cancel) { m_cancel = cancel; }
+
+			/* The bound alone, for requirements without a suite: those which
+			   start reachable from a start node and end reaching an end node
+			   count. */
+			int estimateLowerBound(int timeLimit);
+
+			const QList<QVector<int> > &suite() const { return m_best; }
+			int lowerBound() const { return m_lowerBound; }
+			bool isOptimal() const { return m_best.size() == m_lowerBound; }
+
+			// moves taken, the splits included
+			int moveCount() const { return m_moves; }
+
+			// the reachability bound keeps a bit per component of the antichain for every component
+			static const qint64 MaxBoundBytes = 64 * 1024 * 1024;
+
+			// cached shortest path trees, in bytes of their vectors
+			static const qint64 MaxTreeBytes = 64 * 1024 * 1024;
+
+			// walks whose requirements are moved away must not have more than this
+			static const int MoveLimit = 4;
+
+		private:
+			typedef struct
+			{
+				QVector<double> distance;
+
+				// next node towards the root, -1 at the root
+				QVector<int> parent;
+			} Tree;
+
+			const GraphSnapshot &m_snapshot;
+			QList<QVector<int> > m_requirements;
+			RequirementTouring m_touring;
+			Objective m_objective;
+
+			QList<QVector<int> > m_walks;
+			QList<QVector<int> > m_tours;
+			QList<double> m_lengths;
+			QVector<int> m_multiplicity;
+			QVector<bool> m_required;
+			QVector<bool> m_mark;
+			double m_totalLength;
+
+			QList<QVector<int> > m_best;
+			int m_bestCount;
+			double m_bestLength;
+			int m_lowerBound;
+			int m_moves;
+
+			QHash<int, Tree> m_forwardTrees;
+			QHash<int, Tree> m_reverseTrees;
+
+			QTime m_timer;
+			int m_timeLimit;
+			const QAtomicInt *m_cancel;
+
+			bool isOutOfTime() const
+			{ return m_timer.elapsed() > m_timeLimit || (m_cancel != 0 && *m_cancel != 0); }
+			bool isBetter(int count, double length, int thanCount, double thanLength) const;
+
+			double stepLength(int from, int to) const;
+			double walkLength(const QVector<int> &walk) const;
+
+			// root -1 is every start node, or every end node for a reverse tree
+			const Tree &tree(int root, bool reverse);
+			void limitTrees();
+
+			bool connect(int from, int to, QVector<int> &walk);
+			bool connectFromStart(int to, QVector<int> &walk);
+			bool connectToEnd(int from, QVector<int> &walk);
+
+			bool tours(const QVector<int> &walk, const QVector<int> &requirements);
+			int shortestPrefix(const QVector<int> &walk, const QVector<int> &requirements);
+			int shortestSuffix(const QVector<int> &walk, const QVector<int> &requirements);
+			bool trimmed(const QVector<int> &walk, const QVector<int> &requirements, QVector<int> &result);
+
+			// required requirements only the given walks tour
+			QVector<int> neededBy(const QList<int> &walks) const;
+
+			bool replace(const QList<int> &replaced, const QList<QVector<int> > &added, bool force = false);
+			void keepBest();
+
+			bool dropRedundant();
+			bool mergeWalks();
+			bool moveRequirements();
+			bool trimWalks();
+			bool rerouteWalks();
+			bool splitWalk();
+
+			void computeLowerBound();
+			int maximumMatching(const QVector<quint64> &closure, int count, int words);
+	};
+}
+
+#endif // SUITEOPTIMIZER_H
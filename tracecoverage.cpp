@@ -0,0 +1,378 @@
+#include "tracecoverage.h"
+
+#include <QFile>
+#include <QHash>
+#include <QFuture>
+#include <QtConcurrentRun>
+
+#include <string.h>
+
+using namespace Algorithm;
+
+static inline bool isSeparator(char c)
+{
+	return c == ' ' || c == '\t' || c == ',' || c == ';' || c == '\r' || c == '\n';
+}
+
+TraceCoverage::TraceCoverage(const QList<Node*> &nodes, const QList<Path*> &requirements, TouringMode touring)
+	: m_labelMask(0), m_symbolCount(0), m_touring(touring), m_coveredValid(false),
+	  m_eventCount(0), m_unknownCount(0), m_traceCount(0)
+{
+	build(nodes, requirements);
+}
+
+quint32 TraceCoverage::hashLabel(const char *data, int length)
+{
+	// FNV-1a
+	quint32 hash = 2166136261u;
+
+	for(int i = 0; i < length; ++i)
+	{
+		hash ^= (quint8)data[i];
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+int TraceCoverage::findLabel(const char *data, int length, quint32 hash) const
+{
+	quint32 slot = hash & m_labelMask;
+
+	while(m_labelSymbols[slot] != -1)
+	{
+		if(m_labelHashes[slot] == hash && m_labelLengths[slot] == length &&
+		   memcmp(m_labelBytes.constData() + m_labelOffsets[slot], data, length) == 0)
+			return m_labelSymbols[slot];
+
+		slot = (slot + 1) & m_labelMask;
+	}
+
+	return -1;
+}
+
+int TraceCoverage::addLabel(const QByteArray &label)
+{
+	quint32 hash = hashLabel(label.constData(), label.size());
+	int symbol = findLabel(label.constData(), label.size(), hash);
+
+	if(symbol != -1)
+		return symbol;
+
+	quint32 slot = hash & m_labelMask;
+
+	while(m_labelSymbols[slot] != -1)
+		slot = (slot + 1) & m_labelMask;
+
+	m_labelHashes[slot] = hash;
+	m_labelSymbols[slot] = m_symbolCount;
+	m_labelOffsets[slot] = m_labelBytes.size();
+	m_labelLengths[slot] = label.size();
+	m_labelBytes.append(label);
+
+	return m_symbolCount++;
+}
+
+void TraceCoverage::build(const QList<Node*> &nodes, const QList<Path*> &requirements)
+{
+	QHash<Node*, int> nodeSymbols;
+	int nodeCount = nodes.size();
+
+	foreach(Path *path, requirements)
+		nodeCount += path->nodeCount();
+
+	// tables are kept at most half full
+	quint32 labelCapacity = 16;
+
+	while(labelCapacity < (quint32)nodeCount * 2)
+		labelCapacity <<= 1;
+
+	m_labelHashes.fill(0, labelCapacity);
+	m_labelSymbols.fill(-1, labelCapacity);
+	m_labelOffsets.fill(0, labelCapacity);
+	m_labelLengths.fill(0, labelCapacity);
+	m_labelMask = labelCapacity - 1;
+
+	// a node on no requirement is still a known event
+	foreach(Node *node, nodes)
+		nodeSymbols.insert(node, addLabel(node->label().toUtf8()));
+
+	QList<QVector<int> > sequences;
+
+	foreach(Path *path, requirements)
+	{
+		QVector<int> sequence;
+
+		foreach(Node *node, path->nodes())
+		{
+			if(!nodeSymbols.contains(node))
+				nodeSymbols.insert(node, addLabel(node->label().toUtf8()));
+
+			sequence.append(nodeSymbols.value(node));
+		}
+
+		sequences.append(sequence);
+	}
+
+	m_automaton.build(sequences, m_symbolCount);
+	m_visitedStates.fill(0, m_automaton.stateCount());
+
+	if(m_touring != DirectTouring)
+	{
+		m_matcher.build(sequences, m_touring);
+		m_toured.fill(0, sequences.size());
+	}
+}
+
+void TraceCoverage::initResult(TraceResult &result) const
+{
+	result.visitedStates.fill(0, m_automaton.stateCount());
+
+	if(m_touring != DirectTouring)
+		m_matcher.initProgress(result.progress);
+
+	result.eventCount = 0;
+	result.unknownCount = 0;
+	result.traceCount = 0;
+}
+
+const char *TraceCoverage::scan(const char *data, const char *end, int &state, TraceResult &result) const
+{
+	quint8 *visited = result.visitedStates.data();
+	qint64 eventCount = 0;
+	qint64 unknownCount = 0;
+	qint64 traceCount = 0;
+
+	/* Only whole labels are consumed, the caller gets back
+	   where the unfinished one starts. */
+	const char *p = data;
+
+	while(p < end)
+	{
+		char c = *p;
+
+		if(isSeparator(c))
+		{
+			if(c == '\n')
+			{
+				if(state != -1)
+					traceCount++;
+
+				state = -1;
+			}
+
+			++p;
+			continue;
+		}
+
+		const char *token = p;
+		quint32 hash = 2166136261u;
+
+		while(p < end && !isSeparator(*p))
+		{
+			hash ^= (quint8)*p;
+			hash *= 16777619u;
+			++p;
+		}
+
+		if(p == end)
+		{
+			p = token;
+			break;
+		}
+
+		// -1 marks a trace which hasn't started yet
+		if(state == -1)
+		{
+			state = 0;
+
+			if(m_touring != DirectTouring)
+				m_matcher.beginWalk(result.progress);
+		}
+
+		int symbol = findLabel(token, p - token, hash);
+
+		eventCount++;
+
+		if(symbol == -1)
+		{
+			unknownCount++;
+			state = 0;
+
+			if(m_touring != DirectTouring)
+				m_matcher.breakWalk(result.progress);
+
+			continue;
+		}
+
+		if(m_touring != DirectTouring)
+		{
+			m_matcher.step(result.progress, symbol);
+			continue;
+		}
+
+		state = m_automaton.step(state, symbol);
+		visited[state] = 1;
+	}
+
+	result.eventCount += eventCount;
+	result.unknownCount += unknownCount;
+	result.traceCount += traceCount;
+
+	return p;
+}
+
+TraceCoverage::TraceResult TraceCoverage::analyzeFile(const QString &filename) const
+{
+	TraceResult result;
+	initResult(result);
+
+	QFile file(filename);
+
+	if(!file.open(QIODevice::ReadOnly))
+	{
+		result.errorString = QString("%1: %2").arg(filename).arg(file.errorString());
+		return result;
+	}
+
+	qint64 size = file.size();
+	const char *data = size > 0 ? (const char*)file.map(0, size) : 0;
+
+	if(data == 0)
+		return analyzeDevice(&file);
+
+	int state = -1;
+	const char *rest = scan(data, data + size, state, result);
+
+	// the last label has no separator after it
+	if(rest != data + size)
+	{
+		QByteArray last(rest, data + size - rest);
+		last.append('\n');
+		scan(last.constData(), last.constData() + last.size(), state, result);
+	}
+	else if(state != -1)
+	{
+		result.traceCount++;
+	}
+
+	return result;
+}
+
+TraceCoverage::TraceResult TraceCoverage::analyzeDevice(QIODevice *device) const
+{
+	TraceResult result;
+	initResult(result);
+
+	QByteArray buffer(BlockSize, 0);
+	int pending = 0;
+	int state = -1;
+
+	forever
+	{
+		qint64 read = device->read(buffer.data() + pending, buffer.size() - pending);
+
+		if(read < 0)
+		{
+			result.errorString = device->errorString();
+			return result;
+		}
+
+		if(read == 0)
+			break;
+
+		const char *begin = buffer.constData();
+		const char *end = begin + pending + read;
+		const char *rest = scan(begin, end, state, result);
+
+		pending = end - rest;
+
+		// a single label longer than the buffer
+		if(pending == buffer.size())
+			buffer.resize(buffer.size() * 2);
+
+		memmove(buffer.data(), rest, pending);
+	}
+
+	buffer.resize(pending);
+	buffer.append('\n');
+	scan(buffer.constData(), buffer.constData() + buffer.size(), state, result);
+
+	return result;
+}
+
+void TraceCoverage::addResult(const TraceResult &result)
+{
+	const quint8 *visited = result.visitedStates.constData();
+	quint8 *merged = m_visitedStates.data();
+
+	for(int i = 0; i < m_visitedStates.size(); ++i)
+		merged[i] |= visited[i];
+
+	for(int i = 0; i < m_toured.size() && i < result.progress.toured.size(); ++i)
+		m_toured[i] |= result.progress.toured.at(i);
+
+	m_eventCount += result.eventCount;
+	m_unknownCount += result.unknownCount;
+	m_traceCount += result.traceCount;
+
+	if(!result.errorString.isEmpty())
+		m_errorString = result.errorString;
+
+	m_coveredValid = false;
+}
+
+bool TraceCoverage::analyzeFiles(const QStringList &filenames)
+{
+	QList<QFuture<TraceResult> > futures;
+
+	foreach(const QString &filename, filenames)
+		futures.append(QtConcurrent::run(this, &TraceCoverage::analyzeFile, filename));
+
+	bool ok = true;
+
+	for(int i = 0; i < futures.size(); ++i)
+	{
+		TraceResult result = futures[i].result();
+
+		if(!result.errorString.isEmpty())
+			ok = false;
+
+		addResult(result);
+	}
+
+	return ok;
+}
+
+void TraceCoverage::updateCoveredStates() const
+{
+	if(m_coveredValid)
+		return;
+
+	// a visited state also tours everything on its failure chain
+	m_coveredStates = m_visitedStates;
+	m_automaton.propagateVisited(m_coveredStates);
+
+	m_coveredValid = true;
+}
+
+bool TraceCoverage::isCovered(int index) const
+{
+	if(m_touring != DirectTouring)
+		return m_toured.at(index) != 0;
+
+	updateCoveredStates();
+
+	return m_coveredStates[m_automaton.terminalState(index)] != 0;
+}
+
+int TraceCoverage::coveredCount() const
+{
+	int count = 0;
+
+	for(int i = 0; i < requirementCount(); ++i)
+		if(isCovered(i))
+			count++;
+
+	return count;
+}
@@ -0,0 +1,98 @@
+#ifndef TRACECOVERAGE_H
+#define TRACECOVERAGE_H
+
+#include <QList>
+#include <QVector>
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QIODevice>
+
+#include "algorithmnode.h"
+#include "algorithmpath.h"
+#include "requirementautomaton.h"
+#include "subsequenceautomaton.h"
+
+namespace Algorithm
+{
+	/* Measures which requirements are toured by execution traces.
+
+	   A trace is a sequence of node labels separated by whitespace, commas
+	   or semicolons, one trace per line. The labels of all graph nodes are
+	   looked up in a hash table, only those matching no node are unknown,
+	   nodes sharing a label are indistinguishable in a trace. All
+	   requirements are matched at once by a RequirementAutomaton over
+	   their label sequences, or by a SubsequenceMatcher when a trace may
+	   tour them with sidetrips or detours.
+	*/
+	class TraceCoverage
+	{
+		public:
+			typedef struct
+			{
+				QVector<quint8> visitedStates;
+				qint64 eventCount;
+				qint64 unknownCount;
+				qint64 traceCount;
+				QString errorString;
+
+				// not the direct touring
+				SubsequenceMatcher::Progress progress;
+			} TraceResult;
+
+			TraceCoverage(const QList<Node*> &nodes, const QList<Path*> &requirements, TouringMode touring = DirectTouring);
+
+			TraceResult analyzeFile(const QString &filename) const;
+			TraceResult analyzeDevice(QIODevice *device) const;
+
+			void addResult(const TraceResult &result);
+			bool analyzeFiles(const QStringList &filenames);
+
+			int requirementCount() const { return m_automaton.sequenceCount(); }
+			int coveredCount() const;
+			bool isCovered(int index) const;
+
+			qint64 eventCount() const { return m_eventCount; }
+			qint64 unknownCount() const { return m_unknownCount; }
+			qint64 traceCount() const { return m_traceCount; }
+			const QString &errorString() const { return m_errorString; }
+
+		private:
+			// labels, open addressing
+			QVector<quint32> m_labelHashes;
+			QVector<int> m_labelSymbols;
+			QVector<int> m_labelOffsets;
+			QVector<int> m_labelLengths;
+			QByteArray m_labelBytes;
+			quint32 m_labelMask;
+			int m_symbolCount;
+
+			RequirementAutomaton m_automaton;
+
+			TouringMode m_touring;
+			SubsequenceMatcher m_matcher;
+			QVector<quint8> m_toured;
+
+			QVector<quint8> m_visitedStates;
+			mutable QVector<quint8> m_coveredStates;
+			mutable bool m_coveredValid;
+
+			qint64 m_eventCount;
+			qint64 m_unknownCount;
+			qint64 m_traceCount;
+			QString m_errorString;
+
+			static const int BlockSize = 1 << 20;
+
+			static quint32 hashLabel(const char *data, int length);
+			int addLabel(const QByteArray &label);
+			int findLabel(const char *data, int length, quint32 hash) const;
+
+			void build(const QList<Node*> &nodes, const QList<Path*> &requirements);
+			const char *scan(const char *data, const char *end, int &state, TraceResult &result) const;
+			void initResult(TraceResult &result) const;
+			void updateCoveredStates() const;
+	};
+}
+
+#endif // TRACECOVERAGE_H